@@ -30,10 +30,26 @@ Ideas:
 #include <fstream>
 #include <string>
 #include <cmath>
+#include <limits>
 #include <vector>
+#include <thread>
+#include <atomic>
+#include <sstream>
 #include <algorithm> // Remove when calcState is finished
 #include "calcState.h"
 #include "drawGrid.h"
+#include "lifeEngine.h"
+#include "benchmark.h"
+#include "headless.h"
+#include "ensemble.h"
+#include "life3D.h"
+#include "speciesEngine.h"
+#include "stochasticEngine.h"
+#include "patternIO.h"
+#include "cycleDetect.h"
+#include "lifeRule.h"
+#include "metrics.h"
+#include "renderPipeline.h"
 
 
 // Global constants
@@ -68,12 +84,12 @@ private:
 // Functions
 bool checkInt(std::string input);
 bool checkValid(int x, int y);
-bool checkDead(std::vector<int> X, std::vector<int> Y); // Function to check if all cells are dead. Just input the vectors and see if they are empty.
-bool stableConfig(std::vector<int> X, std::vector<int> Y, std::vector<int> oldX, std::vector<int> oldY);
+bool checkDead(const std::vector<int>& X, const std::vector<int>& Y); // Function to check if all cells are dead. Just input the vectors and see if they are empty.
 void test(int input, bool check); // Used for testing
+void waitForEnter(); // Portable replacement for system("pause"), which starts a shell on every call
 
 
-int main(void)
+int main(int argc, char* argv[])
 {
     //int in = 3;
     //bool in2 = 1;
@@ -81,11 +97,36 @@ int main(void)
     //system("pause");
 
     int index = 0, dup = 0, timeStep = 1;
+    runOptions options;
+
+    if (!parseOptions(argc, argv, options))
+        return(1);
+    if (options.scaling) {
+        int maxThreads = std::max<int>(options.threads, std::thread::hardware_concurrency());
+        scalingBenchmark(options.engine, maxThreads, 2048, 20);
+        return(0);
+    }
+    if (options.benchmark)
+        return runBenchmarks(options.benchmarkFilter, options.benchmarkOut, options.minTime);
+    if (!options.compareBase.empty())
+        return compareBenchmarks(options.compareBase, options.compareNew, options.threshold);
+    if (options.threeD)
+        return run3D(options);
+    if (!options.species.empty())
+        return runSpecies(options);
+    if (!options.stochastic.empty())
+        return runStochastic(options);
+    if (options.ensemble > 0)
+        return runEnsemble(options);
+    if (options.headless)
+        return runHeadless(options);
+
     static int x, y;
     bool check = true, waitInput = true, time = true;
-    char start;
-    std::vector<int> X, Y, oldX, oldY;
-    std::string input;
+    char start, engineType;
+    std::vector<int> X, Y;
+    std::string input, ruleText = options.rule;
+    lifeRule rule = LIFE;
     class cellType type;
 
     std::cout << "\n\n ~~~~~~~~~~~~~~~ John Conway's 'Game of Life' ~~~~~~~~~~~~~~~\n\n";
@@ -119,7 +160,7 @@ Input:
                 std::cin.clear();
                 std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
                 std::cout << "ERROR: Enter valid input." << std::endl;
-                system("pause");
+                waitForEnter();
             }
             else
             {
@@ -142,7 +183,7 @@ Input:
                     std::cin.clear();
                     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
                     std::cout << "ERROR: Coordinate already used, please input new unique value." << std::endl;
-                    system("pause");
+                    waitForEnter();
                 }
             }
 
@@ -152,7 +193,22 @@ Input:
     }
     else if (input == "f")
     {
-        std::cout << 2;
+        std::string file, fileRule;
+
+        std::cout << "Input the pattern file name (.rle, .cells, or a list of x y pairs):" << std::endl;
+        std::cin >> file;
+
+        if (!loadPattern(file, X, Y, fileRule))
+        {
+            std::cout << "\nERROR: Could not read the pattern file '" << file << "'.\n\n";
+            X.clear();
+            Y.clear();
+
+            goto Input;
+        }
+        std::cout << "Loaded " << X.size() << " live cells." << std::endl;
+        if (ruleText.empty())
+            ruleText = fileRule;
     }
     else
     {
@@ -176,42 +232,159 @@ Input:
                 std::cin.clear();
                 std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
                 std::cout << "ERROR: Please give valid input (y/n)." << std::endl;
-                system("pause");
+                waitForEnter();
             }
         }
     }
 
-    // Run game
+    // The rule comes from --rule, else the pattern file, else Life
+    if (!ruleText.empty() && !parseRule(ruleText, rule))
+    {
+        std::cout << "ERROR: Unknown rule '" << ruleText << "', running Life (B3/S23) instead." << std::endl;
+        rule = LIFE;
+    }
+
+    // Choose how the generations are computed. A bounded universe always uses the bitmap engine.
+    std::unique_ptr<lifeEngine> engine;
+    if (options.topo != TOPOLOGY_PLANE)
+    {
+        engine = makeEngine(options);
+        if (!engine->setRule(rule))
+        {
+            std::cout << "ERROR: A bounded universe cannot run " << rule.name() << ", running Life (B3/S23) instead." << std::endl;
+            rule = LIFE;
+            engine->setRule(rule);
+        }
+    }
+    while (!engine)
+    {
+        std::cout << "\nSelect the engine: (s) sparse hash set, best for scattered cells, (t) bit-packed tiles, best for dense regions, (h) HashLife, best for long runs of repetitive patterns, or (m) sorted Morton store, the most compact.\n";
+        if (std::cin >> engineType)
+            engine = makeEngine(engineType);
+
+        if (engine && !engine->setRule(rule)) {
+            std::cout << "ERROR: This engine cannot run " << rule.name() << ", please choose the sparse engine." << std::endl;
+            engine.reset();
+            continue;
+        }
+        if (!engine) {
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            std::cout << "ERROR: Please give valid input (s/t/h/m)." << std::endl;
+        }
+    }
+    engine->setThreads(options.threads);
+    engine->load(X, Y);
+
+    // Watches for a repeat of any of the recent generations, in place or shifted
+    cycleDetector cycles;
+    cycles.update(X, Y);
+
+    // Frames of the running game are drawn in place, rewriting only the cells that changed
+    frameRenderer screen(GRIDSIZE, true);
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+    // Per-generation metrics and trace, if asked for on the command line
+    metricsLog metrics;
+    if (!options.metricsFile.empty() && !metrics.open(options.metricsFile))
+        std::cout << "ERROR: Could not write " << options.metricsFile << ", continuing without metrics." << std::endl;
+    if (!options.traceFile.empty())
+        startTrace();
+    clearMetrics();
+
+    // Why the game ends after the given time step, or an empty string while it goes on. With --fps the
+    // game runs on its own up to --generations instead of MAXTIME.
+    uint64_t lastStep = options.fps > 0 ? options.generations : MAXTIME;
+    gameOverCheck gameOver = [&](const std::vector<int>& X, const std::vector<int>& Y, uint64_t timeStep) -> std::string {
+        std::ostringstream why;
+        int64_t originX, originY;
+        engine->origin(originX, originY);
+        if (timeStep == lastStep)
+            why << "The maximum number of timesteps has been reached: " << lastStep << " time steps\n";
+        if (checkDead(X, Y))
+            why << "All cells have died at time step " << timeStep << ".\n";
+        else if (cycles.update(X, Y, originX, originY)) {
+            if (cycles.dx() || cycles.dy())
+                why << "The cell configuration repeats every " << cycles.period() << " time steps, moved by (" << cycles.dx() << ", " << cycles.dy() << ").";
+            else if (cycles.period() == 1)
+                why << "The cell configuration has repeated.";
+            else
+                why << "The cell configuration repeats every " << cycles.period() << " time steps.";
+            why << " Since nothing new will occur, we stop the continuation of the game.\n";
+        }
+        return why.str();
+    };
+
+    // Run game, stepping and drawing on separate threads
+    if (options.fps > 0)
+    {
+        std::cout << "Running at up to " << options.fps << " frames per second, press Enter to stop." << std::endl;
+        std::atomic<bool> stop(false);
+        std::thread input([&]() {
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            stop = true;
+        });
+
+        pipelineStats stats = runPipeline(*engine, screen, options.fps, gameOver, stop, metrics.isOpen() ? &metrics : nullptr);
+        if (stats.reason.empty())
+            std::cout << "Stopped at time step " << stats.generations << ".\n";
+        else
+            std::cout << stats.reason;
+        std::cout << stats.generations << " time steps, " << stats.frames << " frames drawn, "
+            << stats.skippedByRenderer + stats.skippedBySimulation << " generations not shown.\n";
+
+        if (!stop)
+            std::cout << "Press Enter to continue . . ." << std::flush;
+        input.join();
+        time = false;
+    }
+
+    // Run game one step per Enter
     while (time)
     {
-        calcState(X, Y);
-        drawGrid(X, Y, GRIDSIZE);
-        system("pause");
-        
-        if (timeStep == MAXTIME) {
-            std::cout << "The maximum number of timesteps has been reached: " << MAXTIME << " time steps\n";
-            time = false;
+        {
+            METRIC_PHASE(PHASE_STEP);
+            engine->step();
         }
-        if (checkDead(X, Y)) {
-            std::cout << "All cells have died at time step " << timeStep << ".\n";
-            time = false;
+        engine->store(X, Y);
+        int64_t originX, originY;
+        engine->origin(originX, originY);
+        {
+            METRIC_PHASE(PHASE_RENDER);
+            if (const cellStore* live = engine->cells())
+                screen.draw(*live, originX, originY);
+            else
+                screen.draw(X, Y, originX, originY);
+        }
+        if (metrics.isOpen()) {
+            metrics.record(measureGeneration(timeStep, X, Y, originX, originY));
         }
-        if (stableConfig(X, Y, oldX, oldY)) {
-            std::cout << "The cell configuration has repeated. Since no more change will occur, we stop the continuation of the game.\n";
+        waitForEnter();
+
+        std::string over = gameOver(X, Y, timeStep);
+        if (!over.empty()) {
+            std::cout << over;
             time = false;
         }
 
-        oldX.clear();
-        oldY.clear();
-        oldX = X;
-        oldY = Y;
         timeStep++;
     }
 
+    metrics.close();
+    if (!options.traceFile.empty() && !writeTrace(options.traceFile))
+        std::cout << "ERROR: Could not write " << options.traceFile << std::endl;
+
     return(0);
 }
 
 
+void waitForEnter()
+{
+    std::cout << "Press Enter to continue . . ." << std::flush;
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+}
+
+
 bool checkInt(std::string str) {
     for (int i = 0; i < str.length(); i++)
         if (isdigit(str[i]) == false)
@@ -228,7 +401,7 @@ bool checkValid(int x, int y)
 }
 
 
-bool checkDead(std::vector<int> X, std::vector<int> Y)
+bool checkDead(const std::vector<int>& X, const std::vector<int>& Y)
 {
     if (X.size() == 0 || Y.size() == 0)
         return true;
@@ -236,27 +409,6 @@ bool checkDead(std::vector<int> X, std::vector<int> Y)
 }
 
 
-bool stableConfig(std::vector<int> X, std::vector<int> Y, std::vector<int> oldX, std::vector<int> oldY)
-{
-    bool check = true;
-    int n = 0;
-
-    if (X.size() == oldX.size())
-    {
-        while (check)
-        {
-            if (!(X[n] == oldX[n]) || !(Y[n] == oldY[n]))
-                return false;
-            if (n == X.size() - 1)
-                return true;
-            n++;
-        }
-    }
-    else
-        return false;
-}
-
-
 void test(int input, bool check)
 {
     if (!check)
@@ -0,0 +1,435 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   Timing harness for the stepping engines. The scaling benchmark runs the same random soup with an
+   increasing number of threads and reports the time per generation and the speedup over one thread.
+
+   The benchmark suite times calcState and drawGrid on a fixed set of workloads: the R-pentomino, acorn
+   and Gosper gun run for a few hundred generations, random soups of 10% and 35% density covering
+   10^3 to 10^7 cells, and a sparse field of spaceships. Every iteration starts again from the same
+   initial cells, so the work per iteration does not depend on how many iterations were run. Results
+   are written as JSON in the same layout as Google Benchmark ("benchmarks": name, iterations,
+   real_time, time_unit), and compareBenchmarks flags any benchmark that slowed down by more than a
+   threshold between two such files.
+
+   The 3D benchmarks step random cubes of 10^5 to 4 x 10^6 live cells under 4555 and 5766, and draw
+   the middle slice of the largest.
+
+   The species benchmarks step the same 35% soup of 10^6 cells on the tile engine and, with two and
+   four species, on the species engine, so the cost of carrying the species shows as a ratio.
+*/
+
+// Headers
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "benchmark.h"
+#include "lifeEngine.h"
+#include "calcState.h"
+#include "drawGrid.h"
+#include "patterns.h"
+#include "life3D.h"
+#include "speciesEngine.h"
+#include "stochasticEngine.h"
+#include "tileEngine.h"
+
+#ifdef _WIN32
+const char NULL_DEVICE[] = "NUL";
+#else
+const char NULL_DEVICE[] = "/dev/null";
+#endif
+
+const int BENCH_VIEW = 200; // Viewport size used when timing drawGrid
+
+
+void randomSoup(int width, int height, double density, unsigned seed, std::vector<int>& X, std::vector<int>& Y)
+{
+    std::mt19937 rng(seed);
+    std::bernoulli_distribution alive(density);
+
+    X.clear();
+    Y.clear();
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (alive(rng)) {
+                X.push_back(x - width / 2);
+                Y.push_back(y - height / 2);
+            }
+        }
+    }
+}
+
+
+void randomCube(int side, double density, unsigned seed, std::vector<int>& X, std::vector<int>& Y, std::vector<int>& Z)
+{
+    std::mt19937 rng(seed);
+    std::bernoulli_distribution alive(density);
+
+    X.clear();
+    Y.clear();
+    Z.clear();
+    for (int z = 0; z < side; z++) {
+        for (int y = 0; y < side; y++) {
+            for (int x = 0; x < side; x++) {
+                if (alive(rng)) {
+                    X.push_back(x - side / 2);
+                    Y.push_back(y - side / 2);
+                    Z.push_back(z - side / 2);
+                }
+            }
+        }
+    }
+}
+
+
+void scalingBenchmark(char engineType, int maxThreads, int size, int generations)
+{
+    std::vector<int> X, Y;
+    double base = 0;
+
+    randomSoup(size, size, 0.35, 1, X, Y);
+
+    std::cout << "Scaling benchmark: " << size << "x" << size << " soup, " << X.size() << " live cells, "
+        << generations << " generations\n";
+    std::cout << std::setw(8) << "threads" << std::setw(14) << "ms/gen" << std::setw(10) << "speedup" << "\n";
+
+    // Powers of two up to the maximum, and the maximum itself
+    std::vector<int> counts;
+    for (int threads = 1; threads < maxThreads; threads *= 2)
+        counts.push_back(threads);
+    counts.push_back(std::max(maxThreads, 1));
+
+    for (int threads : counts) {
+        std::unique_ptr<lifeEngine> engine = makeEngine(engineType);
+        if (!engine) {
+            std::cout << "ERROR: Unknown engine '" << engineType << "'.\n";
+            return;
+        }
+
+        engine->setThreads(threads);
+        engine->load(X, Y);
+        engine->step(); // Warm up the scratch buffers
+
+        auto start = std::chrono::steady_clock::now();
+        for (int g = 0; g < generations; g++)
+            engine->step();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / generations;
+
+        if (threads == 1)
+            base = ms;
+        std::cout << std::setw(8) << threads << std::setw(14) << std::fixed << std::setprecision(3) << ms
+            << std::setw(9) << std::setprecision(2) << base / ms << "x\n";
+    }
+}
+
+
+// A starting pattern and the number of generations each calcState iteration runs from it
+struct workload
+{
+    std::string name;
+    int generations;
+    std::function<void(std::vector<int>&, std::vector<int>&)> make;
+};
+
+struct benchResult
+{
+    std::string name;
+    size_t iterations;
+    double ms;          // Mean wall time per iteration
+    size_t cells;       // Live cells at the start of an iteration
+    int generations;
+};
+
+
+static std::vector<workload> standardWorkloads()
+{
+    std::vector<workload> list;
+
+    for (const char* name : { "rpentomino", "acorn", "gosper" }) {
+        std::string pattern = name;
+        list.push_back({ pattern, 200, [pattern](std::vector<int>& X, std::vector<int>& Y) {
+            X.clear();
+            Y.clear();
+            namedPattern(pattern, 0, 0, X, Y);
+        } });
+    }
+
+    for (int percent : { 10, 35 }) {
+        for (long long cells = 1000; cells <= 10000000; cells *= 10) {
+            int side = (int)(std::sqrt((double)cells) + 0.5);
+            list.push_back({ "soup" + std::to_string(percent) + "/" + std::to_string(cells), 1,
+                [side, percent](std::vector<int>& X, std::vector<int>& Y) { randomSoup(side, side, percent / 100.0, 1, X, Y); } });
+        }
+    }
+
+    list.push_back({ "spaceships", 20, [](std::vector<int>& X, std::vector<int>& Y) { spaceshipField(2000, 40, 1, X, Y); } });
+    return list;
+}
+
+
+// Runs 'body' until at least minTime seconds have been spent inside it, calling 'reset' untimed
+// before every iteration
+static benchResult timeIt(const std::string& name, double minTime, const std::function<void()>& reset, const std::function<void()>& body)
+{
+    benchResult result = { name, 0, 0, 0, 0 };
+    double total = 0;
+
+    while (total < minTime * 1000 || result.iterations == 0) {
+        reset();
+        auto start = std::chrono::steady_clock::now();
+        body();
+        total += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        result.iterations++;
+    }
+
+    result.ms = total / result.iterations;
+    return result;
+}
+
+
+int runBenchmarks(const std::string& filter, const std::string& outFile, double minTime)
+{
+    std::vector<benchResult> results;
+    std::vector<int> startX, startY, X, Y;
+    FILE* sink = fopen(NULL_DEVICE, "wb");
+    frameRenderer renderer(BENCH_VIEW, false, sink ? sink : stdout);
+
+    std::cout << std::left << std::setw(34) << "benchmark" << std::right << std::setw(12) << "iterations"
+        << std::setw(14) << "ms/iter" << std::setw(12) << "cells" << "\n";
+
+    // Prints a row of the table and keeps the result for the JSON file
+    auto report = [&](const benchResult& r) {
+        std::cout << std::left << std::setw(34) << r.name << std::right << std::setw(12) << r.iterations
+            << std::setw(14) << std::fixed << std::setprecision(4) << r.ms << std::setw(12) << r.cells << "\n";
+        results.push_back(r);
+    };
+
+    for (const workload& w : standardWorkloads()) {
+        std::string stepName = "calcState/" + w.name, drawName = "drawGrid/" + w.name;
+        bool doStep = stepName.find(filter) != std::string::npos;
+        bool doDraw = drawName.find(filter) != std::string::npos;
+        if (!doStep && !doDraw)
+            continue;
+
+        w.make(startX, startY);
+
+        std::vector<benchResult> found;
+        if (doStep) {
+            found.push_back(timeIt(stepName, minTime, [&] { X = startX; Y = startY; }, [&] {
+                for (int g = 0; g < w.generations; g++)
+                    calcState(X, Y);
+            }));
+            found.back().generations = w.generations;
+        }
+        if (doDraw) {
+            found.push_back(timeIt(drawName, minTime, [] {}, [&] { renderer.draw(startX, startY); }));
+            found.back().generations = 0;
+        }
+
+        for (benchResult& r : found) {
+            r.cells = startX.size();
+            report(r);
+        }
+    }
+
+    // 3D: cubes at 25% density, so 'cells' live cells need a side of the cube root of 4 x cells
+    std::vector<int> startZ, Z;
+    for (const char* ruleText : { "4555", "5766" }) {
+        lifeRule3D rule;
+        parseRule3D(ruleText, rule);
+        for (long long cells : { 100000LL, 1000000LL, 4000000LL }) {
+            std::string name = std::string("life3D/") + ruleText + "/" + std::to_string(cells);
+            if (name.find(filter) == std::string::npos)
+                continue;
+
+            int side = (int)(std::cbrt(4.0 * cells) + 0.5);
+            randomCube(side, 0.25, 1, startX, startY, startZ);
+            life3D world;
+            world.setRule(rule);
+            benchResult r = timeIt(name, minTime, [&] { world.load(startX, startY, startZ); }, [&] { world.run(4); });
+            r.generations = 4;
+            r.cells = startX.size();
+            report(r);
+        }
+    }
+    if (std::string("drawSlice/4000000").find(filter) != std::string::npos) {
+        randomCube((int)(std::cbrt(4.0 * 4000000) + 0.5), 0.25, 1, startX, startY, startZ);
+        life3D world;
+        world.load(startX, startY, startZ);
+        benchResult r = timeIt("drawSlice/4000000", minTime, [] {}, [&] { drawSlice(world, 0, renderer); });
+        r.cells = startX.size();
+        report(r);
+    }
+
+    // Species: a square 35% soup of 10^6 live cells, on the tile engine and with 2 and 4 species
+    std::vector<int> startS;
+    for (int species : { 1, 2, 4 }) {
+        std::string name = species == 1 ? "species/tile/1000000" : "species/" + std::to_string(species) + "/1000000";
+        if (name.find(filter) == std::string::npos)
+            continue;
+
+        int side = (int)(std::sqrt(1000000 / 0.35) + 0.5);
+        randomSpeciesSoup(side, side, 0.35, std::max(species, 2), 1, startX, startY, startS);
+        std::unique_ptr<lifeEngine> engine = makeEngine('t');
+        speciesEngine world;
+        world.setSpecies(std::max(species, 2));
+        benchResult r = timeIt(name, minTime, [&] {
+            if (species == 1)
+                engine->load(startX, startY);
+            else
+                world.loadSpecies(startX, startY, startS);
+        }, [&] {
+            for (int g = 0; g < 4; g++)
+                species == 1 ? engine->step() : world.step();
+        });
+        r.generations = 4;
+        r.cells = startX.size();
+        report(r);
+    }
+
+    // Stochastic: a 35% soup filling a 1024x1024 torus, on the bounded engine, under Life on the
+    // stochastic engine with its observables, and at temperature 0.3 where every cell draws
+    for (std::string kind : { "bounded", "life", "thermal" }) {
+        std::string name = "stochastic/" + kind + "/1048576";
+        if (name.find(filter) == std::string::npos)
+            continue;
+
+        randomSoup(1024, 1024, 0.35, 1, startX, startY);
+        boundedEngine plain(TOPOLOGY_TORUS, 1024, 1024);
+        stochasticEngine noisy(TOPOLOGY_TORUS, 1024, 1024);
+        noisy.setStochastic(thermalRule(stochasticFrom(LIFE), kind == "thermal" ? 0.3 : 0), 1);
+        lifeEngine& engine = kind == "bounded" ? (lifeEngine&)plain : (lifeEngine&)noisy;
+        benchResult r = timeIt(name, minTime, [&] { engine.load(startX, startY); }, [&] { engine.run(4); });
+        r.generations = 4;
+        r.cells = 1024 * 1024;
+        report(r);
+    }
+
+    // Region queries after each step of a 35% soup of 10^6 live cells on the tile engine: a count, a
+    // viewport and a nearest cell from the tile engine's index, and from a scan over every cell
+    for (std::string kind : { "indexed", "scan" }) {
+        std::string name = "region/" + kind + "/1000000";
+        if (name.find(filter) == std::string::npos)
+            continue;
+
+        int side = (int)(std::sqrt(1000000 / 0.35) + 0.5);
+        randomSoup(side, side, 0.35, 1, startX, startY);
+        tileEngine engine;
+        std::vector<int> viewX, viewY;
+        size_t found = 0;
+        benchResult r = timeIt(name, minTime, [&] { engine.load(startX, startY); }, [&] {
+            engine.step();
+            cellRect block = { side / 4, side / 4, side / 4 + 255, side / 4 + 255 };
+            cellRect view = { side / 2, side / 2, side / 2 + 79, side / 2 + 39 };
+            int nearX, nearY;
+            if (kind == "indexed") {
+                found += engine.countIn(block) + engine.nearest(-100, -100, nearX, nearY);
+                engine.cellsIn(view, viewX, viewY);
+            }
+            else {
+                found += engine.lifeEngine::countIn(block) + engine.lifeEngine::nearest(-100, -100, nearX, nearY);
+                engine.lifeEngine::cellsIn(view, viewX, viewY);
+            }
+            found += viewX.size();
+        });
+        r.generations = 1;
+        r.cells = startX.size();
+        report(r);
+    }
+
+    if (sink)
+        fclose(sink);
+
+    if (!outFile.empty()) {
+        std::ofstream out(outFile);
+        if (!out) {
+            std::cout << "ERROR: Could not write " << outFile << "\n";
+            return 1;
+        }
+
+        char date[32];
+        time_t now = time(nullptr);
+        strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+        out << "{\n  \"context\": {\"date\": \"" << date << "\", \"library\": \"GameofLife2D\", \"min_time\": " << minTime << "},\n";
+        out << "  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            const benchResult& r = results[i];
+            out << "    {\"name\": \"" << r.name << "\", \"iterations\": " << r.iterations << ", \"real_time\": "
+                << std::setprecision(6) << r.ms << ", \"time_unit\": \"ms\", \"cells\": " << r.cells
+                << ", \"generations\": " << r.generations << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+    }
+    return 0;
+}
+
+
+// Reads the name and real_time of every benchmark in a results file written by runBenchmarks
+static bool readResults(const std::string& file, std::vector<std::pair<std::string, double>>& results)
+{
+    std::ifstream in(file);
+    if (!in)
+        return false;
+
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    std::string text = buffer.str();
+
+    const std::string nameKey = "\"name\": \"", timeKey = "\"real_time\": ";
+    for (size_t at = text.find(nameKey); at != std::string::npos; at = text.find(nameKey, at)) {
+        at += nameKey.size();
+        size_t close = text.find('"', at);
+        size_t time = text.find(timeKey, close);
+        if (close == std::string::npos || time == std::string::npos)
+            return false;
+
+        results.push_back(std::make_pair(text.substr(at, close - at), atof(text.c_str() + time + timeKey.size())));
+        at = time;
+    }
+    return true;
+}
+
+
+int compareBenchmarks(const std::string& baseFile, const std::string& newFile, double threshold)
+{
+    std::vector<std::pair<std::string, double>> base, current;
+    if (!readResults(baseFile, base) || !readResults(newFile, current)) {
+        std::cout << "ERROR: Could not read " << baseFile << " or " << newFile << "\n";
+        return 2;
+    }
+
+    int regressions = 0;
+    std::cout << std::left << std::setw(34) << "benchmark" << std::right << std::setw(14) << "base ms"
+        << std::setw(14) << "new ms" << std::setw(10) << "change" << "\n";
+
+    for (const auto& now : current) {
+        auto old = std::find_if(base.begin(), base.end(), [&](const std::pair<std::string, double>& b) { return b.first == now.first; });
+        if (old == base.end() || old->second <= 0)
+            continue;
+
+        double change = 100.0 * (now.second - old->second) / old->second;
+        bool slower = change > threshold;
+        regressions += slower;
+
+        std::cout << std::left << std::setw(34) << now.first << std::right << std::fixed << std::setprecision(4)
+            << std::setw(14) << old->second << std::setw(14) << now.second << std::setw(9) << std::setprecision(1)
+            << std::showpos << change << std::noshowpos << "%" << (slower ? "  REGRESSION" : "") << "\n";
+    }
+
+    std::cout << regressions << " regression" << (regressions == 1 ? "" : "s") << " over " << threshold << "%\n";
+    return regressions ? 1 : 0;
+}
@@ -0,0 +1,25 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+#include <vector>
+
+// Fills X/Y with a random soup of the given size and density, the same soup for the same seed
+void randomSoup(int width, int height, double density, unsigned seed, std::vector<int>& X, std::vector<int>& Y);
+
+// Fills X/Y/Z with a random side x side x side cube centred on the origin
+void randomCube(int side, double density, unsigned seed, std::vector<int>& X, std::vector<int>& Y, std::vector<int>& Z);
+
+// Times an engine on a dense soup with 1, 2, 4, ... up to maxThreads threads and prints the speedup
+void scalingBenchmark(char engineType, int maxThreads, int size, int generations);
+
+// Runs every benchmark whose name contains 'filter' (calcState and drawGrid over the standard
+// workloads, the 3D engine and its slice renderer, the species, stochastic and region query
+// benchmarks), printing a table and, if outFile is not empty, writing the results as JSON
+int runBenchmarks(const std::string& filter, const std::string& outFile, double minTime);
+
+// Compares two JSON result files and lists every benchmark that got slower by more than 'threshold'
+// percent. Returns 1 if there was any such regression, 0 otherwise.
+int compareBenchmarks(const std::string& baseFile, const std::string& newFile, double threshold);
+
+#endif
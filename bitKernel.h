@@ -0,0 +1,195 @@
+#ifndef BIT_KERNEL_H
+#define BIT_KERNEL_H
+
+#include <cstdint>
+#include "lifeRule.h"
+
+// Bit-sliced Life kernel shared by the engines that store cells as packed 64-bit rows. The vector
+// path is chosen at compile time: AVX2 (-mavx2 or /arch:AVX2) works on four words per instruction,
+// SSE2 on two, and plain 64-bit words are used elsewhere.
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BIT_KERNEL_SSE2
+#endif
+
+
+// Bitwise operations over one or more 64-bit rows
+struct scalarOps
+{
+    typedef uint64_t V;
+    static const int lanes = 1;
+    static V load(const uint64_t* p) { return *p; }
+    static void store(uint64_t* p, V v) { *p = v; }
+    static V andV(V a, V b) { return a & b; }
+    static V orV(V a, V b) { return a | b; }
+    static V xorV(V a, V b) { return a ^ b; }
+    static V andNot(V a, V b) { return ~a & b; }
+    static V shiftLeft(V a, int n) { return a << n; }
+    static V shiftRight(V a, int n) { return a >> n; }
+    static V zero() { return 0; }
+    static V ones() { return ~0ull; }
+};
+
+#if defined(__AVX2__)
+struct simdOps
+{
+    typedef __m256i V;
+    static const int lanes = 4;
+    static V load(const uint64_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+    static void store(uint64_t* p, V v) { _mm256_storeu_si256((__m256i*)p, v); }
+    static V andV(V a, V b) { return _mm256_and_si256(a, b); }
+    static V orV(V a, V b) { return _mm256_or_si256(a, b); }
+    static V xorV(V a, V b) { return _mm256_xor_si256(a, b); }
+    static V andNot(V a, V b) { return _mm256_andnot_si256(a, b); }
+    static V shiftLeft(V a, int n) { return _mm256_slli_epi64(a, n); }
+    static V shiftRight(V a, int n) { return _mm256_srli_epi64(a, n); }
+    static V zero() { return _mm256_setzero_si256(); }
+    static V ones() { return _mm256_set1_epi64x(-1); }
+};
+#elif defined(BIT_KERNEL_SSE2)
+struct simdOps
+{
+    typedef __m128i V;
+    static const int lanes = 2;
+    static V load(const uint64_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+    static void store(uint64_t* p, V v) { _mm_storeu_si128((__m128i*)p, v); }
+    static V andV(V a, V b) { return _mm_and_si128(a, b); }
+    static V orV(V a, V b) { return _mm_or_si128(a, b); }
+    static V xorV(V a, V b) { return _mm_xor_si128(a, b); }
+    static V andNot(V a, V b) { return _mm_andnot_si128(a, b); }
+    static V shiftLeft(V a, int n) { return _mm_slli_epi64(a, n); }
+    static V shiftRight(V a, int n) { return _mm_srli_epi64(a, n); }
+    static V zero() { return _mm_setzero_si128(); }
+    static V ones() { return _mm_set1_epi32(-1); }
+};
+#else
+typedef scalarOps simdOps;
+#endif
+
+
+// Template argument of the kernels for rules whose mask is only known at run time
+const uint32_t RUNTIME_MASK = 0xFFFFFFFF;
+
+
+// Cells whose neighbour count, given as the bits (bits[3] bits[2] bits[1] bits[0]), equals N
+template <class Op, int N>
+inline typename Op::V countIs(const typename Op::V* bits)
+{
+    typename Op::V set = Op::ones(), clear = Op::zero();
+    for (int k = 0; k < 4; k++) {
+        if (N >> k & 1)
+            set = Op::andV(set, bits[k]);
+        else
+            clear = Op::orV(clear, bits[k]);
+    }
+    return Op::andNot(clear, set);
+}
+
+
+// ORs in the next-generation term of every neighbour count up to N that the rule mentions
+template <class Op, int N>
+struct ruleTerms
+{
+    typedef typename Op::V V;
+
+    static V apply(uint32_t mask, V alive, const V* bits)
+    {
+        V next = ruleTerms<Op, N - 1>::apply(mask, alive, bits);
+        bool born = mask >> N & 1, stays = mask >> (N + 9) & 1;
+
+        if (born && stays)
+            return Op::orV(next, countIs<Op, N>(bits));
+        if (born)
+            return Op::orV(next, Op::andNot(alive, countIs<Op, N>(bits)));
+        if (stays)
+            return Op::orV(next, Op::andV(alive, countIs<Op, N>(bits)));
+        return next;
+    }
+};
+
+template <class Op>
+struct ruleTerms<Op, -1>
+{
+    static typename Op::V apply(uint32_t, typename Op::V, const typename Op::V*) { return Op::zero(); }
+};
+
+
+// Neighbour count of every cell as four bit planes, from the same eight neighbour words as nextCells
+template <class Op>
+inline void neighbourCount(typename Op::V a, typename Op::V b, typename Op::V c, typename Op::V d, typename Op::V e,
+    typename Op::V f, typename Op::V g, typename Op::V h, typename Op::V* bits)
+{
+    typedef typename Op::V V;
+
+    V ab = Op::xorV(a, b);
+    V s0 = Op::xorV(ab, c);
+    V c0 = Op::orV(Op::andV(a, b), Op::andV(c, ab));
+    V fg = Op::xorV(f, g);
+    V s1 = Op::xorV(fg, h);
+    V c1 = Op::orV(Op::andV(f, g), Op::andV(h, fg));
+    V s2 = Op::xorV(d, e);
+    V c2 = Op::andV(d, e);
+
+    V s01 = Op::xorV(s0, s1);
+    V c3 = Op::orV(Op::andV(s0, s1), Op::andV(s2, s01));
+    V c01 = Op::xorV(c0, c1);
+    V t = Op::xorV(c01, c2);
+    V c4 = Op::orV(Op::andV(c0, c1), Op::andV(c2, c01));
+    V c5 = Op::andV(t, c3);
+
+    bits[0] = Op::xorV(s01, s2);
+    bits[1] = Op::xorV(t, c3);
+    bits[2] = Op::xorV(c4, c5);
+    bits[3] = Op::andV(c4, c5);
+}
+
+
+// Next state of the cells in 'alive' given their eight neighbour words: a, b, c the row below (west,
+// centre, east), d and e the west and east neighbours in the row itself, and f, g, h the row above.
+// MASK is the rule mask, or RUNTIME_MASK to use 'mask' instead.
+template <class Op, uint32_t MASK>
+inline typename Op::V nextCells(typename Op::V a, typename Op::V b, typename Op::V c, typename Op::V d, typename Op::V e,
+    typename Op::V f, typename Op::V g, typename Op::V h, typename Op::V alive, uint32_t mask)
+{
+    typedef typename Op::V V;
+
+    if (MASK != RUNTIME_MASK)
+        mask = MASK;
+
+    // Full adders on (a,b,c) and (f,g,h), half adder on (d,e)
+    V ab = Op::xorV(a, b);
+    V s0 = Op::xorV(ab, c);
+    V c0 = Op::orV(Op::andV(a, b), Op::andV(c, ab));
+    V fg = Op::xorV(f, g);
+    V s1 = Op::xorV(fg, h);
+    V c1 = Op::orV(Op::andV(f, g), Op::andV(h, fg));
+    V s2 = Op::xorV(d, e);
+    V c2 = Op::andV(d, e);
+
+    // Ones bit of the count, and the carry into the twos
+    V s01 = Op::xorV(s0, s1);
+    V bit0 = Op::xorV(s01, s2);
+    V c3 = Op::orV(Op::andV(s0, s1), Op::andV(s2, s01));
+
+    // Twos bit from the four weight-two carries, and the carries into the fours
+    V c01 = Op::xorV(c0, c1);
+    V t = Op::xorV(c01, c2);
+    V c4 = Op::orV(Op::andV(c0, c1), Op::andV(c2, c01));
+    V bit1 = Op::xorV(t, c3);
+    V c5 = Op::andV(t, c3);
+
+    if (MASK == LIFE_MASK) {
+        // A count of 2 or 3 has the twos bit set and nothing at weight four or above
+        V low = Op::andNot(Op::orV(c4, c5), bit1);
+        return Op::andV(low, Op::orV(bit0, alive));
+    }
+
+    // The two weight-four carries give the fours and eights bits
+    V bits[4] = { bit0, bit1, Op::xorV(c4, c5), Op::andV(c4, c5) };
+    return ruleTerms<Op, 8>::apply(mask, alive, bits);
+}
+
+#endif
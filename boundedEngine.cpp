@@ -0,0 +1,257 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   Bounded universes. Cell (x, y) is bit (x - x0 + 1) of bitmap row (y - y0 + 1); bit 0, bit width + 1
+   and rows 0 and height + 1 form the halo. Each step first copies the opposite edges into the halo:
+
+      torus   halo column 0 <- column width, column width + 1 <- column 1, then the halo rows are
+              copies of rows height and 1 (corners included, since the columns are done first)
+      klein   columns as for the torus, the halo rows are rows height and 1 reversed, which maps
+              padded bit p to bit width + 1 - p
+      walled  the halo stays clear
+
+   The west and east neighbour bitmaps are then formed by shifting the whole grid one bit, and every
+   interior row is advanced a vector of words at a time. The result is masked to the universe so a
+   birth in the padding can never leak into the next generation. Wrapping costs O(width + height) per
+   generation instead of a modulo per cell.
+*/
+
+// Headers
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <bitset>
+#include <algorithm>
+#include "boundedEngine.h"
+#include "bitKernel.h"
+#include "cellPairs.h"
+
+
+// Advances rows 1 to 'rows' of the grid. L, C and R are the grid shifted so that bit i holds the
+// west neighbour, the cell itself and the east neighbour.
+template <class Op, uint32_t MASK>
+static void stepGrid(const uint64_t* L, const uint64_t* C, const uint64_t* R, uint64_t* out, const uint64_t* rowMask,
+    size_t stride, int rows, uint32_t mask)
+{
+    for (int r = 1; r <= rows; r++) {
+        for (size_t w = 0; w < stride; w += Op::lanes) {
+            size_t i = r * stride + w, below = i - stride, above = i + stride;
+            typename Op::V cellsNext = nextCells<Op, MASK>(Op::load(L + below), Op::load(C + below), Op::load(R + below),
+                Op::load(L + i), Op::load(R + i), Op::load(L + above), Op::load(C + above), Op::load(R + above),
+                Op::load(C + i), mask);
+            Op::store(out + i, Op::andV(cellsNext, Op::load(rowMask + w)));
+        }
+    }
+}
+
+
+bool parseTopology(const std::string& name, topology& topo)
+{
+    if (name == "plane")
+        topo = TOPOLOGY_PLANE;
+    else if (name == "torus")
+        topo = TOPOLOGY_TORUS;
+    else if (name == "klein")
+        topo = TOPOLOGY_KLEIN;
+    else if (name == "walled")
+        topo = TOPOLOGY_WALLED;
+    else
+        return false;
+    return true;
+}
+
+
+const char* topologyName(topology topo)
+{
+    switch (topo) {
+    case TOPOLOGY_TORUS:
+        return "torus";
+    case TOPOLOGY_KLEIN:
+        return "klein";
+    case TOPOLOGY_WALLED:
+        return "walled";
+    default:
+        return "plane";
+    }
+}
+
+
+boundedEngine::boundedEngine(topology topo, int width, int height)
+    : topo(topo), width(std::max(1, width)), height(std::max(1, height))
+{
+    x0 = -(this->width / 2);
+    y0 = -(this->height / 2);
+    stride = ((size_t)this->width + 2 + 255) / 256 * 4;
+
+    size_t words = stride * ((size_t)this->height + 2);
+    cells.assign(words, 0);
+    next.assign(words, 0);
+    west.assign(words, 0);
+    east.assign(words, 0);
+
+    rowMask.assign(stride, 0);
+    for (int p = 1; p <= this->width; p++)
+        rowMask[p >> 6] |= 1ull << (p & 63);
+
+    setRule(LIFE);
+}
+
+
+bool boundedEngine::setRule(const lifeRule& rule)
+{
+    if (rule.generations())
+        return false;
+
+    ruleMask = rule.mask();
+    switch (ruleMask) {
+    case LIFE_MASK:
+        kernel = stepGrid<simdOps, LIFE_MASK>;
+        break;
+    case HIGHLIFE_MASK:
+        kernel = stepGrid<simdOps, HIGHLIFE_MASK>;
+        break;
+    case DAYNIGHT_MASK:
+        kernel = stepGrid<simdOps, DAYNIGHT_MASK>;
+        break;
+    case SEEDS_MASK:
+        kernel = stepGrid<simdOps, SEEDS_MASK>;
+        break;
+    default:
+        kernel = stepGrid<simdOps, RUNTIME_MASK>;
+        break;
+    }
+    return true;
+}
+
+
+// Brings a cell into the universe. Returns false if it lies outside a walled box.
+bool boundedEngine::wrap(int64_t& x, int64_t& y) const
+{
+    int64_t lx = x - x0, ly = y - y0;
+
+    if (topo == TOPOLOGY_WALLED) {
+        if (lx < 0 || lx >= width || ly < 0 || ly >= height)
+            return false;
+    }
+    else {
+        // Every trip across the top or bottom edge of a Klein bottle mirrors x
+        int64_t turns = (ly >= 0 ? ly : ly - height + 1) / height;
+        ly -= turns * height;
+        lx = ((lx % width) + width) % width;
+        if (topo == TOPOLOGY_KLEIN && (turns & 1))
+            lx = width - 1 - lx;
+    }
+
+    x = lx + x0;
+    y = ly + y0;
+    return true;
+}
+
+
+void boundedEngine::load(const std::vector<int>& X, const std::vector<int>& Y)
+{
+    std::fill(cells.begin(), cells.end(), 0);
+    for (cellCoord c : cellPairs(X, Y)) {
+        int64_t x = c.x, y = c.y;
+        if (!wrap(x, y))
+            continue;
+
+        int p = (int)(x - x0) + 1;
+        row((int)(y - y0) + 1)[p >> 6] |= 1ull << (p & 63);
+    }
+}
+
+
+void boundedEngine::fillHalo()
+{
+    const int right = width + 1;
+
+    if (topo == TOPOLOGY_WALLED) {
+        // Nothing ever writes the halo of a walled box, and the kernel masks the padding columns
+        return;
+    }
+
+    for (int r = 1; r <= height; r++) {
+        uint64_t* cur = row(r);
+        uint64_t first = cur[0] >> 1 & 1;
+        uint64_t last = cur[width >> 6] >> (width & 63) & 1;
+
+        cur[0] = (cur[0] & ~1ull) | last;
+        cur[right >> 6] = (cur[right >> 6] & ~(1ull << (right & 63))) | first << (right & 63);
+    }
+
+    if (topo == TOPOLOGY_TORUS) {
+        std::copy(row(height), row(height) + stride, row(0));
+        std::copy(row(1), row(1) + stride, row(height + 1));
+        return;
+    }
+
+    // Klein bottle: the rows beyond the top and bottom are the opposite edge mirrored
+    uint64_t* bottom = row(0);
+    uint64_t* top = row(height + 1);
+    const uint64_t* lastRow = row(height);
+    const uint64_t* firstRow = row(1);
+
+    std::fill(bottom, bottom + stride, 0);
+    std::fill(top, top + stride, 0);
+    for (int p = 0; p <= right; p++) {
+        int q = right - p;
+        bottom[p >> 6] |= (lastRow[q >> 6] >> (q & 63) & 1) << (p & 63);
+        top[p >> 6] |= (firstRow[q >> 6] >> (q & 63) & 1) << (p & 63);
+    }
+}
+
+
+// Neighbour bitmaps, carrying the edge bits across words. Row ends are padding or halo, so nothing
+// needs to carry between rows.
+void boundedEngine::shiftNeighbours()
+{
+    size_t words = cells.size();
+    for (size_t i = 0; i < words; i++) {
+        size_t w = i % stride;
+        uint64_t c = cells[i];
+        west[i] = (c << 1) | (w > 0 ? cells[i - 1] >> 63 : 0);
+        east[i] = (c >> 1) | (w + 1 < stride ? cells[i + 1] << 63 : 0);
+    }
+}
+
+
+void boundedEngine::step()
+{
+    fillHalo();
+    shiftNeighbours();
+    kernel(west.data(), cells.data(), east.data(), next.data(), rowMask.data(), stride, height, ruleMask);
+    cells.swap(next);
+}
+
+
+void boundedEngine::store(std::vector<int>& X, std::vector<int>& Y) const
+{
+    X.clear();
+    Y.clear();
+
+    for (int r = 1; r <= height; r++) {
+        const uint64_t* cur = &cells[(size_t)r * stride];
+        for (size_t w = 0; w < stride; w++) {
+            uint64_t bits = cur[w] & rowMask[w];
+            for (int b = 0; bits; b++, bits >>= 1) {
+                if (bits & 1) {
+                    X.push_back(x0 + (int)(w * 64 + b) - 1);
+                    Y.push_back(y0 + r - 1);
+                }
+            }
+        }
+    }
+}
+
+
+size_t boundedEngine::population() const
+{
+    size_t pop = 0;
+    for (int r = 1; r <= height; r++)
+        for (size_t w = 0; w < stride; w++)
+            pop += std::bitset<64>(cells[(size_t)r * stride + w] & rowMask[w]).count();
+    return pop;
+}
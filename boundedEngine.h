@@ -0,0 +1,64 @@
+#ifndef BOUNDED_ENGINE_H
+#define BOUNDED_ENGINE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "lifeEngine.h"
+
+// How the edges of the universe are joined
+enum topology
+{
+    TOPOLOGY_PLANE,    // Unbounded. Coordinates wrap modulo 2^32, see README
+    TOPOLOGY_TORUS,    // Left joins right and top joins bottom
+    TOPOLOGY_KLEIN,    // Left joins right, top joins bottom mirrored left to right
+    TOPOLOGY_WALLED    // Everything outside the box is permanently dead
+};
+
+// Parses plane, torus, klein or walled. Returns false if the name is not known.
+bool parseTopology(const std::string& name, topology& topo);
+const char* topologyName(topology topo);
+
+// Dense engine for a fixed width x height universe covering x in [-width/2, width - width/2) and the
+// same for y. The grid is one bitmap with a one-cell halo on every side: before each step the halo
+// is filled from the opposite edges (or cleared for walls), so the kernel itself never wraps a
+// coordinate and every row is advanced with the same bit-sliced adders as the tile engine.
+class boundedEngine : public lifeEngine
+{
+public:
+    boundedEngine(topology topo, int width, int height);
+
+    void load(const std::vector<int>& X, const std::vector<int>& Y) override;
+    void step() override;
+    void store(std::vector<int>& X, std::vector<int>& Y) const override;
+    size_t population() const override;
+    const char* name() const override { return topologyName(topo); }
+    bool setRule(const lifeRule& rule) override;    // Two-state rules only
+
+protected:
+    // The box is fixed around the origin, so there is never anything to recenter
+    bool localBounds(int64_t& /* minX */, int64_t& /* minY */, int64_t& /* maxX */, int64_t& /* maxY */) const override { return false; }
+    void shift(int64_t /* dx */, int64_t /* dy */) override {}
+
+    // Shared with the engines that step the same grid with another kernel
+    void fillHalo();
+    void shiftNeighbours();    // Fills west and east from cells
+    uint64_t* row(int r) { return &cells[(size_t)r * stride]; }
+
+    topology topo;
+    int width, height;
+    int x0, y0;              // Universe coordinates of the first cell of the bitmap
+    size_t stride;           // Words per bitmap row, a multiple of four
+    std::vector<uint64_t> cells, next, west, east;
+    std::vector<uint64_t> rowMask;    // Bits of a row that are inside the universe
+
+    // Grid kernel specialized for the current rule
+    void (*kernel)(const uint64_t* L, const uint64_t* C, const uint64_t* R, uint64_t* out, const uint64_t* rowMask,
+        size_t stride, int rows, uint32_t mask);
+    uint32_t ruleMask;
+
+private:
+    bool wrap(int64_t& x, int64_t& y) const;
+};
+
+#endif
@@ -8,29 +8,339 @@ Description:
    instead of O(GRIDSIZE^2). This is much faster and allows for a much larger grid (potentially
    infinite).
 
-   Add section which finds the total size of grid needed to hold alive cell information and mods
-   out vectors X and Y by this value to minimize the integer stored within these vectors. For
-   example, if min(X,Y) = 1000 and max(X,Y) = 1100, then we only need to have a grid size of 100
-   to fully describe the alive cell arrangement.
-
-   Maybe a better idea to the above is to find what is equivalent to the 'center of mass' of all
-   alive cells, and recenter (0,0) to that point.
+   calcState keys every live cell by its packed 64-bit (x,y) in an open-addressing hash set and
+   adds one to each of its eight neighbours in a single pass, so one generation costs O(N). The
+   original neighbour-scan implementation is kept as calcStateNaive, which walks X and Y for every
+   cell and is O(N^2); it is only used as a reference when checking the faster engines.
+
+   The overload taking a threadPool splits the live cells into horizontal bands. Each band builds its
+   own table from its cells plus the single row of halo cells just above and below it, and only
+   keeps the results inside its own rows, so the bands never write to shared state. The cells sorted
+   by band live in an arena that is emptied at the end of the call; the tables and output vectors
+   keep their capacity between calls, so a long run stops allocating once it has warmed up.
+
+   Coordinates are computed modulo 2^32, so a pattern wider than the int range wraps around to the
+   other side rather than overflowing.
+
+   The rule is applied as a single shift of the rule mask by (count + 9 * alive). Life, HighLife,
+   Day & Night and Seeds get their own instantiation of emitCells with the mask as a template
+   constant; any other rule goes through the same code with the mask read at run time. Generations
+   rules carry a state per cell in S and take a separate serial path.
+
+   X and Y are offsets from a 64-bit origin kept by the engine (see lifeEngine.h), which recenters
+   (0,0) on the middle of the pattern whenever it drifts towards the edge of the int range, so the
+   values stored in these vectors stay small however far the pattern travels.
 */
 
 // Headers
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <cstdint>
 #include "calcState.h"
+#include "cellPairs.h"
+#include "memoryPool.h"
+#include "metrics.h"
+#include "cellHash.h"
 
 
 // Functions
-void findNeigh(std::vector<int> X, std::vector<int> Y, int i, bool& E, bool& NE, bool& N, bool& NW, bool& W, bool& SW, bool& S, bool& SE,
+void findNeigh(const std::vector<int>& X, const std::vector<int>& Y, int i, bool& E, bool& NE, bool& N, bool& NW, bool& W, bool& SW, bool& S, bool& SE,
     bool& EE, bool& NEE, bool& NENE, bool& NEN, bool& NN, bool& NWN, bool& NWNW, bool& NWW, bool& WW, bool& SWW, bool& SWSW,
     bool& SWS, bool& SS, bool& SES, bool& SESE, bool& SEE);
-void vecCheck(std::vector<int> X, std::vector<int> Y, int x, int y, bool& contained);
+void vecCheck(const std::vector<int>& X, const std::vector<int>& Y, int x, int y, bool& contained);
+
+
+// Layout of the per-cell byte in the neighbour table
+const uint8_t ALIVE = 0x10;
+const uint8_t DYING = 0x20;
+const uint8_t COUNT = 0x0F;
+
+// Number of bands per thread in the parallel step, so that work stealing can even out uneven soups
+const int BANDS_PER_THREAD = 8;
+
+
+// Marks the cell alive and adds one to each of its eight neighbours
+static void tallyCell(cellHash& table, int cx, int cy)
+{
+    static const int dx[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+    static const int dy[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+
+    // Neighbours are computed in unsigned arithmetic so the edge of the int range cannot overflow
+    uint32_t x = (uint32_t)cx;
+    uint32_t y = (uint32_t)cy;
+
+    table.slot(packCell(cx, cy)) |= ALIVE;
+    for (int d = 0; d < 8; d++)
+        table.slot(packCell((int)(x + dx[d]), (int)(y + dy[d])))++;
+}
+
+
+// Bit of the rule mask that decides the next state of a table entry
+static inline uint32_t ruleBit(uint8_t v)
+{
+    return (v & COUNT) + 9 * ((v & ALIVE) >> 4);
+}
+
+
+// Two-state rule known at compile time, so the mask folds into the emit loop
+template <uint32_t MASK>
+struct fixedRule
+{
+    bool operator()(uint8_t v) const { return MASK >> ruleBit(v) & 1; }
+};
+
+
+// Any other two-state rule
+struct anyRule
+{
+    uint32_t mask;
+    bool operator()(uint8_t v) const { return mask >> ruleBit(v) & 1; }
+};
+
+
+// Appends every cell of the table that is alive next generation and whose y lies in [yLo, yHi].
+// Returns how many of them were alive already.
+template <class Rule>
+static size_t emitCells(const cellHash& table, std::vector<int>& outX, std::vector<int>& outY, int64_t yLo, int64_t yHi, Rule alive)
+{
+    size_t survivors = 0;
+    for (size_t i = 0; i < table.capacity(); i++) {
+        if (alive(table.valueAt(i))) {
+            int y = unpackY(table.keyAt(i));
+            if (y >= yLo && y <= yHi) {
+                outX.push_back(unpackX(table.keyAt(i)));
+                outY.push_back(y);
+                survivors += (table.valueAt(i) & ALIVE) != 0;
+            }
+        }
+    }
+    return survivors;
+}
+
+
+// Picks the emitCells instantiation for the rule, and adds the births and deaths among the given
+// number of live cells in [yLo, yHi] to the metrics
+static void emitRule(const cellHash& table, std::vector<int>& outX, std::vector<int>& outY, int64_t yLo, int64_t yHi, const lifeRule& rule, size_t live)
+{
+    METRIC_PHASE(PHASE_RULE);
+    size_t before = outX.size(), survivors;
+
+    switch (rule.mask()) {
+    case LIFE_MASK:
+        survivors = emitCells(table, outX, outY, yLo, yHi, fixedRule<LIFE_MASK>());
+        break;
+    case HIGHLIFE_MASK:
+        survivors = emitCells(table, outX, outY, yLo, yHi, fixedRule<HIGHLIFE_MASK>());
+        break;
+    case DAYNIGHT_MASK:
+        survivors = emitCells(table, outX, outY, yLo, yHi, fixedRule<DAYNIGHT_MASK>());
+        break;
+    case SEEDS_MASK:
+        survivors = emitCells(table, outX, outY, yLo, yHi, fixedRule<SEEDS_MASK>());
+        break;
+    default:
+        survivors = emitCells(table, outX, outY, yLo, yHi, anyRule{ rule.mask() });
+        break;
+    }
+
+    METRIC_ADD(COUNTER_BIRTHS, outX.size() - before - survivors);
+    METRIC_ADD(COUNTER_DEATHS, live - survivors);
+}
+
+
+void calcState(std::vector<int>& X, std::vector<int>& Y, const lifeRule& rule)
+{
+    // Scratch kept between calls so a generation does no heap allocation once the buffers have
+    // grown to the working population. tempX/tempY are swapped with X/Y at the end of the step,
+    // so on the next call they hold the previous generation's storage and are simply cleared.
+    static thread_local cellHash table;
+    static thread_local std::vector<int> tempX, tempY;
+
+    cellPairs cells(X, Y);
+
+    // Every live cell and its eight neighbours may be entered, so size for 9N keys
+    table.reset(9 * cells.size());
+    tempX.clear();
+    tempY.clear();
+
+    {
+        METRIC_PHASE(PHASE_COUNT);
+        for (cellCoord c : cells)
+            tallyCell(table, c.x, c.y);
+    }
+    emitRule(table, tempX, tempY, INT64_MIN, INT64_MAX, rule, cells.size());
+
+    X.swap(tempX);
+    Y.swap(tempY);
+}
+
+
+void calcState(std::vector<int>& X, std::vector<int>& Y, threadPool& pool, const lifeRule& rule)
+{
+    // Scratch shared by the bands: the cells sorted by band from the arena, and one table and output
+    // pair per band. A band keeps its own table whichever worker takes it, so the table stays sized
+    // for that band's cells. The scratch belongs to the calling thread, so engines stepping on
+    // different threads do not share it, and the bands reach it through references since the
+    // workers' own thread_local copies are other objects.
+    static thread_local scratchArena scratch;
+    static thread_local std::vector<int> tempX, tempY;
+    static thread_local std::vector<std::vector<int>> bandX, bandY;
+    static thread_local std::vector<cellHash> bandTables;
+    std::vector<std::vector<int>>& outX = bandX;
+    std::vector<std::vector<int>>& outY = bandY;
+    std::vector<cellHash>& tables = bandTables;
+
+    size_t n = cellPairs(X, Y).size();
+    if (pool.size() == 1 || n == 0) {
+        calcState(X, Y, rule);
+        return;
+    }
+
+    int64_t minY = *std::min_element(Y.begin(), Y.begin() + n);
+    int64_t maxY = *std::max_element(Y.begin(), Y.begin() + n);
+
+    // Neighbours of the first and last int rows wrap to the opposite end, which no band would see
+    if (minY == INT32_MIN || maxY == INT32_MAX) {
+        calcState(X, Y, rule);
+        return;
+    }
+    int bands = BANDS_PER_THREAD * pool.size();
+    int64_t height = std::max<int64_t>(1, (maxY - minY + bands) / bands);
+    bands = (int)((maxY - minY) / height) + 1;
+
+    // Counting sort of the cells into horizontal bands
+    size_t* bandStart = scratch.allocate<size_t>(bands + 1);
+    int* sortedX = scratch.allocate<int>(n);
+    int* sortedY = scratch.allocate<int>(n);
+    {
+        METRIC_PHASE(PHASE_COUNT);
+        std::fill(bandStart, bandStart + bands + 1, 0);
+        for (size_t i = 0; i < n; i++)
+            bandStart[(Y[i] - minY) / height + 1]++;
+        for (int b = 0; b < bands; b++)
+            bandStart[b + 1] += bandStart[b];
+
+        for (size_t i = 0; i < n; i++) {
+            size_t at = bandStart[(Y[i] - minY) / height]++;
+            sortedX[at] = X[i];
+            sortedY[at] = Y[i];
+        }
+        for (int b = bands; b > 0; b--)
+            bandStart[b] = bandStart[b - 1];
+        bandStart[0] = 0;
+    }
+
+    if ((int)outX.size() < bands) {
+        outX.resize(bands);
+        outY.resize(bands);
+        tables.resize(bands);
+    }
+
+    // Each band counts its own cells plus the adjacent row of the bands on either side, and keeps
+    // only the cells inside its own rows (the outermost bands also keep births beyond the pattern)
+    pool.run(bands, [&](size_t b) {
+        cellHash& table = tables[b];
+        int64_t y0 = minY + (int64_t)b * height, y1 = y0 + height - 1;
+        size_t begin = bandStart[b], end = bandStart[b + 1];
+        size_t haloBegin = b > 0 ? bandStart[b - 1] : begin;
+        size_t haloEnd = (int)b + 1 < bands ? bandStart[b + 2] : end;
+
+        outX[b].clear();
+        outY[b].clear();
+        // Sized for at least an average band, as the band edges move with the pattern and a band that
+        // is empty every other generation would otherwise shrink and grow its table each time
+        table.reset(9 * std::max(end - begin, n / bands) + 64);
+
+        {
+            METRIC_PHASE(PHASE_COUNT);
+            for (size_t i = begin; i < end; i++)
+                tallyCell(table, sortedX[i], sortedY[i]);
+            for (size_t i = haloBegin; i < haloEnd; i++)
+                if (sortedY[i] == y0 - 1 || sortedY[i] == y1 + 1)
+                    tallyCell(table, sortedX[i], sortedY[i]);
+        }
+
+        emitRule(table, outX[b], outY[b], b == 0 ? INT64_MIN : y0, (int)b == bands - 1 ? INT64_MAX : y1, rule, end - begin);
+    });
+
+    METRIC_PHASE(PHASE_COMMIT);
+    tempX.clear();
+    tempY.clear();
+    for (int b = 0; b < bands; b++) {
+        tempX.insert(tempX.end(), outX[b].begin(), outX[b].end());
+        tempY.insert(tempY.end(), outY[b].begin(), outY[b].end());
+    }
+
+    X.swap(tempX);
+    Y.swap(tempY);
+    scratch.reset();
+}
+
+
+void calcState(std::vector<int>& X, std::vector<int>& Y, std::vector<uint8_t>& S, const lifeRule& rule)
+{
+    static thread_local cellHash table;
+    static thread_local std::vector<int> tempX, tempY;
+    static thread_local std::vector<uint8_t> tempS;
+
+    size_t n = std::min(std::min(X.size(), Y.size()), S.size());
+    uint32_t mask = rule.mask();
+
+    table.reset(9 * n);
+    tempX.clear();
+    tempY.clear();
+    tempS.clear();
+
+    // Only live cells count as neighbours; dying cells are marked so nothing is born on top of them
+    {
+        METRIC_PHASE(PHASE_COUNT);
+        for (size_t i = 0; i < n; i++) {
+            if (S[i] == 1)
+                tallyCell(table, X[i], Y[i]);
+            else
+                table.slot(packCell(X[i], Y[i])) |= DYING;
+        }
+    }
+
+    METRIC_PHASE(PHASE_RULE);
+    size_t births = 0, deaths = 0;
+
+    // Dying cells move on to the next state whatever their neighbours, and are dead after the last
+    for (size_t i = 0; i < n; i++) {
+        if (S[i] > 1 && S[i] + 1 < rule.states) {
+            tempX.push_back(X[i]);
+            tempY.push_back(Y[i]);
+            tempS.push_back(S[i] + 1);
+        }
+    }
+
+    // Live cells that fail the survival condition start dying instead of disappearing
+    for (size_t i = 0; i < table.capacity(); i++) {
+        uint8_t v = table.valueAt(i);
+        if (v == 0 || (v & DYING))
+            continue;
+
+        uint8_t next = (mask >> ruleBit(v) & 1) ? 1 : (v & ALIVE) && rule.states > 2 ? 2 : 0;
+        births += next == 1 && !(v & ALIVE);
+        deaths += next != 1 && (v & ALIVE);
+        if (next) {
+            tempX.push_back(unpackX(table.keyAt(i)));
+            tempY.push_back(unpackY(table.keyAt(i)));
+            tempS.push_back(next);
+        }
+    }
+
+    METRIC_ADD(COUNTER_BIRTHS, births);
+    METRIC_ADD(COUNTER_DEATHS, deaths);
+
+    X.swap(tempX);
+    Y.swap(tempY);
+    S.swap(tempS);
+}
+
 
-void calcState(std::vector<int>& X, std::vector<int>& Y)
+void calcStateNaive(std::vector<int>& X, std::vector<int>& Y)
 {
     std::vector<int> tempX, tempY;
     bool E, NE, N, NW, W, SW, S, SE, EE, NEE, NENE, NEN, NN, NWN, NWNW, NWW, WW, SWW, SWSW, SWS, SS, SES, SESE, SEE;
@@ -239,17 +549,15 @@ void calcState(std::vector<int>& X, std::vector<int>& Y)
         }
     }
 
-    // Clear and reassign values to vectors X and Y
-    X.clear();
-    Y.clear();
-    X = tempX;
-    Y = tempY;
+    // Hand the new generation over without copying it
+    X.swap(tempX);
+    Y.swap(tempY);
 
     return;
 }
 
 
-void findNeigh(std::vector<int> X, std::vector<int> Y, int i, bool& E, bool& NE, bool& N, bool& NW, bool& W, bool& SW, bool& S, bool& SE,
+void findNeigh(const std::vector<int>& X, const std::vector<int>& Y, int i, bool& E, bool& NE, bool& N, bool& NW, bool& W, bool& SW, bool& S, bool& SE,
     bool& EE, bool& NEE, bool& NENE, bool& NEN, bool& NN, bool& NWN, bool& NWNW, bool& NWW, bool& WW, bool& SWW, bool& SWSW,
     bool& SWS, bool& SS, bool& SES, bool& SESE, bool& SEE)
 {
@@ -283,7 +591,7 @@ void findNeigh(std::vector<int> X, std::vector<int> Y, int i, bool& E, bool& NE,
 }
 
 
-void vecCheck(std::vector<int> X, std::vector<int> Y, int x, int y, bool& contained) {
+void vecCheck(const std::vector<int>& X, const std::vector<int>& Y, int x, int y, bool& contained) {
     for (int i = 0; i < std::min(X.size(), Y.size()); i++)
     {
         if (X[i] == x && Y[i] == y) {
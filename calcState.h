@@ -4,7 +4,13 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <cstdint>
+#include "threadPool.h"
+#include "lifeRule.h"
 
-void calcState(std::vector<int>& X, std::vector<int>& Y);
+void calcState(std::vector<int>& X, std::vector<int>& Y, const lifeRule& rule = LIFE);
+void calcState(std::vector<int>& X, std::vector<int>& Y, threadPool& pool, const lifeRule& rule = LIFE); // Band-parallel step
+void calcState(std::vector<int>& X, std::vector<int>& Y, std::vector<uint8_t>& S, const lifeRule& rule); // Generations rules, S holds each cell's state
+void calcStateNaive(std::vector<int>& X, std::vector<int>& Y); // O(N^2) reference implementation
 
 #endif
\ No newline at end of file
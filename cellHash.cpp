@@ -0,0 +1,103 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   Hash set keyed by packed (x,y) cell coordinates. Each key carries a single byte which the engines
+   use to accumulate neighbour counts and the alive flag, so the whole neighbourhood of a generation
+   can be tallied in one pass over the live cells.
+*/
+
+// Headers
+#include <vector>
+#include <cstring>
+#include "cellHash.h"
+#include "metrics.h"
+
+
+cellHash::cellHash() : mask(0), count(0), shift(64)
+{
+    reset(0);
+}
+
+
+void cellHash::reset(size_t expected)
+{
+    // Keep the load factor under one half
+    size_t cap = 16;
+    int bits = 4;
+    while (cap < 2 * expected) {
+        cap <<= 1;
+        bits++;
+    }
+
+    // Reuse the current storage unless it is too small or more than four times too large, so a
+    // population that wobbles around a power of two does not reallocate every generation
+    if (cap > keys.size() || 4 * cap < keys.size()) {
+        METRIC_ADD(COUNTER_ALLOCATIONS, 2);
+        keys.assign(cap, 0);
+        vals.assign(cap, 0);
+    }
+    else {
+        while (cap < keys.size()) {
+            cap <<= 1;
+            bits++;
+        }
+        memset(vals.data(), 0, cap);
+    }
+
+    mask = cap - 1;
+    shift = 64 - bits;
+    count = 0;
+}
+
+
+uint8_t& cellHash::slot(uint64_t key)
+{
+    if (2 * (count + 1) > keys.size())
+        grow();
+
+    size_t i = index(key);
+    while (vals[i]) {
+        if (keys[i] == key)
+            return vals[i];
+        i = (i + 1) & mask;
+    }
+
+    keys[i] = key;
+    count++;
+    return vals[i];
+}
+
+
+uint8_t cellHash::get(uint64_t key) const
+{
+    size_t i = index(key);
+    while (vals[i]) {
+        if (keys[i] == key)
+            return vals[i];
+        i = (i + 1) & mask;
+    }
+    return 0;
+}
+
+
+void cellHash::grow()
+{
+    std::vector<uint64_t> oldKeys;
+    std::vector<uint8_t> oldVals;
+    oldKeys.swap(keys);
+    oldVals.swap(vals);
+
+    reset(oldKeys.size());
+    for (size_t i = 0; i < oldKeys.size(); i++) {
+        if (oldVals[i]) {
+            size_t j = index(oldKeys[i]);
+            while (vals[j])
+                j = (j + 1) & mask;
+            keys[j] = oldKeys[i];
+            vals[j] = oldVals[i];
+            count++;
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef CELL_HASH_H
+#define CELL_HASH_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Packs a coordinate pair into a single 64-bit key, x in the high word and y in the low word
+inline uint64_t packCell(int x, int y)
+{
+    return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+}
+
+inline int unpackX(uint64_t key) { return (int)(uint32_t)(key >> 32); }
+inline int unpackY(uint64_t key) { return (int)(uint32_t)key; }
+
+// Open-addressing (linear probing) table from packed cell keys to a one byte value. A slot whose
+// value is zero is treated as empty, so callers must leave every slot they touch non-zero.
+class cellHash
+{
+public:
+    cellHash();
+
+    void reset(size_t expected);           // Empty the table and size it for 'expected' keys
+    uint8_t& slot(uint64_t key);           // Returns the value for key, inserting it if missing
+    uint8_t get(uint64_t key) const;       // Returns 0 if key is not present
+
+    size_t size() const { return count; }
+    size_t capacity() const { return keys.size(); }
+    uint64_t keyAt(size_t i) const { return keys[i]; }
+    uint8_t valueAt(size_t i) const { return vals[i]; }
+
+private:
+    size_t index(uint64_t key) const { return (size_t)((key * 0x9E3779B97F4A7C15ull) >> shift); }
+    void grow();
+
+    std::vector<uint64_t> keys;
+    std::vector<uint8_t> vals;
+    size_t mask;
+    size_t count;
+    int shift;
+};
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef CELL_PAIRS_H
+#define CELL_PAIRS_H
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+// A live cell in local coordinates
+struct cellCoord
+{
+    int x, y;
+};
+
+// Read-only view of cells held as two parallel vectors, the X/Y form the engines exchange. Its
+// length is that of the shorter vector, so a stray extra x or y is dropped here once instead of by
+// every caller. The vectors must outlive the view and keep their size while it is in use.
+class cellPairs
+{
+public:
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = cellCoord;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const cellCoord*;
+        using reference = cellCoord;
+
+        const_iterator(const int* x = nullptr, const int* y = nullptr) : x(x), y(y) {}
+
+        cellCoord operator*() const { return { *x, *y }; }
+        const_iterator& operator++() { ++x; ++y; return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; ++*this; return old; }
+        bool operator==(const const_iterator& o) const { return x == o.x; }
+        bool operator!=(const const_iterator& o) const { return x != o.x; }
+
+    private:
+        const int* x;
+        const int* y;
+    };
+
+    cellPairs(const std::vector<int>& X, const std::vector<int>& Y)
+        : X(X.data()), Y(Y.data()), n(X.size() < Y.size() ? X.size() : Y.size()) {}
+
+    size_t size() const { return n; }
+    bool empty() const { return n == 0; }
+    cellCoord operator[](size_t i) const { return { X[i], Y[i] }; }
+    const_iterator begin() const { return const_iterator(X, Y); }
+    const_iterator end() const { return const_iterator(X + n, Y + n); }
+
+private:
+    const int* X;
+    const int* Y;
+    size_t n;
+};
+
+#endif
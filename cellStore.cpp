@@ -0,0 +1,261 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   The sorted Morton cell store. A generation is built by writing the keys of the eight neighbours of
+   every live cell, sorting them, and walking the sorted neighbour keys together with the live keys:
+   the length of each run is the neighbour count of that cell, and whether the live array holds the
+   key at the same point says if it is alive. Both sequences are in key order, so the cells that
+   follow are written in key order as well and need no sort of their own.
+
+   The neighbour keys are found without unpacking the coordinates. Adding to the x bits of a key is
+   done by setting the y bits so that the carries pass through them, adding the spread-out offset, and
+   putting the y bits back; the same works for y with the roles swapped. -1 spread out is every bit of
+   its axis set, and the sums wrap in the int range like the rest of the program.
+
+   Large neighbour arrays are sorted with a radix sort on 16-bit digits, skipping a digit when every
+   key has the same value in it; small ones with std::sort. The neighbour keys, the second sort buffer
+   and the digit counts come from the store's arena and are released together after each generation.
+*/
+
+// Headers
+#include <vector>
+#include <algorithm>
+#include "cellStore.h"
+#include "metrics.h"
+
+
+const uint64_t X_BITS = 0x5555555555555555ull;
+const uint64_t Y_BITS = 0xAAAAAAAAAAAAAAAAull;
+const size_t RADIX_MIN = 1 << 16;    // Below this many keys std::sort is faster
+
+
+static inline uint64_t addX(uint64_t key, uint64_t dx)
+{
+    return (((key | Y_BITS) + dx) & X_BITS) | (key & Y_BITS);
+}
+
+
+static inline uint64_t addY(uint64_t key, uint64_t dy)
+{
+    return (((key | X_BITS) + dy) & Y_BITS) | (key & X_BITS);
+}
+
+
+void cellStore::assign(const std::vector<int>& X, const std::vector<int>& Y)
+{
+    cellPairs cells(X, Y);
+    keys.clear();
+    keys.reserve(cells.size());
+    for (cellCoord c : cells)
+        keys.push_back(mortonKey(c.x, c.y));
+
+    sortInPlace();
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+}
+
+
+void cellStore::copyTo(std::vector<int>& X, std::vector<int>& Y) const
+{
+    X.clear();
+    Y.clear();
+    X.reserve(keys.size());
+    Y.reserve(keys.size());
+    for (cellCoord c : *this) {
+        X.push_back(c.x);
+        Y.push_back(c.y);
+    }
+}
+
+
+bool cellStore::contains(int x, int y) const
+{
+    return std::binary_search(keys.begin(), keys.end(), mortonKey(x, y));
+}
+
+
+size_t cellStore::seek(uint64_t key, size_t& hint) const
+{
+    size_t n = keys.size();
+    size_t lo = std::min(hint, n);
+
+    // Double the step until it passes the key, then binary search the last step
+    size_t step = 1;
+    size_t hi = lo;
+    while (hi < n && keys[hi] < key) {
+        lo = hi + 1;
+        hi += step;
+        step *= 2;
+    }
+    hi = std::min(hi, n);
+
+    hint = std::lower_bound(keys.begin() + lo, keys.begin() + hi, key) - keys.begin();
+    return hint;
+}
+
+
+// Walks the bits from the top, keeping the corners of the part of the rectangle still in play.
+// Where the corners differ in a bit and the key has it clear, the upper half of that axis holds the
+// best answer so far and the search goes on in the lower half; where the key has it set, the lower
+// half is behind it and is dropped. Once the key is below or above the whole remaining box, the
+// answer is its low corner or the best one found.
+uint64_t cellStore::nextInside(uint64_t key, uint64_t low, uint64_t high)
+{
+    uint64_t best = 0;
+    for (int bit = 63; bit >= 0; bit--) {
+        uint64_t b = 1ull << bit;
+        uint64_t below = (bit & 1 ? Y_BITS : X_BITS) & (b - 1);    // Lower bits of the same axis
+        bool k = key & b, lo = low & b, hi = high & b;
+
+        if (lo == hi) {
+            if (k != lo)
+                return k ? best : low;
+            continue;
+        }
+        if (k)
+            low = (low & ~below) | b;
+        else {
+            best = (low & ~below) | b;
+            high = (high & ~b) | below;
+        }
+    }
+    return best;
+}
+
+
+bool cellStore::bounds(int64_t& minX, int64_t& minY, int64_t& maxX, int64_t& maxY) const
+{
+    if (keys.empty())
+        return false;
+
+    cellCoord first = *begin();
+    minX = maxX = first.x;
+    minY = maxY = first.y;
+    for (cellCoord c : *this) {
+        minX = std::min<int64_t>(minX, c.x);
+        maxX = std::max<int64_t>(maxX, c.x);
+        minY = std::min<int64_t>(minY, c.y);
+        maxY = std::max<int64_t>(maxY, c.y);
+    }
+    return true;
+}
+
+
+void cellStore::shift(int64_t dx, int64_t dy)
+{
+    // A translation keeps the cells distinct but not in key order
+    uint64_t sx = spreadBits((uint32_t)-dx);
+    uint64_t sy = spreadBits((uint32_t)-dy) << 1;
+    for (size_t i = 0; i < keys.size(); i++)
+        keys[i] = addY(addX(keys[i], sx), sy);
+    sortInPlace();
+}
+
+
+void cellStore::sortInPlace()
+{
+    uint64_t* sorted = sortKeys(keys.data(), scratch.allocate<uint64_t>(keys.size()), keys.size());
+    if (sorted != keys.data())
+        std::copy(sorted, sorted + keys.size(), keys.begin());
+    scratch.reset();
+}
+
+
+// Sorts the n keys of v using spare as the second buffer, and returns the one that holds the result
+uint64_t* cellStore::sortKeys(uint64_t* v, uint64_t* spare, size_t n)
+{
+    if (n < RADIX_MIN) {
+        std::sort(v, v + n);
+        return v;
+    }
+
+    // One pass counts all four digits
+    uint32_t* counts = scratch.allocate<uint32_t>(4 << 16);
+    std::fill(counts, counts + (4 << 16), 0);
+    for (size_t i = 0; i < n; i++)
+        for (int d = 0; d < 4; d++)
+            counts[(d << 16) + ((v[i] >> (16 * d)) & 0xFFFF)]++;
+
+    for (int d = 0; d < 4; d++) {
+        uint32_t* count = counts + (d << 16);
+        if (count[(v[0] >> (16 * d)) & 0xFFFF] == n)
+            continue;
+
+        uint32_t sum = 0;
+        for (int b = 0; b < (1 << 16); b++) {
+            uint32_t c = count[b];
+            count[b] = sum;
+            sum += c;
+        }
+        for (size_t i = 0; i < n; i++)
+            spare[count[(v[i] >> (16 * d)) & 0xFFFF]++] = v[i];
+        std::swap(v, spare);
+    }
+    return v;
+}
+
+
+void cellStore::advance(const lifeRule& rule)
+{
+    const uint64_t MINUS_X = X_BITS, MINUS_Y = Y_BITS;
+    const uint64_t PLUS_X = 1, PLUS_Y = 2;
+    uint32_t mask = rule.mask();
+
+    size_t total = keys.size() * 8;
+    uint64_t* spread = scratch.allocate<uint64_t>(total);
+    {
+        METRIC_PHASE(PHASE_COUNT);
+        uint64_t* out = spread;
+        for (size_t i = 0; i < keys.size(); i++) {
+            uint64_t up = addY(keys[i], PLUS_Y);
+            uint64_t down = addY(keys[i], MINUS_Y);
+            *out++ = addX(up, MINUS_X);
+            *out++ = up;
+            *out++ = addX(up, PLUS_X);
+            *out++ = addX(keys[i], MINUS_X);
+            *out++ = addX(keys[i], PLUS_X);
+            *out++ = addX(down, MINUS_X);
+            *out++ = down;
+            *out++ = addX(down, PLUS_X);
+        }
+        spread = sortKeys(spread, scratch.allocate<uint64_t>(total), total);
+    }
+
+    // Merge the runs of neighbour keys with the live keys
+    METRIC_PHASE(PHASE_RULE);
+    next.clear();
+    size_t i = 0, j = 0, survivors = 0;
+    while (i < total) {
+        uint64_t key = spread[i];
+        size_t start = i;
+        while (i < total && spread[i] == key)
+            i++;
+
+        // Live cells without neighbours come first, and only a rule with S0 keeps them
+        for (; j < keys.size() && keys[j] < key; j++) {
+            if (mask >> 9 & 1) {
+                next.push_back(keys[j]);
+                survivors++;
+            }
+        }
+
+        int alive = j < keys.size() && keys[j] == key;
+        j += alive;
+        if (mask >> ((i - start) + 9 * alive) & 1) {
+            next.push_back(key);
+            survivors += alive;
+        }
+    }
+    for (; j < keys.size(); j++) {
+        if (mask >> 9 & 1) {
+            next.push_back(keys[j]);
+            survivors++;
+        }
+    }
+
+    METRIC_ADD(COUNTER_BIRTHS, next.size() - survivors);
+    METRIC_ADD(COUNTER_DEATHS, keys.size() - survivors);
+    keys.swap(next);
+    scratch.reset();
+}
@@ -0,0 +1,130 @@
+#ifndef CELL_STORE_H
+#define CELL_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+#include "cellPairs.h"
+#include "lifeRule.h"
+#include "memoryPool.h"
+#include "regionIndex.h"
+
+// Interleaves the bits of x and y into one 64-bit key, x in the even bits and y in the odd ones. The
+// sign bits are flipped first so that the keys sort in the same order as the signed coordinates.
+inline uint64_t spreadBits(uint32_t v)
+{
+    uint64_t b = v;
+    b = (b | b << 16) & 0x0000FFFF0000FFFFull;
+    b = (b | b << 8) & 0x00FF00FF00FF00FFull;
+    b = (b | b << 4) & 0x0F0F0F0F0F0F0F0Full;
+    b = (b | b << 2) & 0x3333333333333333ull;
+    b = (b | b << 1) & 0x5555555555555555ull;
+    return b;
+}
+
+inline uint32_t packBits(uint64_t b)
+{
+    b &= 0x5555555555555555ull;
+    b = (b | b >> 1) & 0x3333333333333333ull;
+    b = (b | b >> 2) & 0x0F0F0F0F0F0F0F0Full;
+    b = (b | b >> 4) & 0x00FF00FF00FF00FFull;
+    b = (b | b >> 8) & 0x0000FFFF0000FFFFull;
+    b = (b | b >> 16) & 0x00000000FFFFFFFFull;
+    return (uint32_t)b;
+}
+
+inline uint64_t mortonKey(int x, int y)
+{
+    return spreadBits((uint32_t)x ^ 0x80000000u) | spreadBits((uint32_t)y ^ 0x80000000u) << 1;
+}
+
+inline cellCoord mortonCell(uint64_t key)
+{
+    return { (int)(packBits(key) ^ 0x80000000u), (int)(packBits(key >> 1) ^ 0x80000000u) };
+}
+
+// The live cells of a two-state pattern as one sorted array of Morton keys. Keeping x and y in a
+// single word means they cannot get out of step, cells close on the plane are mostly close in memory,
+// and the next generation comes out of a sort and a single merge already in order.
+class cellStore
+{
+public:
+    // Forward iterator over the cells in key order, unpacking each key as it goes
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = cellCoord;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const cellCoord*;
+        using reference = cellCoord;
+
+        explicit const_iterator(const uint64_t* p = nullptr) : p(p) {}
+
+        cellCoord operator*() const { return mortonCell(*p); }
+        const_iterator& operator++() { ++p; return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; ++p; return old; }
+        bool operator==(const const_iterator& o) const { return p == o.p; }
+        bool operator!=(const const_iterator& o) const { return p != o.p; }
+
+    private:
+        const uint64_t* p;
+    };
+
+    // Replaces the cells with the pairs of X and Y. Duplicates are stored once.
+    void assign(const std::vector<int>& X, const std::vector<int>& Y);
+    void copyTo(std::vector<int>& X, std::vector<int>& Y) const;
+    void clear() { keys.clear(); }
+
+    size_t size() const { return keys.size(); }
+    bool empty() const { return keys.empty(); }
+    const_iterator begin() const { return const_iterator(keys.data()); }
+    const_iterator end() const { return const_iterator(keys.data() + keys.size()); }
+    const std::vector<uint64_t>& data() const { return keys; }
+
+    bool contains(int x, int y) const;
+
+    // Galloping search for a key at or after position 'hint', for callers that look up keys in
+    // ascending order. Returns the position of the first key not less than 'key' and leaves it in hint.
+    size_t seek(uint64_t key, size_t& hint) const;
+
+    // Calls f(x, y) for every cell in the region, in key order. The keys of a rectangle lie between
+    // those of its corners, and a key in that range but outside the rectangle is skipped over by
+    // seeking to the next key that is inside it, so runs of cells outside the region cost one search.
+    template <class F> void forEachIn(const cellRect& region, F f) const
+    {
+        uint64_t low = mortonKey(region.minX, region.minY), high = mortonKey(region.maxX, region.maxY);
+        size_t hint = 0;
+        size_t i = seek(low, hint);
+        while (i < keys.size() && keys[i] <= high) {
+            cellCoord c = mortonCell(keys[i]);
+            if (region.contains(c.x, c.y)) {
+                f(c.x, c.y);
+                i++;
+            }
+            else
+                i = seek(nextInside(keys[i], low, high), hint);
+        }
+    }
+
+    // Bounding box of the cells, false if there are none
+    bool bounds(int64_t& minX, int64_t& minY, int64_t& maxX, int64_t& maxY) const;
+
+    // Moves every cell by (-dx, -dy), wrapping in the int range
+    void shift(int64_t dx, int64_t dy);
+
+    // Replaces the cells with the next generation under a two-state rule
+    void advance(const lifeRule& rule);
+
+private:
+    // Smallest key above 'key' whose cell is in the rectangle with corner keys low and high
+    static uint64_t nextInside(uint64_t key, uint64_t low, uint64_t high);
+    uint64_t* sortKeys(uint64_t* v, uint64_t* spare, size_t n);
+    void sortInPlace();
+
+    std::vector<uint64_t> keys, next;
+    scratchArena scratch;    // Neighbour keys and sort buffers, reset after every generation
+};
+
+#endif
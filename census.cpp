@@ -0,0 +1,592 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   Object census. The live cells are kept in a hash table mapping each cell to the object it belongs
+   to, and every object keeps the list of its cells. Two cells are in the same object if a chain of
+   live cells joins them in which each is within two cells of the next on both axes.
+
+   A step changes few objects. A death touches the object that held the cell. A birth touches every
+   object with a cell within two of it. An object touched only by its own changes, with no other
+   object or other object's births near them, keeps its label when its new shape has been seen in one
+   piece before, which after one period is true of every phase of an oscillator or spaceship. The rest
+   are taken apart, and their surviving cells together with their births are grouped again with
+   union-find: every cell is joined with those of the twelve cells before it in its 5x5 neighbourhood
+   that are being relabelled. No other cell can be in a group with them, since an object untouched by
+   the changes had no cell within two of any of them. Objects nothing touched keep their labels, their
+   shape and the generation they last changed, and cost nothing.
+
+   The cell table hashes 4x4 blocks and keeps the cells of a block next to each other, so the 25
+   lookups around a birth fall on a few cache lines.
+
+   An object's shape is found by hashing its cells relative to its bounding box under each of the
+   eight rotations and reflections, each hash being a sum of mixed cells as in the cycle detector, and
+   keeping the smallest. The table of known objects is built once by running every phase of each known
+   oscillator and spaceship with calcState.
+*/
+
+// Headers
+#include <cstdint>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "census.h"
+#include "cellHash.h"
+#include "cellPairs.h"
+#include "calcState.h"
+
+
+// Twelve of the 24 neighbours within two cells: the ones before the cell in row order
+const int BEFORE[12][2] = {
+    { -2, -2 }, { -1, -2 }, { 0, -2 }, { 1, -2 }, { 2, -2 },
+    { -2, -1 }, { -1, -1 }, { 0, -1 }, { 1, -1 }, { 2, -1 },
+    { -2, 0 }, { -1, 0 }
+};
+
+
+// Known Life objects, as plaintext rows separated by '/'
+struct knownObject
+{
+    const char* name;
+    objectKind kind;
+    int period;
+    const char* rows;
+};
+
+const size_t MAX_CONNECTED = 1 << 16;    // Shapes remembered as connected before starting over
+
+const knownObject KNOWN[] = {
+    { "block", OBJECT_STILL, 1, "OO/OO" },
+    { "beehive", OBJECT_STILL, 1, ".OO./O..O/.OO." },
+    { "loaf", OBJECT_STILL, 1, ".OO./O..O/.O.O/..O." },
+    { "boat", OBJECT_STILL, 1, "OO./O.O/.O." },
+    { "tub", OBJECT_STILL, 1, ".O./O.O/.O." },
+    { "ship", OBJECT_STILL, 1, "OO./O.O/.OO" },
+    { "pond", OBJECT_STILL, 1, ".OO./O..O/O..O/.OO." },
+    { "long boat", OBJECT_STILL, 1, "OO../O.O./.O.O/..O." },
+    { "barge", OBJECT_STILL, 1, ".O../O.O./.O.O/..O." },
+    { "snake", OBJECT_STILL, 1, "OO.O/O.OO" },
+    { "aircraft carrier", OBJECT_STILL, 1, "OO../O..O/..OO" },
+    { "eater 1", OBJECT_STILL, 1, "OO../O.O./..O./..OO" },
+    { "mango", OBJECT_STILL, 1, ".OO../O..O./.O..O/..OO." },
+    { "bi-block", OBJECT_STILL, 1, "OO.OO/OO.OO" },
+    { "blinker", OBJECT_OSCILLATOR, 2, "OOO" },
+    { "toad", OBJECT_OSCILLATOR, 2, ".OOO/OOO." },
+    { "beacon", OBJECT_OSCILLATOR, 2, "OO../OO../..OO/..OO" },
+    { "pulsar", OBJECT_OSCILLATOR, 3, "..OOO...OOO../............./O....O.O....O/O....O.O....O/O....O.O....O/"
+        "..OOO...OOO../............./..OOO...OOO../O....O.O....O/O....O.O....O/O....O.O....O/............./..OOO...OOO.." },
+    { "pentadecathlon", OBJECT_OSCILLATOR, 15, "..O....O../OO.OOOO.OO/..O....O.." },
+    { "glider", OBJECT_SPACESHIP, 4, ".O./..O/OOO" },
+    { "lwss", OBJECT_SPACESHIP, 4, ".O..O/O..../O...O/OOOO." },
+    { "mwss", OBJECT_SPACESHIP, 4, "...O../.O...O/O...../O....O/OOOOO." },
+    { "hwss", OBJECT_SPACESHIP, 4, "...OO../.O....O/O....../O.....O/OOOOOO." }
+};
+const int KNOWN_COUNT = sizeof(KNOWN) / sizeof(KNOWN[0]);
+
+
+// Finalizer of splitmix64, spreading every input bit over the whole word
+static uint64_t mix(uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+
+// Shape hash of a set of packed cells, the same under rotation, reflection and translation
+static uint64_t shapeOf(const std::vector<uint64_t>& cells)
+{
+    if (cells.empty())
+        return 0;
+
+    int minX = unpackX(cells[0]), maxX = minX, minY = unpackY(cells[0]), maxY = minY;
+    for (uint64_t c : cells) {
+        minX = std::min(minX, unpackX(c));
+        maxX = std::max(maxX, unpackX(c));
+        minY = std::min(minY, unpackY(c));
+        maxY = std::max(maxY, unpackY(c));
+    }
+    int w = maxX - minX, h = maxY - minY;
+
+    // The eight images of (x, y) in the box, each already placed at the origin
+    uint64_t sums[8] = {};
+    for (uint64_t c : cells) {
+        int x = unpackX(c) - minX, y = unpackY(c) - minY;
+        sums[0] += mix(packCell(x, y));
+        sums[1] += mix(packCell(w - x, y));
+        sums[2] += mix(packCell(x, h - y));
+        sums[3] += mix(packCell(w - x, h - y));
+        sums[4] += mix(packCell(y, x));
+        sums[5] += mix(packCell(h - y, x));
+        sums[6] += mix(packCell(y, w - x));
+        sums[7] += mix(packCell(h - y, w - x));
+    }
+    return mix(*std::min_element(sums, sums + 8) + cells.size());
+}
+
+
+// Shapes of every phase of the known objects, sorted, with their index into KNOWN
+static const std::vector<std::pair<uint64_t, int>>& knownShapes()
+{
+    static const std::vector<std::pair<uint64_t, int>> table = [] {
+        std::vector<std::pair<uint64_t, int>> shapes;
+        for (int k = 0; k < KNOWN_COUNT; k++) {
+            std::vector<int> X, Y;
+            int x = 0, y = 0;
+            for (const char* p = KNOWN[k].rows; *p; p++) {
+                if (*p == '/') {
+                    x = 0;
+                    y--;
+                    continue;
+                }
+                if (*p == 'O') {
+                    X.push_back(x);
+                    Y.push_back(y);
+                }
+                x++;
+            }
+
+            for (int phase = 0; phase < KNOWN[k].period; phase++) {
+                std::vector<uint64_t> cells;
+                for (size_t i = 0; i < X.size(); i++)
+                    cells.push_back(packCell(X[i], Y[i]));
+                shapes.push_back(std::make_pair(shapeOf(cells), k));
+                calcState(X, Y);
+            }
+        }
+        std::sort(shapes.begin(), shapes.end());
+        return shapes;
+    }();
+    return table;
+}
+
+
+static int knownIndex(uint64_t shape)
+{
+    const std::vector<std::pair<uint64_t, int>>& table = knownShapes();
+    std::vector<std::pair<uint64_t, int>>::const_iterator it = std::lower_bound(table.begin(), table.end(), std::make_pair(shape, -1));
+    return it != table.end() && it->first == shape ? it->second : -1;
+}
+
+
+const char* kindName(objectKind kind)
+{
+    switch (kind) {
+    case OBJECT_STILL:
+        return "still life";
+    case OBJECT_OSCILLATOR:
+        return "oscillator";
+    case OBJECT_SPACESHIP:
+        return "spaceship";
+    default:
+        return "unknown";
+    }
+}
+
+
+// Absolute cell as a packed key. Coordinates wrap at 2^32, like the engines' local ones.
+static inline uint64_t cellKey(int x, int y, int64_t originX, int64_t originY)
+{
+    return packCell((int)(uint32_t)(x + originX), (int)(uint32_t)(y + originY));
+}
+
+
+static inline uint64_t offsetKey(uint64_t key, int dx, int dy)
+{
+    return packCell((int)((uint32_t)(key >> 32) + dx), (int)((uint32_t)key + dy));
+}
+
+
+objectCensus::cellMap::cellMap() : mask(0), count(0), shift(60)
+{
+    reset(0);
+}
+
+
+void objectCensus::cellMap::reset(size_t expected)
+{
+    // At most half full
+    size_t size = 16;
+    while (size < 2 * expected)
+        size <<= 1;
+
+    keys.assign(size, 0);
+    vals.assign(size, -1);
+    mask = size - 1;
+    count = 0;
+    for (shift = 64; (size_t)1 << (64 - shift) < size; shift--)
+        ;
+}
+
+
+size_t objectCensus::cellMap::slotFor(uint64_t key) const
+{
+    size_t i = home(key);
+    while (vals[i] >= 0 && keys[i] != key)
+        i = (i + 1) & mask;
+    return i;
+}
+
+
+int objectCensus::cellMap::find(uint64_t key) const
+{
+    return vals[slotFor(key)];
+}
+
+
+void objectCensus::cellMap::set(uint64_t key, int value)
+{
+    size_t i = slotFor(key);
+    if (vals[i] < 0) {
+        if (2 * (count + 1) > keys.size()) {
+            grow();
+            i = slotFor(key);
+        }
+        keys[i] = key;
+        count++;
+    }
+    vals[i] = value;
+}
+
+
+// Removes the key and moves later keys of the same probe run back into the gap, so that no
+// tombstones are needed
+void objectCensus::cellMap::erase(uint64_t key)
+{
+    size_t i = slotFor(key);
+    if (vals[i] < 0)
+        return;
+
+    vals[i] = -1;
+    count--;
+    for (size_t j = (i + 1) & mask; vals[j] >= 0; j = (j + 1) & mask) {
+        size_t h = home(keys[j]);
+
+        // Move j into the gap unless its home lies cyclically in (i, j]
+        bool stays = i <= j ? (i < h && h <= j) : (i < h || h <= j);
+        if (stays)
+            continue;
+        keys[i] = keys[j];
+        vals[i] = vals[j];
+        vals[j] = -1;
+        i = j;
+    }
+}
+
+
+void objectCensus::cellMap::grow()
+{
+    std::vector<uint64_t> oldKeys;
+    std::vector<int> oldVals;
+    oldKeys.swap(keys);
+    oldVals.swap(vals);
+
+    keys.assign(oldKeys.size() * 2, 0);
+    vals.assign(oldKeys.size() * 2, -1);
+    mask = keys.size() - 1;
+    shift--;
+    for (size_t i = 0; i < oldKeys.size(); i++) {
+        if (oldVals[i] >= 0) {
+            size_t j = slotFor(oldKeys[i]);
+            keys[j] = oldKeys[i];
+            vals[j] = oldVals[i];
+        }
+    }
+}
+
+
+objectCensus::objectCensus() : live(0), generations(0), lastRelabelled(0)
+{
+}
+
+
+int objectCensus::addObject()
+{
+    int index;
+    if (!freeObjects.empty()) {
+        index = freeObjects.back();
+        freeObjects.pop_back();
+    }
+    else {
+        index = (int)objects.size();
+        objects.push_back(object());
+    }
+
+    object& o = objects[index];
+    o.cells.clear();
+    o.shape = 0;
+    o.since = generations;
+    o.known = -1;
+    o.used = true;
+    o.dirty = false;
+    o.alone = true;
+    live++;
+    return index;
+}
+
+
+void objectCensus::removeObject(int index)
+{
+    objects[index].used = false;
+    objects[index].cells.clear();
+    freeObjects.push_back(index);
+    live--;
+}
+
+
+int objectCensus::root(int i)
+{
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];    // Path halving
+        i = parent[i];
+    }
+    return i;
+}
+
+
+void objectCensus::reset(const std::vector<int>& X, const std::vector<int>& Y, int64_t originX, int64_t originY)
+{
+    cellPairs given(X, Y);
+
+    cells.reset(given.size());
+    objects.clear();
+    freeObjects.clear();
+    live = 0;
+    generations = 0;
+
+    pending.clear();
+    for (cellCoord c : given)
+        pending.push_back(cellKey(c.x, c.y, originX, originY));
+    relabel();
+}
+
+
+void objectCensus::update(const std::vector<int>& bornX, const std::vector<int>& bornY,
+    const std::vector<int>& diedX, const std::vector<int>& diedY, int64_t originX, int64_t originY)
+{
+    born.clear();
+    died.clear();
+    for (cellCoord c : cellPairs(bornX, bornY))
+        born.push_back(cellKey(c.x, c.y, originX, originY));
+    for (cellCoord c : cellPairs(diedX, diedY))
+        died.push_back(cellKey(c.x, c.y, originX, originY));
+    advance();
+}
+
+
+void objectCensus::update(const std::vector<int>& X, const std::vector<int>& Y, int64_t originX, int64_t originY)
+{
+    cellPairs given(X, Y);
+
+    // The new cells that the census does not hold are births, and the cells it holds that are not
+    // among the new ones are deaths
+    born.clear();
+    died.clear();
+    scratch.reset(given.size());
+    for (cellCoord c : given) {
+        uint64_t key = cellKey(c.x, c.y, originX, originY);
+        scratch.set(key, 0);
+        if (cells.find(key) < 0)
+            born.push_back(key);
+    }
+    cells.forEach([&](uint64_t key, int) {
+        if (scratch.find(key) < 0)
+            died.push_back(key);
+    });
+    advance();
+}
+
+
+void objectCensus::update(const lifeEngine& engine)
+{
+    int64_t originX, originY;
+    engine.origin(originX, originY);
+
+    if (engine.changes(bornX, bornY, diedX, diedY))
+        update(bornX, bornY, diedX, diedY, originX, originY);
+    else {
+        engine.store(bornX, bornY);
+        update(bornX, bornY, originX, originY);
+    }
+}
+
+
+void objectCensus::advance()
+{
+    const int ORPHAN = 0, SHARED = 1;    // Owners of births near no object and near several
+
+    generations++;
+    dirty.clear();
+    pending.clear();
+
+    auto touch = [&](int index, bool alone) {
+        object& o = objects[index];
+        if (!o.dirty) {
+            o.dirty = true;
+            o.alone = true;
+            o.added.clear();
+            dirty.push_back(index);
+        }
+        o.alone &= alone;
+    };
+
+    for (uint64_t key : died) {
+        int index = cells.find(key);
+        if (index >= 0) {
+            touch(index, true);
+            cells.erase(key);
+        }
+    }
+
+    // Every birth is owned by the one object with a cell within two of it, if there is just one.
+    // Objects near a birth they share are relabelled.
+    owners.reset(born.size());
+    for (uint64_t key : born) {
+        int owner = ORPHAN;
+        for (int dy = -2; dy <= 2; dy++) {
+            for (int dx = -2; dx <= 2; dx++) {
+                int index = cells.find(offsetKey(key, dx, dy));
+                if (index < 0 || index + 2 == owner)
+                    continue;
+                if (owner != ORPHAN) {
+                    if (owner != SHARED)
+                        touch(owner - 2, false);
+                    touch(index, false);
+                    owner = SHARED;
+                }
+                else
+                    owner = index + 2;
+            }
+        }
+
+        if (owner >= 2) {
+            touch(owner - 2, true);
+            objects[owner - 2].added.push_back(key);
+        }
+        else
+            pending.push_back(key);
+        owners.set(key, owner);
+    }
+
+    // So are objects whose births are within two of births with another owner
+    for (uint64_t key : born) {
+        int owner = owners.find(key);
+        for (int k = 0; k < 12; k++) {
+            int other = owners.find(offsetKey(key, BEFORE[k][0], BEFORE[k][1]));
+            if (other < 0 || other == owner)
+                continue;
+            if (owner >= 2)
+                touch(owner - 2, false);
+            if (other >= 2)
+                touch(other - 2, false);
+        }
+    }
+
+    // An object changed only by its own births and deaths is still one object if its new shape is one
+    // already seen in one piece, as is every phase of an oscillator after its first period. Others
+    // are taken apart and their cells relabelled with the births.
+    for (int index : dirty) {
+        object& o = objects[index];
+        size_t kept = 0;
+        for (uint64_t key : o.cells)
+            if (cells.find(key) == index)
+                o.cells[kept++] = key;
+        o.cells.resize(kept);
+        o.cells.insert(o.cells.end(), o.added.begin(), o.added.end());
+
+        uint64_t shape = o.alone && !o.cells.empty() ? shapeOf(o.cells) : 0;
+        if (shape && connected.find(shape) >= 0) {
+            for (uint64_t key : o.added)
+                cells.set(key, index);
+            o.shape = shape;
+            o.known = knownIndex(shape);
+            o.since = generations;
+            o.dirty = false;
+        }
+        else {
+            pending.insert(pending.end(), o.cells.begin(), o.cells.end());
+            removeObject(index);
+        }
+    }
+    relabel();
+}
+
+
+// Groups the cells in 'pending' into new objects
+void objectCensus::relabel()
+{
+    size_t n = pending.size();
+    lastRelabelled = n;
+
+    scratch.reset(n);
+    parent.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        scratch.set(pending[i], (int)i);
+        parent[i] = (int)i;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        for (int k = 0; k < 12; k++) {
+            int j = scratch.find(offsetKey(pending[i], BEFORE[k][0], BEFORE[k][1]));
+            if (j < 0)
+                continue;
+            int a = root((int)i), b = root(j);
+            if (a != b)
+                parent[std::max(a, b)] = std::min(a, b);
+        }
+    }
+
+    group.assign(n, -1);
+    made.clear();
+    for (size_t i = 0; i < n; i++) {
+        int r = root((int)i);
+        if (group[r] < 0) {
+            group[r] = addObject();
+            made.push_back(group[r]);
+        }
+        objects[group[r]].cells.push_back(pending[i]);
+        cells.set(pending[i], group[r]);
+    }
+
+    // The shapes found in one piece, so later phases of the same objects can skip relabelling
+    if (connected.size() > MAX_CONNECTED)
+        connected.reset(0);
+    for (int index : made) {
+        object& o = objects[index];
+        o.shape = shapeOf(o.cells);
+        o.known = knownIndex(o.shape);
+        connected.set(o.shape, 0);
+    }
+}
+
+
+std::vector<censusEntry> objectCensus::tally() const
+{
+    // Every phase of a known object is counted under its name; unknown shapes apart
+    std::map<std::pair<uint64_t, int>, censusEntry> shapes;
+    for (const object& o : objects) {
+        if (!o.used)
+            continue;
+
+        objectKind kind = o.known >= 0 ? KNOWN[o.known].kind : (generations > o.since ? OBJECT_STILL : OBJECT_UNKNOWN);
+        std::pair<uint64_t, int> key = o.known >= 0 ? std::make_pair((uint64_t)o.known, -1) : std::make_pair(o.shape, (int)kind);
+        censusEntry& entry = shapes[key];
+        if (entry.count++ == 0) {
+            entry.name = o.known >= 0 ? KNOWN[o.known].name : "unnamed " + std::to_string(o.cells.size());
+            entry.kind = kind;
+            entry.shape = o.shape;
+            entry.population = o.cells.size();
+        }
+    }
+
+    std::vector<censusEntry> list;
+    for (const auto& s : shapes)
+        list.push_back(s.second);
+    std::sort(list.begin(), list.end(), [](const censusEntry& a, const censusEntry& b) {
+        return a.count != b.count ? a.count > b.count : a.name < b.name;
+    });
+    return list;
+}
@@ -0,0 +1,138 @@
+#ifndef CENSUS_H
+#define CENSUS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "lifeEngine.h"
+
+enum objectKind
+{
+    OBJECT_UNKNOWN,       // Changed in the last generation and not a known shape
+    OBJECT_STILL,         // A known still life, or any object unchanged for a generation
+    OBJECT_OSCILLATOR,    // A phase of a known oscillator
+    OBJECT_SPACESHIP      // A phase of a known spaceship
+};
+
+const char* kindName(objectKind kind);
+
+// One line of the census: how many objects of a shape there are, in any phase for a known object
+struct censusEntry
+{
+    std::string name;     // Known name, or "unnamed" followed by the population
+    objectKind kind;
+    uint64_t shape;       // Of the first one met
+    size_t population;    // Of the first one met
+    size_t count;
+};
+
+// Keeps the live cells split into objects from one generation to the next. Cells belong to the same
+// object when they are linked by a chain of cells at most two apart on each axis, so that a toad or
+// a beacon stays one object in every phase. Each object has a shape hash that is the same under all
+// rotations and reflections and does not depend on its position; shapes in the table of known Life
+// objects are named.
+//
+// update() takes the cells born and died in one step and relabels only the objects those cells
+// touch, with union-find over their cells, so objects that did not change cost nothing. Coordinates
+// are absolute: the engine's local cells plus its origin.
+class objectCensus
+{
+public:
+    objectCensus();
+
+    // Labels every cell from scratch
+    void reset(const std::vector<int>& X, const std::vector<int>& Y, int64_t originX = 0, int64_t originY = 0);
+
+    // Advances the census by one generation given its births and deaths
+    void update(const std::vector<int>& bornX, const std::vector<int>& bornY,
+        const std::vector<int>& diedX, const std::vector<int>& diedY, int64_t originX = 0, int64_t originY = 0);
+
+    // Advances the census by one generation given all of its cells, finding the changes by comparing
+    // them with the cells it holds
+    void update(const std::vector<int>& X, const std::vector<int>& Y, int64_t originX = 0, int64_t originY = 0);
+
+    // Advances the census by the engine's last step, from the engine's changes if it keeps them
+    void update(const lifeEngine& engine);
+
+    size_t objectCount() const { return live; }
+    size_t population() const { return cells.size(); }
+    uint64_t generation() const { return generations; }
+    size_t relabelled() const { return lastRelabelled; }    // Cells relabelled by the last update
+
+    // One entry per distinct shape, the most common first
+    std::vector<censusEntry> tally() const;
+
+private:
+    // Open addressing table from packed cells to object numbers, with deletion
+    class cellMap
+    {
+    public:
+        cellMap();
+        void reset(size_t expected);
+        int find(uint64_t key) const;       // -1 if absent
+        void set(uint64_t key, int value);
+        void erase(uint64_t key);
+        size_t size() const { return count; }
+        template <class F> void forEach(F f) const
+        {
+            for (size_t i = 0; i < keys.size(); i++)
+                if (vals[i] >= 0)
+                    f(keys[i], vals[i]);
+        }
+
+    private:
+        // The 4x4 block of a cell is hashed and its 16 cells follow each other, so the cells around
+        // one share a few cache lines
+        size_t home(uint64_t key) const
+        {
+            uint64_t block = (key >> 2) & 0x3FFFFFFF3FFFFFFFull;
+            return ((size_t)((block * 0x9E3779B97F4A7C15ull) >> shift) + ((key >> 30 & 12) | (key & 3))) & mask;
+        }
+        size_t slotFor(uint64_t key) const;
+        void grow();
+
+        std::vector<uint64_t> keys;
+        std::vector<int> vals;
+        size_t mask;
+        size_t count;
+        int shift;
+    };
+
+    struct object
+    {
+        std::vector<uint64_t> cells;
+        uint64_t shape;
+        uint64_t since;       // Generation it last changed
+        int known;            // Index into the table of known shapes, -1 if none
+        bool used;
+        bool dirty;           // Touched by a change in the current update
+        bool alone;           // Touched only by changes no other object is near
+        std::vector<uint64_t> added;    // Births it owns in the current update
+    };
+
+    void advance();    // Applies born and died
+    void relabel();
+    int addObject();
+    void removeObject(int index);
+    int root(int i);
+
+    cellMap cells;                  // Live cell -> object
+    cellMap scratch;                // Cell -> index into 'pending' while relabelling
+    cellMap owners;                 // Birth -> object within two of it, plus 2, or ORPHAN or SHARED
+    cellMap connected;              // Shapes found in one piece
+    std::vector<object> objects;
+    std::vector<int> freeObjects;
+    std::vector<int> dirty;         // Objects touched by the current update
+    std::vector<uint64_t> pending;  // Cells to relabel
+    std::vector<int> parent;        // Union-find over 'pending'
+    std::vector<int> group;
+    std::vector<int> made;
+    std::vector<uint64_t> born, died;
+    std::vector<int> bornX, bornY, diedX, diedY;
+    size_t live;
+    uint64_t generations;
+    size_t lastRelabelled;
+};
+
+#endif
@@ -0,0 +1,342 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   Binary checkpoints. All integers are little endian.
+
+      header     "GOLCKPT" 0, version (u32), header size (u32), generation (u64), origin x, y (i64),
+                 topology (u32), width, height (i32), rule length (u32), cell count (u64),
+                 block count (u64)
+      rule       the rule name, without a terminator
+      offsets    one u64 per block, the byte offset of the block from the start of the block data
+      blocks     the cells sorted by y and then x, BLOCK_CELLS per block
+      checksum   u64 over every byte before it
+
+   Each block is decoded on its own: its first cell is stored as zigzag varints of y and x, and every
+   other cell as a varint of the rise in y followed by, on the same row, a varint of the gap to the
+   previous x minus one, or on a new row a zigzag varint of x. A dense row costs about one byte per
+   cell and a sparse pattern a few bytes. Because the offsets say where every block starts and the
+   header says how many cells precede it, a restore can decode all blocks at once straight from the
+   mapping into X and Y.
+
+   The checksum mixes eight bytes at a time, so verifying a large file costs little more than
+   reading it; it catches torn and truncated files rather than deliberate tampering.
+*/
+
+// Headers
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "checkpoint.h"
+#include "cellPairs.h"
+#include "mappedFile.h"
+#include "threadPool.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+
+const char MAGIC[8] = { 'G', 'O', 'L', 'C', 'K', 'P', 'T', 0 };
+const uint32_t VERSION = 1;
+const uint32_t HEADER_SIZE = 80;
+const size_t BLOCK_CELLS = 1 << 16;
+
+
+static void putU32(std::vector<uint8_t>& out, uint32_t v)
+{
+    for (int i = 0; i < 4; i++)
+        out.push_back((uint8_t)(v >> (8 * i)));
+}
+
+
+static void putU64(std::vector<uint8_t>& out, uint64_t v)
+{
+    for (int i = 0; i < 8; i++)
+        out.push_back((uint8_t)(v >> (8 * i)));
+}
+
+
+static uint32_t getU32(const uint8_t* p)
+{
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++)
+        v |= (uint32_t)p[i] << (8 * i);
+    return v;
+}
+
+
+static uint64_t getU64(const uint8_t* p)
+{
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++)
+        v |= (uint64_t)p[i] << (8 * i);
+    return v;
+}
+
+
+static void putVarint(std::vector<uint8_t>& out, uint64_t v)
+{
+    while (v >= 0x80) {
+        out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+}
+
+
+// Returns false if the varint runs past end
+static bool getVarint(const uint8_t*& p, const uint8_t* end, uint64_t& v)
+{
+    v = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        uint8_t b = *p++;
+        v |= (uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80))
+            return true;
+    }
+    return false;
+}
+
+
+// Small negative and positive values both become small unsigned ones
+static uint64_t zigzag(int v)
+{
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+
+static int unzigzag(uint64_t v)
+{
+    uint32_t u = (uint32_t)v;
+    return (int)((u >> 1) ^ (0u - (u & 1)));
+}
+
+
+static uint64_t checksum(const uint8_t* p, size_t n)
+{
+    const uint64_t PRIME = 0x9E3779B97F4A7C15ull;
+    uint64_t h = n * PRIME;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t w;
+        memcpy(&w, p + i, 8);
+        h = (h ^ w) * PRIME;
+        h ^= h >> 29;
+    }
+    for (; i < n; i++)
+        h = (h ^ p[i]) * PRIME;
+    return h ^ (h >> 32);
+}
+
+
+bool saveCheckpoint(const std::string& file, checkpointData& state)
+{
+    // Sort by y then x as one key, flipping the sign bits so the order matches the signed values
+    std::vector<uint64_t> keys;
+    for (cellCoord c : cellPairs(state.X, state.Y))
+        keys.push_back((uint64_t)((uint32_t)c.y ^ 0x80000000u) << 32 | ((uint32_t)c.x ^ 0x80000000u));
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    size_t n = keys.size();
+    for (size_t i = 0; i < n; i++) {
+        state.X[i] = (int)((uint32_t)keys[i] ^ 0x80000000u);
+        state.Y[i] = (int)((uint32_t)(keys[i] >> 32) ^ 0x80000000u);
+    }
+    state.X.resize(n);
+    state.Y.resize(n);
+
+    size_t blocks = (n + BLOCK_CELLS - 1) / BLOCK_CELLS;
+    std::vector<uint8_t> out;
+    out.reserve(HEADER_SIZE + state.rule.size() + 8 * blocks + 2 * n + 16);
+
+    out.insert(out.end(), MAGIC, MAGIC + 8);
+    putU32(out, VERSION);
+    putU32(out, HEADER_SIZE);
+    putU64(out, state.generation);
+    putU64(out, (uint64_t)state.originX);
+    putU64(out, (uint64_t)state.originY);
+    putU32(out, (uint32_t)state.topo);
+    putU32(out, (uint32_t)state.width);
+    putU32(out, (uint32_t)state.height);
+    putU32(out, (uint32_t)state.rule.size());
+    putU64(out, n);
+    putU64(out, blocks);
+    out.resize(HEADER_SIZE, 0);
+    out.insert(out.end(), state.rule.begin(), state.rule.end());
+
+    // Offsets are filled in once the blocks are written
+    size_t table = out.size();
+    out.resize(table + 8 * blocks, 0);
+    size_t base = out.size();
+
+    for (size_t b = 0; b < blocks; b++) {
+        uint64_t offset = out.size() - base;
+        for (int i = 0; i < 8; i++)
+            out[table + 8 * b + i] = (uint8_t)(offset >> (8 * i));
+
+        size_t first = b * BLOCK_CELLS, last = std::min(n, first + BLOCK_CELLS);
+        putVarint(out, zigzag(state.Y[first]));
+        putVarint(out, zigzag(state.X[first]));
+        for (size_t i = first + 1; i < last; i++) {
+            uint64_t rise = (uint64_t)((int64_t)state.Y[i] - state.Y[i - 1]);
+            putVarint(out, rise);
+            if (rise == 0)
+                putVarint(out, (uint64_t)((int64_t)state.X[i] - state.X[i - 1] - 1));
+            else
+                putVarint(out, zigzag(state.X[i]));
+        }
+    }
+    putU64(out, checksum(out.data(), out.size()));
+
+    std::string temp = file + ".tmp";
+    FILE* f = fopen(temp.c_str(), "wb");
+    if (!f)
+        return false;
+    bool ok = fwrite(out.data(), 1, out.size(), f) == out.size();
+    ok = fclose(f) == 0 && ok;
+    if (!ok) {
+        std::remove(temp.c_str());
+        return false;
+    }
+
+    // rename does not replace an existing file on Windows, and removing it first would leave no
+    // checkpoint at all if the process died in between
+#ifdef _WIN32
+    ok = MoveFileExA(temp.c_str(), file.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    ok = std::rename(temp.c_str(), file.c_str()) == 0;
+#endif
+    if (!ok)
+        std::remove(temp.c_str());
+    return ok;
+}
+
+
+// Decodes one block of 'count' cells into X and Y. Returns false if it is malformed.
+static bool decodeBlock(const uint8_t* p, const uint8_t* end, size_t count, int* X, int* Y)
+{
+    uint64_t y, x;
+    if (!getVarint(p, end, y) || !getVarint(p, end, x))
+        return false;
+    Y[0] = unzigzag(y);
+    X[0] = unzigzag(x);
+
+    for (size_t i = 1; i < count; i++) {
+        uint64_t rise, v;
+        if (!getVarint(p, end, rise) || !getVarint(p, end, v))
+            return false;
+        if (rise == 0) {
+            Y[i] = Y[i - 1];
+            X[i] = (int)((uint32_t)X[i - 1] + (uint32_t)v + 1);
+        }
+        else {
+            Y[i] = (int)((uint32_t)Y[i - 1] + (uint32_t)rise);
+            X[i] = unzigzag(v);
+        }
+    }
+    return true;
+}
+
+
+bool loadCheckpoint(const std::string& file, checkpointData& state, int threads)
+{
+    mappedFile map;
+    if (!map.open(file)) {
+        std::cout << "ERROR: Could not open checkpoint " << file << "\n";
+        return false;
+    }
+
+    const uint8_t* data = (const uint8_t*)map.data();
+    size_t size = map.size();
+    if (size < HEADER_SIZE + 8 || memcmp(data, MAGIC, 8) != 0) {
+        std::cout << "ERROR: " << file << " is not a checkpoint.\n";
+        return false;
+    }
+    if (getU32(data + 8) != VERSION) {
+        std::cout << "ERROR: " << file << " is checkpoint version " << getU32(data + 8) << ", this program reads version " << VERSION << ".\n";
+        return false;
+    }
+    if (getU64(data + size - 8) != checksum(data, size - 8)) {
+        std::cout << "ERROR: Checkpoint " << file << " is damaged.\n";
+        return false;
+    }
+
+    uint32_t headerSize = getU32(data + 12);
+    state.generation = getU64(data + 16);
+    state.originX = (int64_t)getU64(data + 24);
+    state.originY = (int64_t)getU64(data + 32);
+    state.topo = (topology)getU32(data + 40);
+    state.width = (int)getU32(data + 44);
+    state.height = (int)getU32(data + 48);
+    uint32_t ruleLength = getU32(data + 52);
+    uint64_t n = getU64(data + 56);
+    uint64_t blocks = getU64(data + 64);
+
+    if (headerSize < HEADER_SIZE || blocks != (n + BLOCK_CELLS - 1) / BLOCK_CELLS
+        || (uint64_t)headerSize + ruleLength + 8 * blocks > size - 8) {
+        std::cout << "ERROR: Checkpoint " << file << " is damaged.\n";
+        return false;
+    }
+    const uint8_t* end = data + size - 8;
+    const uint8_t* table = data + headerSize + ruleLength;
+    const uint8_t* base = table + 8 * blocks;
+    state.rule.assign((const char*)data + headerSize, ruleLength);
+
+    state.X.resize(n);
+    state.Y.resize(n);
+    std::atomic<bool> ok(true);
+    threadPool pool(std::max(1, threads));
+    pool.run(blocks, [&](size_t b) {
+        uint64_t offset = getU64(table + 8 * b);
+        size_t first = b * BLOCK_CELLS, count = std::min<size_t>(n - first, BLOCK_CELLS);
+        if (offset > (uint64_t)(end - base) || !decodeBlock(base + offset, end, count, &state.X[first], &state.Y[first]))
+            ok = false;
+    });
+
+    if (!ok) {
+        std::cout << "ERROR: Checkpoint " << file << " is damaged.\n";
+        return false;
+    }
+    return true;
+}
+
+
+bool checkpointWriter::submit(checkpointData& state)
+{
+    if (writing)
+        return false;
+    if (worker.joinable())
+        worker.join();
+
+    pending.generation = state.generation;
+    pending.rule = state.rule;
+    pending.topo = state.topo;
+    pending.width = state.width;
+    pending.height = state.height;
+    pending.originX = state.originX;
+    pending.originY = state.originY;
+    pending.X.swap(state.X);
+    pending.Y.swap(state.Y);
+
+    writing = true;
+    worker = std::thread([this]() {
+        if (!saveCheckpoint(file, pending))
+            failures++;
+        writing = false;
+    });
+    return true;
+}
+
+
+void checkpointWriter::wait()
+{
+    if (worker.joinable())
+        worker.join();
+}
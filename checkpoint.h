@@ -0,0 +1,55 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include "boundedEngine.h"
+
+// Everything needed to resume a run. The cells are local coordinates around the origin. Under a
+// Generations rule only the live cells are kept; dying cells are dead when the run resumes.
+struct checkpointData
+{
+    uint64_t generation = 0;
+    std::string rule;
+    topology topo = TOPOLOGY_PLANE;
+    int width = 0, height = 0;
+    int64_t originX = 0, originY = 0;
+    std::vector<int> X, Y;
+};
+
+// Writes the state as a binary checkpoint, sorting the cells of 'state' in the process. The file is
+// written under a temporary name and renamed into place, so a crash part way leaves the previous
+// checkpoint intact. Returns false if it cannot be written.
+bool saveCheckpoint(const std::string& file, checkpointData& state);
+
+// Reads a checkpoint written by saveCheckpoint through a memory mapping, decoding its blocks on the
+// given number of threads. Returns false, after printing why, if the file is missing, of another
+// version, or damaged.
+bool loadCheckpoint(const std::string& file, checkpointData& state, int threads = 1);
+
+// Writes checkpoints on a background thread so the simulation never waits for the disk. submit hands
+// over a state, taking its cells, and returns false without taking anything while the previous
+// checkpoint is still being written.
+class checkpointWriter
+{
+public:
+    explicit checkpointWriter(const std::string& file) : file(file), writing(false), failures(0) {}
+    ~checkpointWriter() { wait(); }
+
+    bool submit(checkpointData& state);
+    void wait();                          // Until the checkpoint being written is on disk
+    bool busy() const { return writing; }
+    size_t failed() const { return failures; }
+
+private:
+    std::string file;
+    checkpointData pending;
+    std::thread worker;
+    std::atomic<bool> writing;
+    std::atomic<size_t> failures;
+};
+
+#endif
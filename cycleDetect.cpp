@@ -0,0 +1,308 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   Cycle detection for the game loop, replacing the old element by element comparison with the
+   previous generation. The live set is hashed as the sum of A^x B^y over its cells, modulo the prime
+   2^61 - 1. A sum does not depend on the order of the cells, and a birth or a death adds or takes
+   away one term, so the hash follows the changes of a step. Moving every cell by (dx, dy) multiplies
+   the sum by A^dx B^dy, so the hash relative to the bounding box is the sum times A^-minX B^-minY,
+   and a spaceship hashes the same after it has moved. Hash tables of the live cells per column and
+   per row hold the power of A or B for each coordinate and give the bounding box: births widen it,
+   and when a column or row on its edge empties the box is found again from the tables. Emptied lines
+   keep their power until then, so the cells of an oscillator coming and going cost no powers.
+
+   Each generation's relative hash goes into a map from hash to the latest generation that had it, and
+   entries older than 'depth' generations are dropped as the ring of signatures wraps, so a generation
+   without a hit costs one lookup whatever the depth. On a hit, every generation in the ring with the
+   same hash, population and box size is a candidate, and each is checked exactly: the older generation
+   is rebuilt from the current cells by undoing the logged births and deaths of the generations since,
+   and compared cell by cell with the current one moved back by the displacement. Only true repeats are
+   reported, and the check runs about once per run.
+
+   Given whole generations, the detector finds the changes itself by comparing the cells with those
+   of the previous generation in a hash table, which costs a pass over the cells.
+*/
+
+// Headers
+#include <climits>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <unordered_set>
+#include "cycleDetect.h"
+#include "cellPairs.h"
+
+
+// Modulus of the hash and the bases for x and y
+const uint64_t HASH_PRIME = (1ull << 61) - 1;
+const uint64_t BASE_X = 0x1A2B3C4D5E6F708ull % HASH_PRIME;
+const uint64_t BASE_Y = 0x0F1E2D3C4B5A697ull % HASH_PRIME;
+
+
+// Product modulo 2^61 - 1 of two reduced numbers. The operands are split at bit 31 so that no
+// partial product overflows, and 2^61 = 1 folds the high parts back in.
+static uint64_t mulMod(uint64_t a, uint64_t b)
+{
+    const uint64_t LOW31 = (1ull << 31) - 1, LOW30 = (1ull << 30) - 1;
+    uint64_t aHi = a >> 31, aLo = a & LOW31, bHi = b >> 31, bLo = b & LOW31;
+    uint64_t mid = aHi * bLo + aLo * bHi;
+    uint64_t sum = 2 * aHi * bHi + (mid >> 30) + ((mid & LOW30) << 31) + aLo * bLo;
+
+    sum = (sum & HASH_PRIME) + (sum >> 61);
+    sum = (sum & HASH_PRIME) + (sum >> 61);
+    return sum >= HASH_PRIME ? sum - HASH_PRIME : sum;
+}
+
+
+// base^e for any integer e, using base^(p - 1) = 1
+static uint64_t powMod(uint64_t base, int64_t e)
+{
+    int64_t order = (int64_t)(HASH_PRIME - 1);
+    uint64_t k = (uint64_t)(((e % order) + order) % order);
+    uint64_t result = 1;
+    for (; k; k >>= 1) {
+        if (k & 1)
+            result = mulMod(result, base);
+        base = mulMod(base, base);
+    }
+    return result;
+}
+
+
+static uint64_t absoluteKey(int x, int y, int64_t originX, int64_t originY)
+{
+    return packCell((int)(uint32_t)(originX + x), (int)(uint32_t)(originY + y));
+}
+
+
+cycleDetector::cycleDetector(size_t depth) : depth(std::max<size_t>(depth, 1))
+{
+    clear();
+}
+
+
+void cycleDetector::clear()
+{
+    ring.assign(depth, signature());
+    bornLog.assign(depth, std::vector<uint64_t>());
+    diedLog.assign(depth, std::vector<uint64_t>());
+    seen.clear();
+    columns.clear();
+    rows.clear();
+    minX = maxX = minY = maxY = 0;
+    rescan = false;
+    absolute = 0;
+    population = 0;
+    previous.reset(0);
+    generation = 0;
+    foundPeriod = 0;
+    foundDx = foundDy = 0;
+}
+
+
+void cycleDetector::add(uint64_t key)
+{
+    int x = unpackX(key), y = unpackY(key);
+    // A power is never 0, so 0 marks a line that is new to the table
+    line& column = columns[x];
+    if (column.power == 0)
+        column.power = powMod(BASE_X, x);
+    column.count++;
+    line& row = rows[y];
+    if (row.power == 0)
+        row.power = powMod(BASE_Y, y);
+    row.count++;
+
+    absolute = (absolute + mulMod(column.power, row.power)) % HASH_PRIME;
+    if (population++ == 0) {
+        minX = maxX = x;
+        minY = maxY = y;
+    }
+    minX = std::min(minX, x);
+    maxX = std::max(maxX, x);
+    minY = std::min(minY, y);
+    maxY = std::max(maxY, y);
+}
+
+
+// Drops the empty lines of a table and widens [low, high] to the live ones
+void cycleDetector::prune(std::unordered_map<int, line>& lines, int& low, int& high)
+{
+    for (std::unordered_map<int, line>::iterator i = lines.begin(); i != lines.end();) {
+        if (i->second.count == 0)
+            i = lines.erase(i);
+        else {
+            low = std::min(low, i->first);
+            high = std::max(high, i->first);
+            ++i;
+        }
+    }
+}
+
+
+void cycleDetector::remove(uint64_t key)
+{
+    int x = unpackX(key), y = unpackY(key);
+    std::unordered_map<int, line>::iterator column = columns.find(x), row = rows.find(y);
+    if (column == columns.end() || row == rows.end() || column->second.count == 0 || row->second.count == 0)
+        return;
+
+    absolute = (absolute + HASH_PRIME - mulMod(column->second.power, row->second.power)) % HASH_PRIME;
+    population--;
+    if (--column->second.count == 0)
+        rescan |= x == minX || x == maxX;
+    if (--row->second.count == 0)
+        rescan |= y == minY || y == maxY;
+}
+
+
+bool cycleDetector::update(const std::vector<int>& X, const std::vector<int>& Y, int64_t originX, int64_t originY)
+{
+    cellPairs given(X, Y);
+
+    // The cells the last generation did not have are births, and those it had that are not among
+    // the new ones are deaths
+    born.clear();
+    died.clear();
+    cells.clear();
+    scratch.reset(given.size());
+    for (cellCoord c : given) {
+        uint64_t key = absoluteKey(c.x, c.y, originX, originY);
+        uint8_t& value = scratch.slot(key);
+        if (value)
+            continue;
+        value = 1;
+        cells.push_back(key);
+        if (!previous.get(key))
+            born.push_back(key);
+    }
+    for (size_t i = 0; i < previous.capacity(); i++)
+        if (previous.valueAt(i) && !scratch.get(previous.keyAt(i)))
+            died.push_back(previous.keyAt(i));
+    std::swap(previous, scratch);
+
+    return record([&](std::vector<uint64_t>& now) { now = cells; });
+}
+
+
+bool cycleDetector::update(const lifeEngine& engine)
+{
+    int64_t originX, originY;
+    engine.origin(originX, originY);
+
+    // The first generation has no changes to go by
+    if (generation == 0 || !engine.changes(bornX, bornY, diedX, diedY)) {
+        engine.store(bornX, bornY);
+        return update(bornX, bornY, originX, originY);
+    }
+
+    born.clear();
+    died.clear();
+    for (cellCoord c : cellPairs(bornX, bornY))
+        born.push_back(absoluteKey(c.x, c.y, originX, originY));
+    for (cellCoord c : cellPairs(diedX, diedY))
+        died.push_back(absoluteKey(c.x, c.y, originX, originY));
+
+    return record([&](std::vector<uint64_t>& now) {
+        std::vector<int> X, Y;
+        engine.store(X, Y);
+        now.clear();
+        for (cellCoord c : cellPairs(X, Y))
+            now.push_back(absoluteKey(c.x, c.y, originX, originY));
+    });
+}
+
+
+// Applies 'born' and 'died' as the next generation and looks its hash up. 'live' gives the current
+// cells, and is only called to check a candidate.
+bool cycleDetector::record(const std::function<void(std::vector<uint64_t>&)>& live)
+{
+    for (uint64_t key : died)
+        remove(key);
+    for (uint64_t key : born)
+        add(key);
+
+    // The lists are rebuilt by every update, so they can change places with the oldest log
+    size_t slot = generation % depth;
+    bornLog[slot].swap(born);
+    diedLog[slot].swap(died);
+
+    // An emptied edge is found again from the lines still live, and the empty lines are dropped
+    if (rescan) {
+        minX = minY = INT_MAX;
+        maxX = maxY = INT_MIN;
+        prune(columns, minX, maxX);
+        prune(rows, minY, maxY);
+    }
+    rescan = false;
+
+    signature now = {};
+    now.population = population;
+    if (population) {
+        now.minX = minX;
+        now.minY = minY;
+        now.width = (int64_t)maxX - minX;
+        now.height = (int64_t)maxY - minY;
+        now.hash = mulMod(absolute, mulMod(powMod(BASE_X, -now.minX), powMod(BASE_Y, -now.minY)));
+    }
+
+    // The generation leaving the ring is forgotten unless a later one has the same hash
+    if (generation >= depth) {
+        std::unordered_map<uint64_t, uint64_t>::iterator gone = seen.find(ring[slot].hash);
+        if (gone != seen.end() && gone->second == generation - depth)
+            seen.erase(gone);
+    }
+
+    // A hit is checked against every stored generation with the same hash, most recent first, so a
+    // collision cannot hide a true repeat further back
+    bool found = false;
+    if (seen.count(now.hash)) {
+        std::vector<uint64_t> current;
+        size_t stored = (size_t)std::min<uint64_t>(generation, depth);
+        for (size_t p = 1; p <= stored && !found; p++) {
+            const signature& old = ring[(generation - p) % depth];
+            if (old.hash != now.hash || old.population != now.population || old.width != now.width || old.height != now.height)
+                continue;
+            if (current.empty())
+                live(current);
+            if (verify(p, now.minX - old.minX, now.minY - old.minY, current)) {
+                found = true;
+                foundPeriod = p;
+                foundDx = now.minX - old.minX;
+                foundDy = now.minY - old.minY;
+            }
+        }
+    }
+
+    ring[slot] = now;
+    seen[now.hash] = generation;
+    generation++;
+    return found;
+}
+
+
+// Rebuilds the generation 'period' before the current one by undoing the logged changes, and
+// compares it with the current cells moved back by (dx, dy)
+bool cycleDetector::verify(uint64_t period, int64_t dx, int64_t dy, const std::vector<uint64_t>& now)
+{
+    std::unordered_set<uint64_t> old(now.begin(), now.end());
+    for (uint64_t k = 0; k < period; k++) {
+        size_t slot = (generation - k) % depth;
+        for (uint64_t key : bornLog[slot])
+            old.erase(key);
+        for (uint64_t key : diedLog[slot])
+            old.insert(key);
+    }
+
+    if (old.size() != now.size())
+        return false;
+    for (uint64_t key : now) {
+        int x = (int)(uint32_t)((uint32_t)unpackX(key) - (uint32_t)dx);
+        int y = (int)(uint32_t)((uint32_t)unpackY(key) - (uint32_t)dy);
+        if (!old.count(packCell(x, y)))
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,78 @@
+#ifndef CYCLE_DETECT_H
+#define CYCLE_DETECT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include "cellHash.h"
+#include "lifeEngine.h"
+
+// Detects when the live set repeats one of the recent generations, either in place (still lifes and
+// oscillators) or shifted (spaceships). The detector keeps an order-independent hash of the live set
+// relative to its bounding box, updated from each generation's births and deaths, and looks the hash
+// up among the last 'depth' generations. A match is only reported after the two generations have
+// been compared cell by cell, which the detector can do from its log of the recent changes.
+//
+// Coordinates are the engine's local cells plus its origin, taken modulo 2^32 like the plane itself.
+// Feed one run through one form of update; the first generation may come through any of them.
+class cycleDetector
+{
+public:
+    explicit cycleDetector(size_t depth = 64);
+
+    void clear();
+
+    // Records the next generation given all of its cells. Returns true if it matches one of the last
+    // 'depth' generations.
+    bool update(const std::vector<int>& X, const std::vector<int>& Y, int64_t originX = 0, int64_t originY = 0);
+
+    // Records the engine's current generation, from the engine's changes if it keeps them, so a
+    // generation costs time in proportion to its births and deaths
+    bool update(const lifeEngine& engine);
+
+    uint64_t period() const { return foundPeriod; }
+    int64_t dx() const { return foundDx; }       // Displacement over one period
+    int64_t dy() const { return foundDy; }
+
+private:
+    // Live cells in one column or row, and the power of the hash base for its coordinate
+    struct line
+    {
+        uint64_t count;
+        uint64_t power;
+    };
+
+    struct signature
+    {
+        uint64_t hash;             // Of the cells relative to the bounding box
+        uint64_t population;
+        int64_t minX, minY;
+        int64_t width, height;
+    };
+
+    void add(uint64_t key);
+    void remove(uint64_t key);
+    static void prune(std::unordered_map<int, line>& lines, int& low, int& high);
+    bool record(const std::function<void(std::vector<uint64_t>&)>& live);
+    bool verify(uint64_t period, int64_t dx, int64_t dy, const std::vector<uint64_t>& now);
+
+    std::vector<signature> ring;
+    std::vector<std::vector<uint64_t>> bornLog, diedLog;   // Changes that made each generation in the ring
+    std::unordered_map<uint64_t, uint64_t> seen;         // Relative hash -> latest generation with it
+    std::unordered_map<int, line> columns, rows;
+    int minX, maxX, minY, maxY;  // Bounding box, unless 'rescan' is set
+    bool rescan;                 // A column or row on the edge of the box emptied
+    uint64_t absolute;          // Hash of the cells where they are
+    uint64_t population;
+    cellHash previous, scratch; // Cells of the last generation given whole, and of the one being given
+    std::vector<uint64_t> born, died, cells;
+    std::vector<int> bornX, bornY, diedX, diedY;
+    size_t depth;
+    uint64_t generation;
+    uint64_t foundPeriod;
+    int64_t foundDx, foundDy;
+};
+
+#endif
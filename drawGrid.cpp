@@ -6,43 +6,221 @@ Description:
    This function file prints the current grid state. This is done using only the vectors which hold the
    information of alive cells. If the grid prints empty then either every cell is dead or the alive cells
    are outside of the gridsize. Update the global constant GRIDSIZE to enlarge the grid.
+
+   The live cells are rasterized into a byte per screen cell with a single pass over X and Y, and the
+   text for the whole frame is built in a buffer that is allocated once, then written with one fwrite.
+   The frameRenderer used by the game loop homes the cursor rather than scrolling, and after the first
+   frame it only sends a cursor move and the new glyph for cells that changed, falling back to a full
+   frame when so much has changed that the diff would be larger. Cells drawn with a species take the
+   glyph of their species, so the screen byte holds the species rather than just alive or dead.
 */
 
 // Headers
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <memory>
 #include <vector>
 #include <algorithm>
 #include "drawGrid.h"
 
-void drawGrid(std::vector<int> X, std::vector<int> Y, int gS)
-{
-    int ubound = floor(gS / 2);
-    int lbound = ubound - gS;
-    int print;
-
-    for (int i = ubound; i > lbound; i--)
-    {
-        for (int j = lbound; j < ubound; j++)
-        {
-            // This part can be optimized better, currently it is doing twice what it needs to. Possibly 2D vector array containing the pairs (X,Y).
-            if (find(X.begin(), X.end(), j) != X.end() && find(Y.begin(), Y.end(), i) != Y.end())
-            {
-                print = 0;
-
-                for (int k = 0; k < std::min(X.size(), Y.size()); k++)
-                {
-                    if (X[k] == j && Y[k] == i) {
-                        printf(" x ");
-                        print++;
-                    }
-                }
-
-                if (!print)
-                    printf(" . ");
-            }
-            else
-                printf(" . ");
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+
+const char DEAD_GLYPH[] = " . ";
+const char* const ALIVE_GLYPHS[] = { " x ", " o ", " + ", " # " };   // By species, the first for plain cells
+const int SPECIES_GLYPHS = 4;
+const size_t DIFF_ENTRY = 16; // Longest cursor move plus glyph written for one changed cell
+
+
+frameRenderer::frameRenderer(int gS, bool ansi, FILE* out) : gS(gS), ansi(ansi), full(true), out(out), used(0)
+{
+    ubound = gS / 2;
+    lbound = ubound - gS;
+
+    cells.assign((size_t)gS * gS, 0);
+    shown.assign((size_t)gS * gS, 0);
+
+    // A full frame, plus the escape codes around it
+    frame.resize((size_t)gS * (3 * gS + 1) + 32);
+
+#ifdef _WIN32
+    // Windows consoles only understand the ANSI cursor codes once virtual terminal mode is on
+    if (ansi) {
+        HANDLE handle = GetStdHandle(STD_OUTPUT_HANDLE);
+        DWORD mode;
+        if (GetConsoleMode(handle, &mode))
+            SetConsoleMode(handle, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    }
+#endif
+}
+
+
+bool frameRenderer::viewport(int64_t originX, int64_t originY, cellRect& window) const
+{
+    int64_t minX = std::max<int64_t>((int64_t)lbound - originX, INT32_MIN);
+    int64_t maxX = std::min<int64_t>((int64_t)ubound - 1 - originX, INT32_MAX);
+    int64_t minY = std::max<int64_t>((int64_t)lbound + 1 - originY, INT32_MIN);
+    int64_t maxY = std::min<int64_t>((int64_t)ubound - originY, INT32_MAX);
+    window = cellRect{ (int)std::min<int64_t>(minX, INT32_MAX), (int)std::min<int64_t>(minY, INT32_MAX),
+        (int)std::max<int64_t>(maxX, INT32_MIN), (int)std::max<int64_t>(maxY, INT32_MIN) };
+    return minX <= maxX && minY <= maxY;
+}
+
+
+void frameRenderer::rasterize(const std::vector<int>& X, const std::vector<int>& Y, int64_t originX, int64_t originY)
+{
+    std::fill(cells.begin(), cells.end(), 0);
+
+    // Screen column and row of the local cell (0, 0). Unsigned compares fold the two bounds checks on
+    // each axis into one.
+    int64_t left = originX - lbound, top = ubound - originY;
+    for (cellCoord c : cellPairs(X, Y)) {
+        uint64_t col = (uint64_t)(left + c.x);
+        uint64_t row = (uint64_t)(top - c.y);
+        if (col < (uint64_t)gS && row < (uint64_t)gS)
+            cells[(size_t)row * gS + col] = 1;
+    }
+}
+
+
+void frameRenderer::rasterize(const std::vector<int>& X, const std::vector<int>& Y, const std::vector<int>& S, int64_t originX, int64_t originY)
+{
+    std::fill(cells.begin(), cells.end(), 0);
+
+    int64_t left = originX - lbound, top = ubound - originY;
+    size_t n = std::min(std::min(X.size(), Y.size()), S.size());
+    for (size_t i = 0; i < n; i++) {
+        uint64_t col = (uint64_t)(left + X[i]);
+        uint64_t row = (uint64_t)(top - Y[i]);
+        if (col < (uint64_t)gS && row < (uint64_t)gS)
+            cells[(size_t)row * gS + col] = (char)std::max(1, std::min(SPECIES_GLYPHS, S[i]));
+    }
+}
+
+
+void frameRenderer::rasterize(const cellStore& live, int64_t originX, int64_t originY)
+{
+    std::fill(cells.begin(), cells.end(), 0);
+
+    // Morton keys grow with each coordinate, so the store only looks at the keys between the corners
+    // of the window and seeks past those outside it
+    cellRect window;
+    if (!viewport(originX, originY, window))
+        return;
+    int64_t left = originX - lbound, top = ubound - originY;
+    live.forEachIn(window, [&](int x, int y) { cells[(size_t)(top - y) * gS + (size_t)(left + x)] = 1; });
+}
+
+
+const char* frameRenderer::glyph(char cell)
+{
+    return cell ? ALIVE_GLYPHS[cell - 1] : DEAD_GLYPH;
+}
+
+
+void frameRenderer::put(const char* s, size_t n)
+{
+    memcpy(frame.data() + used, s, n);
+    used += n;
+}
+
+
+void frameRenderer::appendFull()
+{
+    // Clear the screen and start from the top left corner
+    if (ansi)
+        put("\x1b[2J\x1b[H", 7);
+
+    for (int r = 0; r < gS; r++) {
+        const char* row = &cells[(size_t)r * gS];
+        for (int c = 0; c < gS; c++)
+            put(glyph(row[c]), 3);
+        put("\n", 1);
+    }
+}
+
+
+bool frameRenderer::appendDiff()
+{
+    size_t budget = frame.size() - 3 * gS;
+    char move[DIFF_ENTRY];
+
+    for (size_t i = 0; i < cells.size(); i++) {
+        if (cells[i] != shown[i]) {
+            if (used + DIFF_ENTRY > budget)
+                return false;
+
+            int len = snprintf(move, sizeof(move), "\x1b[%d;%dH", (int)(i / gS) + 1, (int)(i % gS) * 3 + 1);
+            put(move, len);
+            put(glyph(cells[i]), 3);
         }
-        printf("\n");
     }
+
+    // Leave the cursor below the grid for whatever is printed next
+    int len = snprintf(move, sizeof(move), "\x1b[%d;1H", gS + 1);
+    put(move, len);
+    return true;
+}
+
+
+void frameRenderer::draw(const std::vector<int>& X, const std::vector<int>& Y, int64_t originX, int64_t originY)
+{
+    rasterize(X, Y, originX, originY);
+    show();
+}
+
+
+void frameRenderer::draw(const std::vector<int>& X, const std::vector<int>& Y, const std::vector<int>& S, int64_t originX, int64_t originY)
+{
+    rasterize(X, Y, S, originX, originY);
+    show();
+}
+
+
+void frameRenderer::draw(const cellStore& live, int64_t originX, int64_t originY)
+{
+    rasterize(live, originX, originY);
+    show();
+}
+
+
+void frameRenderer::show()
+{
+    used = 0;
+    if (!ansi || full || !appendDiff()) {
+        used = 0;
+        appendFull();
+    }
+    full = false;
+    shown.swap(cells);
+
+    fwrite(frame.data(), 1, used, out);
+    fflush(out);
+}
+
+
+static frameRenderer& plainRenderer(int gS)
+{
+    static std::unique_ptr<frameRenderer> plain;
+
+    if (!plain || plain->size() != gS)
+        plain.reset(new frameRenderer(gS, false));
+    return *plain;
+}
+
+
+void drawGrid(const std::vector<int>& X, const std::vector<int>& Y, int gS)
+{
+    plainRenderer(gS).draw(X, Y);
+}
+
+
+void drawGrid(const cellStore& live, int gS)
+{
+    plainRenderer(gS).draw(live);
 }
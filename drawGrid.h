@@ -1,10 +1,54 @@
 #ifndef DRAW_GRID_H
 #define DRAW_GRID_H
 
+#include <cstdint>
 #include <cstdio>
 #include <vector>
 #include <algorithm>
+#include "cellStore.h"
+#include "regionIndex.h"
 
-void drawGrid(std::vector<int> X, std::vector<int> Y, int gS);
+// Renders the window x in [lbound, ubound), y in (lbound, ubound] of the universe, where
+// ubound = gS / 2 and lbound = ubound - gS, into a frame buffer allocated once up front. Cells are
+// given as an engine holds them, offsets from its origin, and the origin says where they are. The live
+// cells are rasterized in one pass and each frame goes out in a single fwrite. In ANSI mode frames
+// are drawn from the cursor home position instead of scrolling, and once a frame is on screen only
+// the cells that changed are rewritten.
+class frameRenderer
+{
+public:
+    frameRenderer(int gS, bool ansi, FILE* out = stdout);
 
-#endif
\ No newline at end of file
+    void draw(const std::vector<int>& X, const std::vector<int>& Y, int64_t originX = 0, int64_t originY = 0);
+    void draw(const std::vector<int>& X, const std::vector<int>& Y, const std::vector<int>& S,   // Species 1 to 4 in S
+        int64_t originX = 0, int64_t originY = 0);
+    void draw(const cellStore& live, int64_t originX = 0, int64_t originY = 0);
+    void redraw() { full = true; }   // Send a complete frame on the next draw
+    int size() const { return gS; }
+
+    // The part of the window that offsets from the given origin can reach, in those offsets. False if
+    // the window is entirely out of their range.
+    bool viewport(int64_t originX, int64_t originY, cellRect& window) const;
+
+private:
+    void rasterize(const std::vector<int>& X, const std::vector<int>& Y, int64_t originX, int64_t originY);
+    void rasterize(const std::vector<int>& X, const std::vector<int>& Y, const std::vector<int>& S, int64_t originX, int64_t originY);
+    void rasterize(const cellStore& live, int64_t originX, int64_t originY);
+    static const char* glyph(char cell);
+    void show();
+    void put(const char* s, size_t n);
+    void appendFull();
+    bool appendDiff();
+
+    int gS, ubound, lbound;
+    bool ansi, full;
+    FILE* out;
+    std::vector<char> cells, shown;
+    std::vector<char> frame;
+    size_t used;
+};
+
+void drawGrid(const std::vector<int>& X, const std::vector<int>& Y, int gS);
+void drawGrid(const cellStore& live, int gS);
+
+#endif
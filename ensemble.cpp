@@ -0,0 +1,505 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   Soup ensembles: many small random soups run to the end, the way soup searches classify what random
+   seeds turn into. Soups are run 64 at a time, one per bit. Word (x, y) of a packed grid holds cell
+   (x, y) of all 64 universes, so the neighbours of a word are simply the eight words around it and
+   bitKernel.h advances 64 soups per word, and a vector of words per instruction, with no shifting.
+
+   The packed universe is a BOX x BOX square. The words outside it stay clear, which is only right
+   while nothing could be born there, so a soup with a live cell on the outermost row or column has
+   its cells taken out of the grid and is finished on its own on the tile engine, with the real
+   infinite plane around it. Most soups end up there, since most send off a glider; by then the
+   rest is usually ash, which the tile engine skips.
+
+   Every SNAPSHOT_EVERY generations the grid is copied aside, and each step ORs the difference from
+   that copy into one word: a soup whose bit is clear repeats the snapshot, with the period being the
+   generations since it was taken. Soups that die or repeat are cleared from the grid and counted, so
+   a batch speeds up as its soups settle. Periods longer than SNAPSHOT_EVERY are not recognised. A
+   step sweeps only the rows that can hold live cells, or did in the snapshot or in the buffer being
+   overwritten.
+
+   On the tile engine only the population is followed. Once it has repeated with a period of up to
+   MAX_PERIOD for POPULATION_WINDOW generations the cells are checked for a couple of periods: if the
+   cycle detector sees them repeat the soup is periodic, otherwise it settled while sending spaceships
+   off to infinity.
+
+   Results do not depend on the number of threads: soup i always uses seed --seed + i and rows are
+   written in soup order.
+*/
+
+// Headers
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "ensemble.h"
+#include "benchmark.h"
+#include "bitKernel.h"
+#include "cycleDetect.h"
+#include "lifeEngine.h"
+#include "threadPool.h"
+#include "tileEngine.h"
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+
+const int BOX = 64;                           // Side of the packed universe
+const int PAD = 4;                            // Clear words either side of a row, at least one vector
+const int STRIDE = BOX + 2 * PAD;
+const size_t WORDS = (size_t)(BOX + 2) * STRIDE;    // Interior rows 1 to BOX and a clear row either side
+const uint64_t SNAPSHOT_EVERY = 64;
+const uint64_t MAX_PERIOD = 64;
+const size_t POPULATION_WINDOW = 256;
+const size_t BATCH = 64;
+
+
+const char* fateName(soupFate fate)
+{
+    switch (fate) {
+    case SOUP_DIED: return "died";
+    case SOUP_PERIODIC: return "periodic";
+    case SOUP_ESCAPING: return "escaping";
+    default: return "unsettled";
+    }
+}
+
+
+// Index of the lowest set bit of a non-zero word
+static int lowestBit(uint64_t v)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, v);
+    return (int)index;
+#else
+    return __builtin_ctzll(v);
+#endif
+}
+
+
+template <class Op>
+static uint64_t reduceOr(typename Op::V v)
+{
+    uint64_t words[Op::lanes];
+    Op::store(words, v);
+    uint64_t any = 0;
+    for (int i = 0; i < Op::lanes; i++)
+        any |= words[i];
+    return any;
+}
+
+
+// Advances rows 'first' to 'last' of the packed grid. Returns the soups with any live cell, the soups
+// that differ anywhere in the swept rows from 'snap', and the first and last rows left with cells.
+template <class Op, uint32_t MASK>
+static void stepPacked(const uint64_t* cur, uint64_t* next, const uint64_t* snap, int first, int last, uint32_t mask,
+    uint64_t& alive, uint64_t& changed, int& top, int& bottom)
+{
+    typedef typename Op::V V;
+    V anyAlive = Op::zero(), anyChanged = Op::zero();
+    top = BOX + 1;
+    bottom = 0;
+
+    for (int r = first; r <= last; r++) {
+        V rowAlive = Op::zero();
+        for (int x = PAD; x < PAD + BOX; x += Op::lanes) {
+            size_t i = (size_t)r * STRIDE + x, below = i - STRIDE, above = i + STRIDE;
+            V cells = nextCells<Op, MASK>(Op::load(cur + below - 1), Op::load(cur + below), Op::load(cur + below + 1),
+                Op::load(cur + i - 1), Op::load(cur + i + 1),
+                Op::load(cur + above - 1), Op::load(cur + above), Op::load(cur + above + 1), Op::load(cur + i), mask);
+            Op::store(next + i, cells);
+            rowAlive = Op::orV(rowAlive, cells);
+            anyChanged = Op::orV(anyChanged, Op::xorV(cells, Op::load(snap + i)));
+        }
+        if (reduceOr<Op>(rowAlive)) {
+            top = std::min(top, r);
+            bottom = r;
+        }
+        anyAlive = Op::orV(anyAlive, rowAlive);
+    }
+    alive = reduceOr<Op>(anyAlive);
+    changed = reduceOr<Op>(anyChanged);
+}
+
+
+typedef void (*packedStepper)(const uint64_t*, uint64_t*, const uint64_t*, int, int, uint32_t, uint64_t&, uint64_t&, int&, int&);
+
+
+// Soups with a live cell on the outermost rows or columns of the box
+static uint64_t edgeSoups(const uint64_t* grid, int top, int bottom)
+{
+    uint64_t edge = 0;
+    for (int r = top; r <= bottom; r++) {
+        const uint64_t* row = grid + (size_t)r * STRIDE;
+        if (r == 1 || r == BOX) {
+            for (int x = PAD; x < PAD + BOX; x++)
+                edge |= row[x];
+        }
+        else
+            edge |= row[PAD] | row[PAD + BOX - 1];
+    }
+    return edge;
+}
+
+
+// Live cells of every soup in 'soups'
+static void countSoups(const uint64_t* grid, int top, int bottom, uint64_t soups, size_t* counts)
+{
+    for (int r = top; r <= bottom; r++) {
+        for (int x = PAD; x < PAD + BOX; x++) {
+            for (uint64_t bits = grid[(size_t)r * STRIDE + x] & soups; bits; bits &= bits - 1)
+                counts[lowestBit(bits)]++;
+        }
+    }
+}
+
+
+// Takes one soup's cells out of the grid, centred on the origin like the soup they came from
+static void extractSoup(uint64_t* grid, int top, int bottom, int soup, std::vector<int>& X, std::vector<int>& Y)
+{
+    uint64_t bit = 1ull << soup;
+    X.clear();
+    Y.clear();
+    for (int r = top; r <= bottom; r++) {
+        for (int x = PAD; x < PAD + BOX; x++) {
+            uint64_t& word = grid[(size_t)r * STRIDE + x];
+            if (word & bit) {
+                X.push_back(x - PAD - BOX / 2);
+                Y.push_back(r - 1 - BOX / 2);
+                word &= ~bit;
+            }
+        }
+    }
+}
+
+
+// Smallest period up to MAX_PERIOD with which the last POPULATION_WINDOW populations repeat, or 0
+static uint64_t populationPeriod(const std::vector<size_t>& populations)
+{
+    size_t n = populations.size();
+    if (n < POPULATION_WINDOW + MAX_PERIOD)
+        return 0;
+    for (uint64_t p = 1; p <= MAX_PERIOD; p++) {
+        size_t i = n - POPULATION_WINDOW;
+        while (i < n && populations[i] == populations[i - p])
+            i++;
+        if (i == n)
+            return p;
+    }
+    return 0;
+}
+
+
+// Runs a soup that left the packed box on the tile engine, from generation 'generation'. Only the
+// population is looked at each generation; once it repeats, the cells are read back for a couple of
+// periods to tell a repeating pattern from settled ash with spaceships flying off.
+static void finishSparse(const lifeRule& rule, std::vector<int>& X, std::vector<int>& Y, uint64_t generation,
+    uint64_t maxGenerations, soupResult& result)
+{
+    tileEngine engine;
+    engine.setRule(rule);
+    engine.load(X, Y);
+    engine.setOrigin(0, 0);
+
+    std::vector<size_t> populations;
+    result.spilled = true;
+    result.lifespan = generation;
+    result.population = X.size();
+    result.fate = SOUP_UNSETTLED;
+
+    while (generation < maxGenerations) {
+        engine.step();
+        generation++;
+        size_t population = engine.population();
+        result.lifespan = generation;
+        result.population = population;
+
+        if (population == 0) {
+            result.fate = SOUP_DIED;
+            return;
+        }
+        populations.push_back(population);
+        if (generation % MAX_PERIOD != 0)
+            continue;
+
+        uint64_t period = populationPeriod(populations);
+        if (period == 0)
+            continue;
+
+        cycleDetector cycles;
+        engine.store(X, Y);
+        cycles.update(X, Y);
+        for (uint64_t g = 0; g < 2 * period && generation < maxGenerations; g++) {
+            engine.step();
+            generation++;
+            engine.store(X, Y);
+            if (cycles.update(X, Y)) {
+                result.fate = SOUP_PERIODIC;
+                result.period = cycles.period();
+                result.lifespan = generation;
+                return;
+            }
+        }
+        result.fate = generation < maxGenerations ? SOUP_ESCAPING : SOUP_UNSETTLED;
+        result.period = result.fate == SOUP_ESCAPING ? period : 0;
+        result.lifespan = generation;
+        result.population = X.size();
+        return;
+    }
+}
+
+
+void runSoupBatch(const lifeRule& rule, int size, double density, unsigned baseSeed, uint64_t first, size_t count,
+    uint64_t maxGenerations, soupResult* results)
+{
+    count = std::min(count, BATCH);
+    uint32_t mask = rule.mask();
+    packedStepper step = mask == LIFE_MASK ? stepPacked<simdOps, LIFE_MASK> : stepPacked<simdOps, RUNTIME_MASK>;
+
+    std::vector<uint64_t> gridA(WORDS, 0), gridB(WORDS, 0), snap(WORDS, 0);
+    uint64_t* cur = gridA.data();
+    uint64_t* next = gridB.data();
+
+    // Seed one soup per bit
+    std::vector<int> X, Y;
+    int curTop = BOX + 1, curBottom = 0;
+    for (size_t s = 0; s < count; s++) {
+        soupResult& result = results[s];
+        result.index = first + s;
+        result.seed = baseSeed + (unsigned)(first + s);
+        result.fate = SOUP_UNSETTLED;
+        result.lifespan = 0;
+        result.period = 0;
+        result.population = 0;
+        result.spilled = false;
+
+        randomSoup(size, size, density, result.seed, X, Y);
+        result.population = X.size();
+        for (size_t i = 0; i < X.size(); i++) {
+            int r = Y[i] + BOX / 2 + 1;
+            cur[(size_t)r * STRIDE + PAD + X[i] + BOX / 2] |= 1ull << s;
+            curTop = std::min(curTop, r);
+            curBottom = std::max(curBottom, r);
+        }
+    }
+
+    uint64_t active = count == BATCH ? ~0ull : (1ull << count) - 1;
+    int staleTop = BOX + 1, staleBottom = 0;
+    memcpy(snap.data(), cur, WORDS * sizeof(uint64_t));
+    int snapTop = curTop, snapBottom = curBottom;
+    uint64_t snapGeneration = 0;
+    size_t counts[BATCH];
+
+    // Soups that started empty
+    uint64_t empty = active;
+    for (size_t i = 0; i < WORDS; i++)
+        empty &= ~cur[i];
+    active &= ~empty;
+    for (uint64_t bits = empty; bits; bits &= bits - 1)
+        results[lowestBit(bits)].fate = SOUP_DIED;
+
+    for (uint64_t generation = 1; active && generation <= maxGenerations; generation++) {
+        int from = std::max(1, std::min({ curTop - 1, staleTop, snapTop }));
+        int to = std::min(BOX, std::max({ curBottom + 1, staleBottom, snapBottom }));
+        uint64_t alive = 0, changed = 0;
+        int top = BOX + 1, bottom = 0;
+        if (from <= to)
+            step(cur, next, snap.data(), from, to, mask, alive, changed, top, bottom);
+
+        std::swap(cur, next);
+        staleTop = curTop;
+        staleBottom = curBottom;
+        curTop = top;
+        curBottom = bottom;
+
+        uint64_t died = active & ~alive;
+        uint64_t settled = active & alive & ~changed;
+        uint64_t spilled = active & ~settled & edgeSoups(cur, curTop, curBottom);
+        uint64_t unsettled = generation == maxGenerations ? active & ~died & ~settled & ~spilled : 0;
+
+        if (settled | unsettled) {
+            std::fill(counts, counts + BATCH, 0);
+            countSoups(cur, curTop, curBottom, settled | unsettled, counts);
+        }
+        for (uint64_t bits = died | settled | unsettled; bits; bits &= bits - 1) {
+            int s = lowestBit(bits);
+            soupResult& result = results[s];
+            result.lifespan = generation;
+            if (died >> s & 1) {
+                result.fate = SOUP_DIED;
+                result.population = 0;
+            }
+            else if (settled >> s & 1) {
+                result.fate = SOUP_PERIODIC;
+                result.period = generation - snapGeneration;
+                result.population = counts[s];
+            }
+            else {
+                result.fate = SOUP_UNSETTLED;
+                result.population = counts[s];
+            }
+        }
+        for (uint64_t bits = spilled; bits; bits &= bits - 1) {
+            int s = lowestBit(bits);
+            extractSoup(cur, curTop, curBottom, s, X, Y);
+            finishSparse(rule, X, Y, generation, maxGenerations, results[s]);
+        }
+
+        // Clear the finished soups so they stop widening the swept rows
+        uint64_t finished = died | settled | unsettled | spilled;
+        active &= ~finished;
+        if (settled | unsettled) {
+            for (int r = curTop; r <= curBottom; r++) {
+                for (int x = PAD; x < PAD + BOX; x++)
+                    cur[(size_t)r * STRIDE + x] &= ~finished;
+            }
+        }
+
+        if (generation % SNAPSHOT_EVERY == 0) {
+            int low = std::min(curTop, snapTop), high = std::max(curBottom, snapBottom);
+            if (low <= high)
+                memcpy(snap.data() + (size_t)low * STRIDE, cur + (size_t)low * STRIDE, (size_t)(high - low + 1) * STRIDE * sizeof(uint64_t));
+            snapTop = curTop;
+            snapBottom = curBottom;
+            snapGeneration = generation;
+        }
+    }
+}
+
+
+// Running totals over every soup
+struct ensembleStats
+{
+    uint64_t fates[SOUP_UNSETTLED + 1] = {};
+    uint64_t spilled = 0;
+    uint64_t generations = 0;
+    double population = 0;
+    uint64_t longest = 0;
+    unsigned longestSeed = 0;
+    std::map<uint64_t, uint64_t> periods;
+    uint64_t lifespans[65] = {};    // Soups by bit length of their lifespan
+
+    void add(const soupResult& result)
+    {
+        fates[result.fate]++;
+        spilled += result.spilled;
+        generations += result.lifespan;
+        population += result.population;
+        if (result.fate != SOUP_UNSETTLED && result.lifespan > longest) {
+            longest = result.lifespan;
+            longestSeed = result.seed;
+        }
+        if (result.period > 0)
+            periods[result.period]++;
+        int bits = 0;
+        for (uint64_t v = result.lifespan; v; v >>= 1)
+            bits++;
+        lifespans[bits]++;
+    }
+};
+
+
+int runEnsemble(const runOptions& options)
+{
+    typedef std::chrono::steady_clock timer;
+
+    lifeRule rule = LIFE;
+    if (!options.rule.empty() && !parseRule(options.rule, rule)) {
+        std::cout << "ERROR: Unknown rule '" << options.rule << "'.\n";
+        return 1;
+    }
+    if (rule.generations()) {
+        std::cout << "ERROR: Ensembles run two-state rules only.\n";
+        return 1;
+    }
+    int size = options.soupSize > 0 ? options.soupSize : 16;
+    if (size > BOX - 4) {
+        std::cout << "ERROR: Ensemble soups are at most " << BOX - 4 << " cells across.\n";
+        return 1;
+    }
+
+    std::ofstream out;
+    if (!options.ensembleOut.empty()) {
+        out.open(options.ensembleOut);
+        if (!out) {
+            std::cout << "ERROR: Could not write " << options.ensembleOut << "\n";
+            return 1;
+        }
+        out << "soup,seed,fate,lifespan,period,population,spilled\n";
+    }
+
+    // Rounds of a few batches per thread, so rows can be written in order as the run goes
+    threadPool pool(options.threads);
+    size_t roundBatches = 4 * (size_t)pool.size();
+    std::vector<soupResult> results(roundBatches * BATCH);
+    ensembleStats stats;
+
+    timer::time_point start = timer::now();
+    for (uint64_t first = 0; first < options.ensemble; first += roundBatches * BATCH) {
+        uint64_t soups = std::min<uint64_t>(options.ensemble - first, roundBatches * BATCH);
+        pool.run((size_t)((soups + BATCH - 1) / BATCH), [&](size_t b) {
+            uint64_t begin = first + b * BATCH;
+            runSoupBatch(rule, size, options.density, options.seed, begin, (size_t)std::min<uint64_t>(BATCH, first + soups - begin),
+                options.generations, &results[b * BATCH]);
+        });
+
+        for (size_t i = 0; i < soups; i++) {
+            const soupResult& result = results[i];
+            stats.add(result);
+            if (out.is_open()) {
+                out << result.index << "," << result.seed << "," << fateName(result.fate) << "," << result.lifespan << ","
+                    << result.period << "," << result.population << "," << (result.spilled ? 1 : 0) << "\n";
+            }
+        }
+        if (out.is_open())
+            out.flush();
+    }
+    double seconds = std::chrono::duration<double>(timer::now() - start).count();
+
+    if (out.is_open()) {
+        out.close();
+        if (!out) {
+            std::cout << "ERROR: Could not write " << options.ensembleOut << "\n";
+            return 1;
+        }
+    }
+
+    uint64_t total = options.ensemble;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "soups:           " << total << " (" << size << "x" << size << ", density " << options.density << ", "
+        << rule.name() << ", seeds " << options.seed << " to " << options.seed + (unsigned)(total - 1) << ")\n";
+    std::cout << "time:            " << seconds << " s, " << (seconds > 0 ? total / seconds : 0) << " soups/sec, "
+        << (seconds > 0 ? stats.generations / seconds : 0) << " generations/sec\n";
+    for (int f = SOUP_DIED; f <= SOUP_UNSETTLED; f++) {
+        std::cout << std::left << std::setw(17) << std::string(fateName((soupFate)f)) + ":" << std::right << stats.fates[f]
+            << " (" << 100.0 * stats.fates[f] / std::max<uint64_t>(total, 1) << "%)\n";
+    }
+    std::cout << "left the box:    " << stats.spilled << "\n";
+    std::cout << "mean lifespan:   " << (double)stats.generations / std::max<uint64_t>(total, 1) << "\n";
+    std::cout << "longest settled: " << stats.longest << " generations, seed " << stats.longestSeed << "\n";
+    std::cout << "mean population: " << stats.population / std::max<uint64_t>(total, 1) << "\n";
+
+    std::cout << "periods:        ";
+    for (const auto& period : stats.periods)
+        std::cout << " " << period.first << ":" << period.second;
+    std::cout << "\n";
+
+    std::cout << "lifespans:\n";
+    for (int bits = 0; bits <= 64; bits++) {
+        if (stats.lifespans[bits] == 0)
+            continue;
+        uint64_t low = bits == 0 ? 0 : 1ull << (bits - 1), high = bits == 0 ? 0 : (1ull << (bits - 1)) * 2 - 1;
+        std::cout << "  " << std::setw(8) << low << " - " << std::setw(8) << high << ": " << stats.lifespans[bits] << "\n";
+    }
+    return 0;
+}
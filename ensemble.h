@@ -0,0 +1,40 @@
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include "headless.h"
+#include "lifeRule.h"
+
+// How a soup ended
+enum soupFate
+{
+    SOUP_DIED,        // No cells left
+    SOUP_PERIODIC,    // Repeats: still lifes, oscillators, or a lone spaceship
+    SOUP_ESCAPING,    // Population repeats while spaceships fly off, the ash left behind has settled
+    SOUP_UNSETTLED    // Still changing at the generation limit
+};
+
+const char* fateName(soupFate fate);
+
+struct soupResult
+{
+    uint64_t index;
+    unsigned seed;          // --soup N --seed S --density D reproduces the soup in headless mode
+    soupFate fate;
+    uint64_t lifespan;      // Generation at which the fate was detected
+    uint64_t period;        // Of the repeating state, 0 if the soup died or did not settle
+    size_t population;      // Live cells at that generation
+    bool spilled;           // Outgrew the packed box and was finished on the tile engine
+};
+
+// Runs 'count' soups, at most 64, starting at soup 'first'. Soup i is a size x size random soup of
+// the given density made with seed baseSeed + i, run for up to maxGenerations generations.
+void runSoupBatch(const lifeRule& rule, int size, double density, unsigned baseSeed, uint64_t first, size_t count,
+    uint64_t maxGenerations, soupResult* results);
+
+// Runs options.ensemble soups on options.threads threads, streams one CSV row per soup to
+// options.ensembleOut if given and prints the aggregated statistics. Returns the process exit code.
+int runEnsemble(const runOptions& options);
+
+#endif
@@ -0,0 +1,683 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   HashLife engine after Gosper. The universe is a quadtree in which every distinct subtree is stored
+   exactly once (looked up through a hash of its four children), so repeated structure such as a
+   glider stream costs nothing extra to store. For a node of level k the centre half advanced by
+   2^(k-2) generations depends only on the node itself, and it is computed recursively from nine
+   overlapping sub-nodes in two half steps and memoized on the node. Calling advance(k) grows the
+   root until the pattern sits in its centre quarter and then takes a single such step, so 2^k
+   generations cost about as much as the number of distinct sub-patterns met along the way.
+
+   When the store grows past the memory limit a mark and sweep collection keeps every node reachable
+   from the root, the empty nodes and anything the recursion in progress still holds, and frees the
+   rest. Memoized results that point to freed nodes are dropped and recomputed if needed again. Node
+   ids never move, so a collection can run in the middle of a step.
+
+   The root position is kept in 64 bits, so the tree itself never overflows; recentering only moves
+   that position so the cells read back by store fit the 32-bit local coordinates.
+*/
+
+// Headers
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <vector>
+#include <algorithm>
+#include "hashLife.h"
+#include "cellPairs.h"
+#include "metrics.h"
+
+
+const uint32_t hashLife::NONE;
+const size_t DEFAULT_MEMORY = 256u << 20; // Default node cache size in bytes
+
+
+hashLife::hashLife() : freeList(NONE), liveNodes(0), root(NONE), originX(0), originY(0), gen(0), ruleMask(LIFE.mask())
+{
+    // Node 0 is the dead cell and node 1 the live cell
+    for (int i = 0; i < 2; i++) {
+        hashNode leaf = {};
+        leaf.child[0] = leaf.child[1] = leaf.child[2] = leaf.child[3] = NONE;
+        leaf.result = NONE;
+        leaf.next = NONE;
+        leaf.pop = i;
+        leaf.resultStep = -1;
+        leaf.used = true;
+        nodes[nodes.push()] = leaf;
+        liveNodes++;
+    }
+
+    rehash(1 << 16);
+    setMemoryLimit(DEFAULT_MEMORY);
+    empties.push_back(0);
+    root = empty(3);
+}
+
+
+bool hashLife::setRule(const lifeRule& rule)
+{
+    if (rule.generations())
+        return false;
+
+    // Memoized results were computed under the old rule
+    if (rule.mask() != ruleMask)
+        for (size_t i = 0; i < nodes.size(); i++)
+            nodes[i].result = NONE;
+    ruleMask = rule.mask();
+    return true;
+}
+
+
+void hashLife::setMemoryLimit(size_t bytes)
+{
+    nodeLimit = std::max<size_t>(bytes / sizeof(hashNode), 1024);
+    gcThreshold = std::max(nodeLimit, liveNodes + liveNodes / 2);
+}
+
+
+size_t hashLife::bucketFor(const uint32_t* c) const
+{
+    uint64_t h = c[0];
+    h = h * 0x9E3779B97F4A7C15ull + c[1];
+    h = h * 0x9E3779B97F4A7C15ull + c[2];
+    h = h * 0x9E3779B97F4A7C15ull + c[3];
+    h ^= h >> 29;
+    return (size_t)(h * 0xBF58476D1CE4E5B9ull >> 32) & (buckets.size() - 1);
+}
+
+
+void hashLife::rehash(size_t count)
+{
+    size_t size = 16;
+    while (size < count)
+        size <<= 1;
+
+    METRIC_ADD(COUNTER_ALLOCATIONS, 1);
+    buckets.assign(size, NONE);
+    for (uint32_t i = 2; i < nodes.size(); i++) {
+        if (nodes[i].used) {
+            size_t b = bucketFor(nodes[i].child);
+            nodes[i].next = buckets[b];
+            buckets[b] = i;
+        }
+    }
+}
+
+
+uint32_t hashLife::join(uint32_t sw, uint32_t se, uint32_t nw, uint32_t ne)
+{
+    uint32_t c[4] = { sw, se, nw, ne };
+    size_t b = bucketFor(c);
+
+    for (uint32_t i = buckets[b]; i != NONE; i = nodes[i].next)
+        if (memcmp(nodes[i].child, c, sizeof(c)) == 0)
+            return i;
+
+    // The children are not reachable from anything yet, so hold them across a collection
+    if (liveNodes >= gcThreshold) {
+        protect.insert(protect.end(), c, c + 4);
+        collect();
+        protect.resize(protect.size() - 4);
+    }
+    if (liveNodes + 1 > buckets.size())
+        rehash(2 * buckets.size());
+    b = bucketFor(c);
+
+    uint32_t id;
+    if (freeList != NONE) {
+        id = freeList;
+        freeList = nodes[id].next;
+    }
+    else {
+        id = (uint32_t)nodes.push();
+    }
+
+    hashNode& n = nodes[id];
+    memcpy(n.child, c, sizeof(c));
+    n.result = NONE;
+    n.resultStep = -1;
+    n.level = nodes[sw].level + 1;
+    n.pop = nodes[sw].pop + nodes[se].pop + nodes[nw].pop + nodes[ne].pop;
+    n.marked = false;
+    n.used = true;
+    n.next = buckets[b];
+    buckets[b] = id;
+    liveNodes++;
+
+    return id;
+}
+
+
+uint32_t hashLife::empty(int level)
+{
+    while ((int)empties.size() <= level) {
+        uint32_t e = empties.back();
+        empties.push_back(join(e, e, e, e));
+    }
+    return empties[level];
+}
+
+
+uint32_t hashLife::centre(uint32_t n)
+{
+    const uint32_t* c = nodes[n].child;
+    uint32_t sw = nodes[c[0]].child[3], se = nodes[c[1]].child[2];
+    uint32_t nw = nodes[c[2]].child[1], ne = nodes[c[3]].child[0];
+    return join(sw, se, nw, ne);
+}
+
+
+uint32_t hashLife::expand(uint32_t n)
+{
+    size_t base = protect.size();
+    uint32_t c[4];
+    memcpy(c, nodes[n].child, sizeof(c));
+    int level = nodes[n].level;
+
+    protect.push_back(n);
+    uint32_t e = empty(level - 1);
+    uint32_t sw = join(e, e, e, c[0]);
+    protect.push_back(sw);
+    uint32_t se = join(e, e, c[1], e);
+    protect.push_back(se);
+    uint32_t nw = join(e, c[2], e, e);
+    protect.push_back(nw);
+    uint32_t ne = join(c[3], e, e, e);
+    protect.push_back(ne);
+    uint32_t out = join(sw, se, nw, ne);
+    protect.resize(base);
+
+    originX -= (int64_t)1 << (level - 1);
+    originY -= (int64_t)1 << (level - 1);
+    return out;
+}
+
+
+bool hashLife::centred(uint32_t n) const
+{
+    // Everything outside the four grandchildren that touch the centre must be empty
+    for (int q = 0; q < 4; q++) {
+        const hashNode& c = nodes[nodes[n].child[q]];
+        for (int g = 0; g < 4; g++)
+            if (g != 3 - q && nodes[c.child[g]].pop)
+                return false;
+    }
+    return true;
+}
+
+
+uint32_t hashLife::baseStep(uint32_t n)
+{
+    // Gather the 4x4 block into a bitmask, bit (4y + x)
+    int bits = 0;
+    for (int q = 0; q < 4; q++) {
+        const hashNode& c = nodes[nodes[n].child[q]];
+        for (int l = 0; l < 4; l++)
+            if (c.child[l] == 1)
+                bits |= 1 << ((2 * (q >> 1) + (l >> 1)) * 4 + 2 * (q & 1) + (l & 1));
+    }
+
+    uint32_t out[4];
+    for (int y = 1; y <= 2; y++) {
+        for (int x = 1; x <= 2; x++) {
+            int neigh = 0;
+            for (int dy = -1; dy <= 1; dy++)
+                for (int dx = -1; dx <= 1; dx++)
+                    if ((dx || dy) && (bits >> ((y + dy) * 4 + x + dx) & 1))
+                        neigh++;
+
+            bool alive = bits >> (y * 4 + x) & 1;
+            out[(y - 1) * 2 + (x - 1)] = ruleMask >> (neigh + (alive ? 9 : 0)) & 1;
+        }
+    }
+    return join(out[0], out[1], out[2], out[3]);
+}
+
+
+uint32_t hashLife::successor(uint32_t n, int j)
+{
+    int level = nodes[n].level;
+    int s = std::min(j, level - 2);
+
+    if (nodes[n].pop == 0)
+        return empty(level - 1);
+    if (nodes[n].result != NONE && nodes[n].resultStep == s)
+        return nodes[n].result;
+
+    uint32_t r;
+    if (level == 2)
+        r = baseStep(n);
+    else {
+        size_t base = protect.size();
+        bool full = (s == level - 2);
+
+        // The 4x4 grandchildren, row 0 is the south edge
+        uint32_t g[4][4];
+        for (int y = 0; y < 4; y++)
+            for (int x = 0; x < 4; x++)
+                g[y][x] = nodes[nodes[n].child[(y >> 1) * 2 + (x >> 1)]].child[(y & 1) * 2 + (x & 1)];
+
+        // Nine overlapping sub-nodes, each advanced by the first half step
+        uint32_t m[3][3];
+        for (int y = 0; y < 3; y++) {
+            for (int x = 0; x < 3; x++) {
+                m[y][x] = join(g[y][x], g[y][x + 1], g[y + 1][x], g[y + 1][x + 1]);
+                protect.push_back(m[y][x]);
+            }
+        }
+        for (int y = 0; y < 3; y++) {
+            for (int x = 0; x < 3; x++) {
+                m[y][x] = successor(m[y][x], j);
+                protect.push_back(m[y][x]);
+            }
+        }
+
+        // Four overlapping quadrants, advanced by the second half step or just centred
+        uint32_t f[2][2];
+        for (int y = 0; y < 2; y++) {
+            for (int x = 0; x < 2; x++) {
+                uint32_t q = join(m[y][x], m[y][x + 1], m[y + 1][x], m[y + 1][x + 1]);
+                protect.push_back(q);
+                f[y][x] = full ? successor(q, j) : centre(q);
+                protect.push_back(f[y][x]);
+            }
+        }
+
+        r = join(f[0][0], f[0][1], f[1][0], f[1][1]);
+        protect.resize(base);
+    }
+
+    nodes[n].result = r;
+    nodes[n].resultStep = (int8_t)s;
+    return r;
+}
+
+
+void hashLife::advance(int k)
+{
+    if (nodes[root].pop == 0) {
+        gen += (uint64_t)1 << k;
+        return;
+    }
+
+    // Grow until the step fits and the pattern lies in the centre half, then once more so that it
+    // lies in the centre quarter and cannot grow out of the result during the step
+    while (nodes[root].level < k + 2 || !centred(root))
+        root = expand(root);
+    root = expand(root);
+
+    int64_t shift = (int64_t)1 << (nodes[root].level - 2);
+    root = successor(root, k);
+    originX += shift;
+    originY += shift;
+    gen += (uint64_t)1 << k;
+
+    // Shrink the root again while the pattern fits in its centre
+    while (nodes[root].level > 3 && centred(root)) {
+        int64_t half = (int64_t)1 << (nodes[root].level - 2);
+        root = centre(root);
+        originX += half;
+        originY += half;
+    }
+}
+
+
+void hashLife::step()
+{
+    advance(0);
+    recenterAfter(1);
+}
+
+
+void hashLife::run(uint64_t generations)
+{
+    for (int k = 63; k >= 0; k--)
+        if (generations >> k & 1)
+            advance(k);
+    recenterAfter(generations);
+}
+
+
+// Improves 'best' with the extreme live cell under n on the given side (0 west, 1 east, 2 south,
+// 3 north), visiting the children nearest that side first and skipping any that cannot do better
+void hashLife::extent(uint32_t n, int64_t x0, int64_t y0, int side, int64_t& best) const
+{
+    const hashNode& node = nodes[n];
+    int64_t size = (int64_t)1 << node.level;
+    int64_t lo = side < 2 ? x0 : y0;
+    bool high = side & 1;
+
+    if (node.pop == 0 || (!high && lo >= best) || (high && lo + size - 1 <= best))
+        return;
+    if (node.level == 0) {
+        best = lo;
+        return;
+    }
+
+    int64_t half = size / 2;
+    int bit = side < 2 ? 1 : 2;
+    for (int pass = 0; pass < 2; pass++) {
+        for (int q = 0; q < 4; q++)
+            if (((q & bit) != 0) == (high != (pass == 1)))
+                extent(node.child[q], x0 + (q & 1) * half, y0 + (q >> 1) * half, side, best);
+    }
+}
+
+
+bool hashLife::localBounds(int64_t& minX, int64_t& minY, int64_t& maxX, int64_t& maxY) const
+{
+    if (nodes[root].pop == 0)
+        return false;
+
+    minX = minY = INT64_MAX;
+    maxX = maxY = INT64_MIN;
+    extent(root, originX, originY, 0, minX);
+    extent(root, originX, originY, 1, maxX);
+    extent(root, originX, originY, 2, minY);
+    extent(root, originX, originY, 3, maxY);
+    return true;
+}
+
+
+void hashLife::shift(int64_t dx, int64_t dy)
+{
+    originX -= dx;
+    originY -= dy;
+}
+
+
+void hashLife::mark(uint32_t n)
+{
+    if (nodes[n].marked)
+        return;
+    nodes[n].marked = true;
+    if (nodes[n].level > 0)
+        for (int q = 0; q < 4; q++)
+            mark(nodes[n].child[q]);
+}
+
+
+void hashLife::collect()
+{
+    for (size_t i = 0; i < nodes.size(); i++)
+        nodes[i].marked = false;
+
+    mark(0);
+    mark(1);
+    if (root != NONE)
+        mark(root);
+    for (size_t i = 0; i < empties.size(); i++)
+        mark(empties[i]);
+    for (size_t i = 0; i < protect.size(); i++)
+        mark(protect[i]);
+
+    for (uint32_t i = 2; i < nodes.size(); i++) {
+        if (nodes[i].used && !nodes[i].marked) {
+            nodes[i].used = false;
+            nodes[i].next = freeList;
+            freeList = i;
+            liveNodes--;
+        }
+    }
+    for (size_t i = 0; i < nodes.size(); i++)
+        if (nodes[i].used && nodes[i].result != NONE && !nodes[nodes[i].result].marked)
+            nodes[i].result = NONE;
+
+    rehash(buckets.size());
+
+    // If most of the store is still live, let it grow rather than collecting on every new node
+    gcThreshold = std::max(nodeLimit, liveNodes + liveNodes / 2);
+}
+
+
+// Smallest interval of the int circle holding every value of V: it starts after the widest gap
+// between neighbouring values, taking the gap across the seam at +-2^31 when there is a tie, so a
+// pattern that does not cross the seam gets its plain box. Offsets from 'start' are then taken
+// modulo 2^32, like the other engines' local coordinates.
+static void cyclicExtent(const std::vector<int>& V, size_t n, int64_t& start, int64_t& span)
+{
+    // Flipping the sign bit makes the unsigned order the signed one
+    std::vector<uint32_t> keys(n);
+    for (size_t i = 0; i < n; i++)
+        keys[i] = (uint32_t)V[i] ^ 0x80000000u;
+    std::sort(keys.begin(), keys.end());
+
+    uint64_t widest = (uint64_t)keys[0] + ((uint64_t)1 << 32) - keys[n - 1];
+    size_t after = 0;
+    for (size_t i = 1; i < n; i++) {
+        if (keys[i] - keys[i - 1] > widest) {
+            widest = keys[i] - keys[i - 1];
+            after = i;
+        }
+    }
+
+    start = (int)(keys[after] ^ 0x80000000u);
+    span = ((int64_t)1 << 32) - (int64_t)widest + 1;
+}
+
+
+void hashLife::load(const std::vector<int>& X, const std::vector<int>& Y)
+{
+    struct item { int64_t x, y; uint32_t id; };
+
+    cellPairs cells(X, Y);
+    gen = 0;
+    originX = originY = 0;
+    root = empty(3);
+    if (cells.empty())
+        return;
+
+    int64_t minX, minY, spanX, spanY;
+    cyclicExtent(X, cells.size(), minX, spanX);
+    cyclicExtent(Y, cells.size(), minY, spanY);
+    int64_t span = std::max(spanX, spanY);
+
+    int level = 3;
+    while (((int64_t)1 << level) < span)
+        level++;
+
+    std::vector<item> items, parents;
+    items.reserve(cells.size());
+    for (cellCoord c : cells)
+        items.push_back(item{ (uint32_t)(c.x - minX), (uint32_t)(c.y - minY), 1 });
+
+    // Build the tree bottom up, grouping the nodes of each level by their parent's position
+    for (int l = 0; l < level; l++) {
+        std::sort(items.begin(), items.end(), [](const item& a, const item& b) {
+            return (a.y >> 1) != (b.y >> 1) ? (a.y >> 1) < (b.y >> 1) : a.x < b.x;
+        });
+
+        parents.clear();
+        uint32_t e = empty(l);
+        for (size_t i = 0; i < items.size();) {
+            int64_t px = items[i].x >> 1, py = items[i].y >> 1;
+            uint32_t c[4] = { e, e, e, e };
+            for (; i < items.size() && (items[i].x >> 1) == px && (items[i].y >> 1) == py; i++)
+                c[(items[i].y & 1) * 2 + (items[i].x & 1)] = items[i].id;
+
+            item p = { px, py, join(c[0], c[1], c[2], c[3]) };
+            parents.push_back(p);
+            protect.push_back(p.id);
+        }
+        protect.clear();
+        for (size_t i = 0; i < parents.size(); i++)
+            protect.push_back(parents[i].id);
+        items.swap(parents);
+    }
+    protect.clear();
+
+    root = items[0].id;
+    originX = minX;
+    originY = minY;
+}
+
+
+void hashLife::emit(uint32_t n, int64_t x0, int64_t y0, std::vector<int>& X, std::vector<int>& Y) const
+{
+    const hashNode& node = nodes[n];
+    if (node.pop == 0)
+        return;
+
+    if (node.level == 0) {
+        X.push_back((int)x0);
+        Y.push_back((int)y0);
+        return;
+    }
+
+    int64_t half = (int64_t)1 << (node.level - 1);
+    for (int q = 0; q < 4; q++)
+        emit(node.child[q], x0 + (q & 1) * half, y0 + (q >> 1) * half, X, Y);
+}
+
+
+void hashLife::store(std::vector<int>& X, std::vector<int>& Y) const
+{
+    X.clear();
+    Y.clear();
+    emit(root, originX, originY, X, Y);
+}
+
+
+size_t hashLife::population() const
+{
+    return (size_t)nodes[root].pop;
+}
+
+
+// Local coordinates wrap modulo 2^32 while the tree's do not, so right after a pattern across the seam
+// is loaded a region can meet the tree at more than one copy. Returns the copies of the region that
+// overlap the root.
+int hashLife::copiesOf(const cellRect& region, area copies[9]) const
+{
+    const int64_t TURN = (int64_t)1 << 32;
+    int64_t size = (int64_t)1 << nodes[root].level;
+    int count = 0;
+    if (region.minX > region.maxX || region.minY > region.maxY)
+        return 0;
+
+    for (int kx = -1; kx <= 1; kx++) {
+        for (int ky = -1; ky <= 1; ky++) {
+            area a = { region.minX + kx * TURN, region.minY + ky * TURN, region.maxX + kx * TURN, region.maxY + ky * TURN };
+            if (a.maxX >= originX && a.minX < originX + size && a.maxY >= originY && a.minY < originY + size)
+                copies[count++] = a;
+        }
+    }
+    return count;
+}
+
+
+uint64_t hashLife::countNode(uint32_t n, int64_t x0, int64_t y0, const area& a) const
+{
+    const hashNode& node = nodes[n];
+    int64_t size = (int64_t)1 << node.level;
+    if (node.pop == 0 || x0 > a.maxX || x0 + size - 1 < a.minX || y0 > a.maxY || y0 + size - 1 < a.minY)
+        return 0;
+    if (x0 >= a.minX && x0 + size - 1 <= a.maxX && y0 >= a.minY && y0 + size - 1 <= a.maxY)
+        return node.pop;
+
+    int64_t half = size / 2;
+    uint64_t total = 0;
+    for (int q = 0; q < 4; q++)
+        total += countNode(node.child[q], x0 + (q & 1) * half, y0 + (q >> 1) * half, a);
+    return total;
+}
+
+
+void hashLife::cellsNode(uint32_t n, int64_t x0, int64_t y0, const area& a, std::vector<int>& X, std::vector<int>& Y) const
+{
+    const hashNode& node = nodes[n];
+    int64_t size = (int64_t)1 << node.level;
+    if (node.pop == 0 || x0 > a.maxX || x0 + size - 1 < a.minX || y0 > a.maxY || y0 + size - 1 < a.minY)
+        return;
+    if (x0 >= a.minX && x0 + size - 1 <= a.maxX && y0 >= a.minY && y0 + size - 1 <= a.maxY) {
+        emit(n, x0, y0, X, Y);
+        return;
+    }
+
+    int64_t half = size / 2;
+    for (int q = 0; q < 4; q++)
+        cellsNode(node.child[q], x0 + (q & 1) * half, y0 + (q >> 1) * half, a, X, Y);
+}
+
+
+bool hashLife::alive(int x, int y) const
+{
+    return countIn(cellRect{ x, y, x, y }) > 0;
+}
+
+
+size_t hashLife::countIn(const cellRect& region) const
+{
+    area copies[9];
+    int count = copiesOf(region, copies);
+    uint64_t total = 0;
+    for (int k = 0; k < count; k++)
+        total += countNode(root, originX, originY, copies[k]);
+    return (size_t)total;
+}
+
+
+void hashLife::cellsIn(const cellRect& region, std::vector<int>& X, std::vector<int>& Y) const
+{
+    X.clear();
+    Y.clear();
+    area copies[9];
+    int count = copiesOf(region, copies);
+    for (int k = 0; k < count; k++)
+        cellsNode(root, originX, originY, copies[k], X, Y);
+}
+
+
+// Best first: nodes are taken in order of the distance from the point to their square, so the first
+// cell taken is the nearest. Distances are measured in the tree's coordinates.
+bool hashLife::nearest(int x, int y, int& nearX, int& nearY) const
+{
+    struct entry
+    {
+        uint64_t distance;
+        uint32_t node;
+        int64_t x0, y0;
+        bool operator>(const entry& other) const { return distance > other.distance; }
+    };
+    std::priority_queue<entry, std::vector<entry>, std::greater<entry>> queue;
+
+    // Cells are reported at their tree coordinate wrapped into the int range, and the distance to
+    // the point does not wrap. A cell's distance is exact; a node's is the least over the copies of
+    // the point a turn either side, which never exceeds the distance to any of its cells.
+    const int64_t TURN = (int64_t)1 << 32;
+    auto gap = [&](int64_t p, int64_t lo, int64_t size) {
+        int64_t best = INT64_MAX;
+        for (int k = -1; k <= 1; k++) {
+            int64_t q = p + k * TURN;
+            best = std::min(best, q < lo ? lo - q : (q > lo + size - 1 ? q - (lo + size - 1) : 0));
+        }
+        return best;
+    };
+    auto push = [&](uint32_t n, int64_t x0, int64_t y0) {
+        if (nodes[n].pop == 0)
+            return;
+        uint64_t d = nodes[n].level == 0 ? regionIndex::cellDistance((int)x0, (int)y0, x, y)
+            : regionIndex::distance(gap(x, x0, (int64_t)1 << nodes[n].level), gap(y, y0, (int64_t)1 << nodes[n].level));
+        queue.push(entry{ d, n, x0, y0 });
+    };
+
+    push(root, originX, originY);
+    while (!queue.empty()) {
+        entry e = queue.top();
+        queue.pop();
+        const hashNode& node = nodes[e.node];
+        if (node.level == 0) {
+            nearX = (int)e.x0;
+            nearY = (int)e.y0;
+            return true;
+        }
+        int64_t half = (int64_t)1 << (node.level - 1);
+        for (int q = 0; q < 4; q++)
+            push(node.child[q], e.x0 + (q & 1) * half, e.y0 + (q >> 1) * half);
+    }
+    return false;
+}
@@ -0,0 +1,102 @@
+#ifndef HASH_LIFE_H
+#define HASH_LIFE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "lifeEngine.h"
+#include "memoryPool.h"
+
+// Quadtree node. Level 0 nodes are single cells, a level k node covers a 2^k square. Children are
+// indexed (ybit << 1) | xbit, so child 0 is the south-west quadrant and child 3 the north-east.
+struct hashNode
+{
+    uint32_t child[4];
+    uint32_t result;      // Memoized successor, NONE if not computed
+    uint32_t next;        // Next node in the same hash bucket, or on the free list
+    uint64_t pop;
+    uint8_t level;
+    int8_t resultStep;    // log2 of the number of generations 'result' was advanced by
+    bool marked;
+    bool used;
+};
+
+// HashLife engine. Identical subtrees are stored once, and the centre of every node advanced by
+// 2^j generations is memoized on the node, so repetitive patterns can be advanced by 2^k generations
+// in time that grows far slower than 2^k. Nodes that are no longer reachable from the pattern are
+// reclaimed by a mark and sweep collector whenever the store grows past the memory limit.
+class hashLife : public lifeEngine
+{
+public:
+    static const uint32_t NONE = 0xFFFFFFFFu;
+
+    hashLife();
+
+    void load(const std::vector<int>& X, const std::vector<int>& Y) override;
+    void step() override;
+    void store(std::vector<int>& X, std::vector<int>& Y) const override;
+    size_t population() const override;
+    const char* name() const override { return "hashlife"; }
+    bool setRule(const lifeRule& rule) override;    // Two-state rules only
+
+    // Region queries walk the tree, taking whole the nodes inside the region and skipping the empty
+    // ones and those outside it by their population
+    bool alive(int x, int y) const override;
+    size_t countIn(const cellRect& region) const override;
+    void cellsIn(const cellRect& region, std::vector<int>& X, std::vector<int>& Y) const override;
+    bool nearest(int x, int y, int& nearX, int& nearY) const override;
+
+    void advance(int k);                      // Advance the pattern by 2^k generations
+    void run(uint64_t generations) override;  // One advance per set bit of 'generations'
+    uint64_t generation() const { return gen; }
+
+    void setMemoryLimit(size_t bytes);        // Size of the node cache before a collection runs
+    size_t nodeCount() const { return liveNodes; }
+    size_t memoryUsed() const { return nodes.bytes() + buckets.size() * sizeof(uint32_t); }
+    void collect();                           // Run the garbage collector now
+
+protected:
+    bool localBounds(int64_t& minX, int64_t& minY, int64_t& maxX, int64_t& maxY) const override;
+    void shift(int64_t dx, int64_t dy) override;
+
+private:
+    // Rectangle in the tree's 64-bit coordinates, corners included
+    struct area
+    {
+        int64_t minX, minY, maxX, maxY;
+    };
+
+    int copiesOf(const cellRect& region, area copies[9]) const;
+    uint64_t countNode(uint32_t n, int64_t x0, int64_t y0, const area& a) const;
+    void cellsNode(uint32_t n, int64_t x0, int64_t y0, const area& a, std::vector<int>& X, std::vector<int>& Y) const;
+
+    uint32_t join(uint32_t sw, uint32_t se, uint32_t nw, uint32_t ne);
+    uint32_t empty(int level);
+    uint32_t centre(uint32_t n);
+    uint32_t expand(uint32_t n);
+    uint32_t successor(uint32_t n, int j);
+    uint32_t baseStep(uint32_t n);
+    bool centred(uint32_t n) const;
+    void emit(uint32_t n, int64_t x0, int64_t y0, std::vector<int>& X, std::vector<int>& Y) const;
+    void extent(uint32_t n, int64_t x0, int64_t y0, int side, int64_t& best) const;
+
+    size_t bucketFor(const uint32_t* c) const;
+    void rehash(size_t count);
+    void mark(uint32_t n);
+
+    slabPool<hashNode, 14> nodes;    // Stable while the recursion holds references
+    std::vector<uint32_t> buckets;
+    std::vector<uint32_t> empties;
+    std::vector<uint32_t> protect;   // Nodes held by the recursion that the collector must keep
+    uint32_t freeList;
+    size_t liveNodes;
+    size_t nodeLimit;
+    size_t gcThreshold;
+
+    uint32_t root;
+    int64_t originX, originY;        // Coordinates of the south-west corner of the root
+    uint64_t gen;
+    uint32_t ruleMask;
+};
+
+#endif
@@ -0,0 +1,426 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   Command line options and the headless batch mode. A headless run never prompts or draws: it loads
+   the starting pattern, advances it with the chosen engine and reports how long each phase took,
+   followed by the final population, bounding box and throughput, so runs can be scripted and timed.
+
+   Example:
+      GameofLife2D --headless --pattern gun.rle --generations 100000 --engine t --threads 8 --save out.rle
+      GameofLife2D --headless --soup 512 --rule B36/S23 --generations 1000
+      GameofLife2D --headless --soup 1024 --engine t --generations 2000 --census
+      GameofLife2D --headless --soup 200 --topology klein --bounds 200x100 --generations 1000
+      GameofLife2D --headless --soup 512 --engine t --threads 4 --metrics gens.csv --trace trace.json
+      GameofLife2D --headless --soup 4096 --generations 1000000 --checkpoint run.ckpt
+      GameofLife2D --headless --resume run.ckpt --generations 1000000 --checkpoint run.ckpt
+      GameofLife2D --headless --3d --soup 160 --density 0.25 --rule 5766 --generations 100
+      GameofLife2D --3d --soup 40 --rule 4555 --slice 0 --fps 5
+      GameofLife2D --headless --species quadlife --soup 1024 --threads 4 --generations 1000
+      GameofLife2D --species immigration --soup 40 --fps 10
+      GameofLife2D --headless --stochastic B3/S23 --temperature 0.25 --bounds 1024x1024 --metrics thermal.csv
+      GameofLife2D --stochastic B3:0.9/S2:0.95,3 --bounds 40x40 --fps 10
+
+   With --metrics every generation is stepped on its own and read back, which slows the run down;
+   the timings in the file are those of the step itself. --census also steps one generation at a time
+   and times the census on its own.
+*/
+
+// Headers
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "headless.h"
+#include "lifeEngine.h"
+#include "benchmark.h"
+#include "patternIO.h"
+#include "cycleDetect.h"
+#include "lifeRule.h"
+#include "tileEngine.h"
+#include "metrics.h"
+#include "checkpoint.h"
+#include "census.h"
+
+
+typedef std::chrono::steady_clock timer;
+
+const size_t CENSUS_LINES = 10;    // Shapes listed by --census
+
+double msSince(timer::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(timer::now() - start).count();
+}
+
+
+bool parseOptions(int argc, char* argv[], runOptions& options)
+{
+    for (int a = 1; a < argc; a++) {
+        std::string arg = argv[a];
+        bool hasValue = a + 1 < argc;
+
+        if (arg == "--headless")
+            options.headless = true;
+        else if (arg == "--scaling") {
+            options.scaling = true;
+            if (hasValue && argv[a + 1][0] != '-')
+                options.engine = argv[++a][0];
+        }
+        else if (arg == "--benchmark") {
+            options.benchmark = true;
+            if (hasValue && argv[a + 1][0] != '-')
+                options.benchmarkFilter = argv[++a];
+        }
+        else if (arg == "--benchmark-out" && hasValue)
+            options.benchmarkOut = argv[++a];
+        else if (arg == "--benchmark-min-time" && hasValue)
+            options.minTime = atof(argv[++a]);
+        else if (arg == "--compare" && a + 2 < argc) {
+            options.compareBase = argv[++a];
+            options.compareNew = argv[++a];
+        }
+        else if (arg == "--threshold" && hasValue)
+            options.threshold = atof(argv[++a]);
+        else if (arg == "--pattern" && hasValue)
+            options.patternFile = argv[++a];
+        else if (arg == "--save" && hasValue)
+            options.saveFile = argv[++a];
+        else if (arg == "--soup" && hasValue)
+            options.soupSize = std::max(1, atoi(argv[++a]));
+        else if (arg == "--density" && hasValue)
+            options.density = atof(argv[++a]);
+        else if (arg == "--seed" && hasValue)
+            options.seed = (unsigned)strtoul(argv[++a], nullptr, 10);
+        else if (arg == "--generations" && hasValue)
+            options.generations = strtoull(argv[++a], nullptr, 10);
+        else if (arg == "--engine" && hasValue)
+            options.engine = argv[++a][0];
+        else if (arg == "--threads" && hasValue)
+            options.threads = std::max(1, atoi(argv[++a]));
+        else if (arg == "--stop-on-cycle")
+            options.stopOnCycle = true;
+        else if (arg == "--census")
+            options.census = true;
+        else if (arg == "--rule" && hasValue)
+            options.rule = argv[++a];
+        else if (arg == "--topology" && hasValue) {
+            if (!parseTopology(argv[++a], options.topo)) {
+                std::cout << "ERROR: Unknown topology " << argv[a] << ", use plane, torus, klein or walled.\n";
+                return false;
+            }
+        }
+        else if (arg == "--metrics" && hasValue)
+            options.metricsFile = argv[++a];
+        else if (arg == "--trace" && hasValue)
+            options.traceFile = argv[++a];
+        else if (arg == "--checkpoint" && hasValue)
+            options.checkpointFile = argv[++a];
+        else if (arg == "--checkpoint-every" && hasValue)
+            options.checkpointEvery = std::max<uint64_t>(1, strtoull(argv[++a], nullptr, 10));
+        else if (arg == "--resume" && hasValue)
+            options.resumeFile = argv[++a];
+        else if (arg == "--ensemble" && hasValue)
+            options.ensemble = strtoull(argv[++a], nullptr, 10);
+        else if (arg == "--ensemble-out" && hasValue)
+            options.ensembleOut = argv[++a];
+        else if (arg == "--3d")
+            options.threeD = true;
+        else if (arg == "--slice" && hasValue)
+            options.slice = atoi(argv[++a]);
+        else if (arg == "--species" && hasValue)
+            options.species = argv[++a];
+        else if (arg == "--stochastic" && hasValue)
+            options.stochastic = argv[++a];
+        else if (arg == "--temperature" && hasValue)
+            options.temperature = std::max(0.0, atof(argv[++a]));
+        else if (arg == "--fps" && hasValue)
+            options.fps = std::max(0.0, atof(argv[++a]));
+        else if (arg == "--bounds" && hasValue) {
+            if (sscanf(argv[++a], "%dx%d", &options.width, &options.height) != 2 || options.width < 1 || options.height < 1) {
+                std::cout << "ERROR: --bounds takes WIDTHxHEIGHT, e.g. 256x256.\n";
+                return false;
+            }
+        }
+        else {
+            std::cout << "ERROR: Unknown option or missing value: " << arg << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+
+std::unique_ptr<lifeEngine> makeEngine(const runOptions& options)
+{
+    if (options.topo != TOPOLOGY_PLANE)
+        return std::unique_ptr<lifeEngine>(new boundedEngine(options.topo, options.width, options.height));
+    return makeEngine(options.engine);
+}
+
+
+bool rejectFileOptions(const runOptions& options, const std::string& mode)
+{
+    const char* given = !options.patternFile.empty() ? "--pattern" : !options.saveFile.empty() ? "--save"
+        : !options.checkpointFile.empty() ? "--checkpoint" : !options.resumeFile.empty() ? "--resume" : nullptr;
+    if (given)
+        std::cout << "ERROR: " << mode << " runs start from a random soup and cannot take " << given << ".\n";
+    return given != nullptr;
+}
+
+
+int runHeadless(const runOptions& settings)
+{
+    runOptions options = settings;
+    std::vector<int> X, Y;
+    std::string ruleText = LIFE.name();
+    lifeRule rule;
+    int64_t originX = 0, originY = 0;
+    uint64_t firstGeneration = 0;
+
+    // Phase 1: read the starting pattern, or the checkpoint to resume from. A resumed run keeps the
+    // checkpoint's rule and universe unless they are given again.
+    timer::time_point start = timer::now();
+    if (!options.resumeFile.empty()) {
+        checkpointData state;
+        if (!loadCheckpoint(options.resumeFile, state, options.threads))
+            return 1;
+        X.swap(state.X);
+        Y.swap(state.Y);
+        ruleText = state.rule;
+        originX = state.originX;
+        originY = state.originY;
+        firstGeneration = state.generation;
+        if (options.topo == TOPOLOGY_PLANE) {
+            options.topo = state.topo;
+            options.width = state.width;
+            options.height = state.height;
+        }
+    }
+    else if (!options.patternFile.empty()) {
+        if (!loadPattern(options.patternFile, X, Y, ruleText, originX, originY)) {
+            std::cout << "ERROR: Could not read pattern file " << options.patternFile << "\n";
+            return 1;
+        }
+    }
+    else if (options.soupSize > 0)
+        randomSoup(options.soupSize, options.soupSize, options.density, options.seed, X, Y);
+    else {
+        std::cout << "ERROR: Headless mode needs --pattern FILE, --soup N or --resume FILE.\n";
+        return 1;
+    }
+    double readMs = msSince(start);
+
+    if (!options.rule.empty())
+        ruleText = options.rule;
+    if (!parseRule(ruleText, rule)) {
+        std::cout << "ERROR: Unknown rule '" << ruleText << "'.\n";
+        return 1;
+    }
+
+    std::unique_ptr<lifeEngine> engine = makeEngine(options);
+    if (!engine) {
+        std::cout << "ERROR: Unknown engine '" << options.engine << "', use s, t, h or m.\n";
+        return 1;
+    }
+    if (!engine->setRule(rule)) {
+        std::cout << "ERROR: The " << engine->name() << " engine cannot run " << rule.name() << ", use the sparse engine.\n";
+        return 1;
+    }
+    engine->setThreads(options.threads);
+
+    // Phase 2: hand the cells to the engine
+    start = timer::now();
+    engine->load(X, Y);
+    engine->setOrigin(originX, originY);
+    double loadMs = msSince(start);
+    size_t initial = engine->population();
+
+    // Phase 3: step. The population is sampled between chunks, outside the timed region, to estimate
+    // the number of cell updates per second. When watching for cycles every generation is checked from
+    // its births and deaths, or read back on engines that do not keep them, which is timed separately.
+    // With nothing to do between generations the whole count goes to the engine at once, so HashLife
+    // can take its largest jumps; with checkpoints the chunks end where the next one falls due.
+    double stepMs = 0, cycleMs = 0, cellGenerations = 0;
+    size_t population = initial;
+    uint64_t done = 0;
+    cycleDetector cycles;
+    bool repeated = false;
+
+    if (options.stopOnCycle)
+        cycles.update(X, Y, originX, originY);
+
+    metricsLog metrics;
+    if (!options.metricsFile.empty() && !metrics.open(options.metricsFile)) {
+        std::cout << "ERROR: Could not write " << options.metricsFile << "\n";
+        return 1;
+    }
+    if (!options.traceFile.empty())
+        startTrace();
+    clearMetrics();    // Drop what loading counted
+
+    // Checkpoints are handed to a background writer. One that falls due while the previous is still
+    // being written is put off until the chunk after it finishes, so the stepping never waits.
+    checkpointWriter checkpoints(options.checkpointFile);
+    uint64_t lastCheckpoint = 0;
+    size_t checkpointCount = 0;
+    double checkpointMs = 0;
+    auto checkpoint = [&]() {
+        start = timer::now();
+        checkpointData state;
+        state.generation = firstGeneration + done;
+        state.rule = rule.name();
+        state.topo = options.topo;
+        state.width = options.width;
+        state.height = options.height;
+        engine->origin(state.originX, state.originY);
+        engine->store(state.X, state.Y);
+        checkpoints.submit(state);
+        lastCheckpoint = done;
+        checkpointCount++;
+        checkpointMs += msSince(start);
+    };
+
+    // The census follows the engine's changes, so it needs every generation
+    objectCensus census;
+    double censusMs = 0;
+    if (options.census) {
+        start = timer::now();
+        census.reset(X, Y, originX, originY);
+        censusMs += msSince(start);
+    }
+
+    bool perGeneration = options.stopOnCycle || metrics.isOpen() || options.census;
+    while (done < options.generations && !repeated) {
+        uint64_t chunk = options.generations - done;
+        if (perGeneration)
+            chunk = 1;
+        else if (!options.checkpointFile.empty()) {
+            uint64_t since = done - lastCheckpoint;
+            chunk = std::min(chunk, since < options.checkpointEvery ? options.checkpointEvery - since : options.checkpointEvery);
+        }
+
+        start = timer::now();
+        {
+            METRIC_PHASE(PHASE_STEP);
+            engine->run(chunk);
+        }
+        stepMs += msSince(start);
+
+        size_t next = engine->population();
+        cellGenerations += 0.5 * ((double)population + (double)next) * chunk;
+        population = next;
+        done += chunk;
+
+        if (options.census) {
+            start = timer::now();
+            census.update(*engine);
+            censusMs += msSince(start);
+        }
+
+        if (options.stopOnCycle || metrics.isOpen()) {
+            start = timer::now();
+            if (options.stopOnCycle)
+                repeated = next == 0 || cycles.update(*engine);
+            if (metrics.isOpen()) {
+                engine->store(X, Y);
+                engine->origin(originX, originY);
+                metrics.record(measureGeneration(firstGeneration + done, X, Y, originX, originY));
+            }
+            cycleMs += msSince(start);
+        }
+
+        if (!options.checkpointFile.empty() && done - lastCheckpoint >= options.checkpointEvery && !checkpoints.busy())
+            checkpoint();
+    }
+    metrics.close();
+    if (!options.checkpointFile.empty()) {
+        checkpoints.wait();
+        if (lastCheckpoint != done || checkpointCount == 0)
+            checkpoint();
+        checkpoints.wait();
+        if (checkpoints.failed() > 0) {
+            std::cout << "ERROR: Could not write " << options.checkpointFile << "\n";
+            return 1;
+        }
+    }
+    if (!options.traceFile.empty() && !writeTrace(options.traceFile)) {
+        std::cout << "ERROR: Could not write " << options.traceFile << "\n";
+        return 1;
+    }
+
+    // Phase 4: read the final cells back out
+    start = timer::now();
+    engine->store(X, Y);
+    engine->origin(originX, originY);
+    double storeMs = msSince(start);
+
+    // Phase 5: save the final snapshot
+    double saveMs = 0;
+    if (!options.saveFile.empty()) {
+        start = timer::now();
+        if (!savePattern(options.saveFile, X, Y, rule.name(), originX, originY)) {
+            std::cout << "ERROR: Could not write " << options.saveFile << "\n";
+            return 1;
+        }
+        saveMs = msSince(start);
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "engine:          " << engine->name() << " (" << options.threads << " thread" << (options.threads == 1 ? "" : "s") << ")\n";
+    std::cout << "rule:            " << rule.name() << "\n";
+    if (options.topo != TOPOLOGY_PLANE)
+        std::cout << "universe:        " << topologyName(options.topo) << " " << options.width << "x" << options.height << "\n";
+    std::cout << "read pattern:    " << readMs << " ms\n";
+    std::cout << "engine load:     " << loadMs << " ms\n";
+    std::cout << "step:            " << stepMs << " ms\n";
+    if (options.stopOnCycle || metrics.isOpen())
+        std::cout << "read back:       " << cycleMs << " ms\n";
+    if (options.census)
+        std::cout << "census:          " << censusMs << " ms\n";
+    std::cout << "engine store:    " << storeMs << " ms\n";
+    if (!options.saveFile.empty())
+        std::cout << "save pattern:    " << saveMs << " ms\n";
+    if (!options.checkpointFile.empty())
+        std::cout << "checkpoints:     " << checkpointCount << " written, " << checkpointMs << " ms of stepping time\n";
+
+    if (firstGeneration > 0)
+        std::cout << "generations:     " << done << " (" << firstGeneration << " -> " << firstGeneration + done << ")\n";
+    else
+        std::cout << "generations:     " << done << "\n";
+    if (repeated && X.empty())
+        std::cout << "stopped:         all cells died\n";
+    else if (repeated)
+        std::cout << "stopped:         period " << cycles.period() << ", displacement (" << cycles.dx() << ", " << cycles.dy() << ")\n";
+    if (const tileEngine* tiles = dynamic_cast<const tileEngine*>(engine.get())) {
+        std::cout << "tiles:           " << tiles->tileCount() << " stored, last step " << tiles->activeTiles() << " computed, "
+            << tiles->stillTiles() << " still, " << tiles->period2Tiles() << " period 2\n";
+    }
+    std::cout << "population:      " << initial << " -> " << X.size() << "\n";
+    if (!X.empty()) {
+        std::cout << "bounding box:    x [" << originX + *std::min_element(X.begin(), X.end()) << ", " << originX + *std::max_element(X.begin(), X.end())
+            << "], y [" << originY + *std::min_element(Y.begin(), Y.end()) << ", " << originY + *std::max_element(Y.begin(), Y.end()) << "]\n";
+    }
+    else
+        std::cout << "bounding box:    empty\n";
+    if (options.census) {
+        std::vector<censusEntry> entries = census.tally();
+        std::cout << "objects:         " << census.objectCount() << " of " << entries.size() << " shapes\n";
+        for (size_t i = 0; i < entries.size() && i < CENSUS_LINES; i++)
+            std::cout << "  " << std::left << std::setw(20) << entries[i].name << std::setw(12) << kindName(entries[i].kind)
+                << std::right << entries[i].count << "\n";
+    }
+
+    double seconds = stepMs / 1000.0;
+    std::cout << std::setprecision(1);
+    std::cout << "generations/sec: " << (seconds > 0 ? done / seconds : 0) << "\n";
+    std::cout << "cells/sec:       " << (seconds > 0 ? cellGenerations / seconds : 0) << "\n";
+
+    return 0;
+}
@@ -0,0 +1,70 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "boundedEngine.h"
+
+// Settings taken from the command line
+struct runOptions
+{
+    bool headless = false;        // --headless: no prompts, no rendering, print a summary
+    bool scaling = false;         // --scaling [engine]: run the thread scaling benchmark
+    bool benchmark = false;       // --benchmark [filter]: run the benchmark suite
+    std::string benchmarkFilter;
+    std::string benchmarkOut;     // --benchmark-out FILE: JSON results
+    double minTime = 0.5;         // --benchmark-min-time S: seconds spent on each benchmark
+    std::string compareBase;      // --compare BASE NEW: list regressions between two result files
+    std::string compareNew;
+    double threshold = 5.0;       // --threshold PCT: slowdown reported as a regression
+    std::string patternFile;      // --pattern FILE (.rle, .cells or "x y" pairs)
+    std::string saveFile;         // --save FILE: write the final cells in the format of its extension
+    int soupSize = 0;             // --soup N: start from a random N x N soup instead of a file
+    double density = 0.35;        // --density D
+    unsigned seed = 1;            // --seed S
+    uint64_t generations = 1000;  // --generations N
+    char engine = 's';            // --engine s|t|h
+    int threads = 1;              // --threads N
+    bool stopOnCycle = false;     // --stop-on-cycle: stop once the pattern dies or repeats
+    bool census = false;          // --census: keep a census of the objects and print the most common
+    std::string rule;             // --rule R: e.g. B36/S23 or B2/S/C3, overrides the pattern file's rule
+    topology topo = TOPOLOGY_PLANE;   // --topology plane|torus|klein|walled
+    int width = 256;              // --bounds WxH: size of a bounded universe
+    int height = 256;
+    std::string metricsFile;      // --metrics FILE: per-generation timings and counters, .csv or .json
+    std::string traceFile;        // --trace FILE: Chrome trace-event file of the timed phases
+    std::string checkpointFile;   // --checkpoint FILE: write a binary checkpoint in the background
+    uint64_t checkpointEvery = 10000; // --checkpoint-every N: generations between checkpoints
+    std::string resumeFile;       // --resume FILE: start from a checkpoint instead of a pattern
+    uint64_t ensemble = 0;        // --ensemble N: run N small random soups to the end and classify them
+    std::string ensembleOut;      // --ensemble-out FILE: one CSV row per ensemble soup
+    bool threeD = false;          // --3d: run the 3D engine on a random --soup N cube, rule from --rule
+    int slice = 0;                // --slice Z: plane of the 3D universe drawn while it runs
+    std::string species;          // --species immigration|quadlife|N: run competing species on a random --soup N
+    std::string stochastic;       // --stochastic RULE: run a rule with probabilities, e.g. B3:0.9/S23, in a bounded universe
+    double temperature = 0;       // --temperature T: flip each outcome of the --stochastic rule with Boltzmann probability
+    double fps = 0;               // --fps N: run the interactive game on its own, drawing up to N frames a second
+};
+
+// Fills options from argv. Returns false, after printing why, if an option is not understood.
+bool parseOptions(int argc, char* argv[], runOptions& options);
+
+// Returns the engine selected by options.engine, or the bounded engine if a topology other than the
+// plane was chosen. Returns nullptr if the engine letter is not known.
+std::unique_ptr<lifeEngine> makeEngine(const runOptions& options);
+
+// The 3D, species and stochastic runs start from a random soup and write no cells, so they cannot
+// take --pattern, --save, --checkpoint or --resume. Returns true, after printing which option was
+// given, if one of them is set, so the run can stop rather than silently ignore it.
+bool rejectFileOptions(const runOptions& options, const std::string& mode);
+
+// Milliseconds since 'start', for the phase timings the runs print
+double msSince(std::chrono::steady_clock::time_point start);
+
+// Loads the pattern, runs it for the requested number of generations and prints per-phase timings
+// and a summary. Returns the process exit code.
+int runHeadless(const runOptions& options);
+
+#endif
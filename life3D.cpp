@@ -0,0 +1,562 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   The 3D engine. Counting 26 neighbours one cell at a time is 26 reads per cell; here the count is
+   split into two sums that each work on a whole 8x8 z slice of a brick as one 64-bit word:
+
+      pass 1   for every brick and z slice, the sum over the 3x3 xy neighbourhood of each cell. The
+               west and east neighbours are the slice shifted by one bit, with the edge columns
+               filled in from the bricks either side, and three cells are added with a full adder
+               into two bit planes. Those two-plane sums are then shifted by a row, the edge rows
+               taken from the bricks north and south, and three of them added into four planes
+               (0 to 9).
+      pass 2   for every brick and z slice, the four-plane sums of the slices below, at and above it,
+               the outer two from the bricks below and above at the brick faces, added into five
+               planes (0 to 27). The count includes the cell itself, so a live cell survives with a
+               total of n + 1 for every survival count n.
+
+   The first pass keeps its sums, 32 words a brick, so each xy sum is formed once and read by the
+   brick itself and the bricks above and below it. A brick and its sums fit in a few cache lines,
+   and the bricks of one batch are neighbours in memory.
+
+   After a step every non-empty brick gets the neighbours it is missing, and every SWEEP_INTERVAL
+   steps bricks that are empty with an empty neighbourhood are dropped.
+*/
+
+// Headers
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "life3D.h"
+#include "benchmark.h"
+#include "metrics.h"
+
+
+const int BRICK_RANGE = 1 << 20;
+const size_t BRICK_BATCH = 64;
+const uint64_t SWEEP_INTERVAL = 64;
+const int GRIDSIZE_3D = 40;    // Side of the slice drawn by run3D
+const int SELF = 13;    // Index of the brick itself in nb
+const int BELOW = 4;    // dz = -1, dy = dx = 0
+const int ABOVE = 22;   // dz = +1, dy = dx = 0
+
+const uint64_t WEST_COLUMN = 0x0101010101010101ull;    // x = 0 of every row
+const uint64_t EAST_COLUMN = 0x8080808080808080ull;    // x = 7 of every row
+
+
+// Brick coordinate modulo 2^21
+static inline int wrapBrick(int b)
+{
+    return (int)(((uint32_t)b + BRICK_RANGE) & (2 * BRICK_RANGE - 1)) - BRICK_RANGE;
+}
+
+
+static inline uint64_t brickKey(int bx, int by, int bz)
+{
+    const uint64_t MASK = 2 * BRICK_RANGE - 1;
+    return ((uint64_t)bx & MASK) << 42 | ((uint64_t)by & MASK) << 21 | ((uint64_t)bz & MASK);
+}
+
+
+static std::string countList(uint32_t counts)
+{
+    std::string text;
+    for (int n = 0; n <= 26; n++) {
+        if (!(counts >> n & 1))
+            continue;
+        int last = n;
+        while (last < 26 && counts >> (last + 1) & 1)
+            last++;
+        if (!text.empty())
+            text += ",";
+        text += std::to_string(n);
+        if (last > n)
+            text += "-" + std::to_string(last);
+        n = last;
+    }
+    return text;
+}
+
+
+std::string lifeRule3D::name() const
+{
+    return "B" + countList(birth) + "/S" + countList(survive);
+}
+
+
+// Parses "4,6-9" into a mask of counts. Returns false on anything else.
+static bool parseCountList(const std::string& text, uint32_t& counts)
+{
+    counts = 0;
+    size_t at = 0;
+    while (at < text.size()) {
+        size_t end = text.find(',', at);
+        if (end == std::string::npos)
+            end = text.size();
+        std::string item = text.substr(at, end - at);
+        size_t dash = item.find('-');
+        std::string low = item.substr(0, dash), high = dash == std::string::npos ? low : item.substr(dash + 1);
+        if (low.empty() || high.empty() || low.find_first_not_of("0123456789") != std::string::npos
+            || high.find_first_not_of("0123456789") != std::string::npos)
+            return false;
+
+        int from = atoi(low.c_str()), to = atoi(high.c_str());
+        if (from > to || to > 26)
+            return false;
+        for (int n = from; n <= to; n++)
+            counts |= 1u << n;
+        at = end + 1;
+    }
+    return true;
+}
+
+
+static uint32_t countRange(int from, int to)
+{
+    uint32_t counts = 0;
+    for (int n = from; n <= to; n++)
+        counts |= 1u << n;
+    return counts;
+}
+
+
+bool parseRule3D(const std::string& input, lifeRule3D& rule)
+{
+    std::string text;
+    for (char c : input)
+        if (c != ' ')
+            text += (char)toupper((unsigned char)c);
+
+    lifeRule3D parsed = { 0, 0 };
+    if (!text.empty() && text[0] == 'B') {
+        size_t slash = text.find("/S");
+        if (slash == std::string::npos || !parseCountList(text.substr(1, slash - 1), parsed.birth)
+            || !parseCountList(text.substr(slash + 2), parsed.survive))
+            return false;
+    }
+    else {
+        // Bays' notation: survival low and high, birth low and high
+        int n[4];
+        if (text.find(',') != std::string::npos) {
+            if (sscanf(text.c_str(), "%d,%d,%d,%d", &n[0], &n[1], &n[2], &n[3]) != 4)
+                return false;
+        }
+        else {
+            if (text.size() != 4 || text.find_first_not_of("0123456789") != std::string::npos)
+                return false;
+            for (int i = 0; i < 4; i++)
+                n[i] = text[i] - '0';
+        }
+        for (int i = 0; i < 4; i++)
+            if (n[i] < 0 || n[i] > 26)
+                return false;
+        if (n[0] > n[1] || n[2] > n[3])
+            return false;
+        parsed.survive = countRange(n[0], n[1]);
+        parsed.birth = countRange(n[2], n[3]);
+    }
+
+    if (parsed.birth & 1)
+        return false;
+    rule = parsed;
+    return true;
+}
+
+
+life3D::life3D() : rule(LIFE_4555), cur(0), steps(0)
+{
+}
+
+
+// Adds an empty brick and links it with its neighbours. Returns its index.
+int life3D::addBrick(int bx, int by, int bz)
+{
+    int index = (int)bricks.push();
+
+    lifeBrick& b = bricks[index];
+    b.bx = bx;
+    b.by = by;
+    b.bz = bz;
+    b.empty[0] = b.empty[1] = true;
+    dir.insertKey(brickKey(bx, by, bz), index);
+
+    for (int k = 0; k < 27; k++) {
+        int j = k == SELF ? index : dir.findKey(brickKey(wrapBrick(bx + k % 3 - 1), wrapBrick(by + k / 3 % 3 - 1), wrapBrick(bz + k / 9 - 1)));
+        b.nb[k] = j;
+        if (j >= 0)
+            bricks[j].nb[26 - k] = index;
+    }
+    return index;
+}
+
+
+// Adds whatever neighbours brick i is missing
+void life3D::surround(size_t i)
+{
+    int bx = bricks[i].bx, by = bricks[i].by, bz = bricks[i].bz;
+    for (int k = 0; k < 27; k++)
+        if (bricks[i].nb[k] < 0)
+            addBrick(wrapBrick(bx + k % 3 - 1), wrapBrick(by + k / 3 % 3 - 1), wrapBrick(bz + k / 9 - 1));
+}
+
+
+void life3D::load(const std::vector<int>& X, const std::vector<int>& Y, const std::vector<int>& Z)
+{
+    size_t n = std::min(X.size(), std::min(Y.size(), Z.size()));
+
+    bricks.clear();
+    dir.reset(n / 16);
+    cur = 0;
+    steps = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        int bx = wrapBrick(X[i] >> 3), by = wrapBrick(Y[i] >> 3), bz = wrapBrick(Z[i] >> 3);
+        int index = dir.findKey(brickKey(bx, by, bz));
+        if (index < 0)
+            index = addBrick(bx, by, bz);
+        bricks[index].slices[cur][Z[i] & 7] |= 1ull << ((Y[i] & 7) * 8 + (X[i] & 7));
+        bricks[index].empty[cur] = false;
+    }
+
+    size_t loaded = bricks.size();
+    for (size_t i = 0; i < loaded; i++)
+        if (!bricks[i].empty[cur])
+            surround(i);
+}
+
+
+// Sum of the west neighbour, the cell and the east neighbour of every cell of a slice, as two bit
+// planes. w and e are the same slice of the bricks to the west and east.
+static inline void rowSum(uint64_t c, uint64_t w, uint64_t e, uint64_t& s0, uint64_t& s1)
+{
+    uint64_t west = ((c << 1) & ~WEST_COLUMN) | ((w >> 7) & WEST_COLUMN);
+    uint64_t east = ((c >> 1) & ~EAST_COLUMN) | ((e << 7) & EAST_COLUMN);
+    uint64_t half = west ^ c;
+    s0 = half ^ east;
+    s1 = (west & c) | (half & east);
+}
+
+
+// First pass: the 3x3 xy sums of every z slice of brick i
+void life3D::sumSlices(size_t i)
+{
+    const lifeBrick& b = bricks[i];
+    uint64_t* out = &sums[i * 4 * BRICK];
+
+    const lifeBrick* around[9];
+    bool any = false;
+    for (int k = 0; k < 9; k++) {
+        int j = b.nb[9 + k];
+        around[k] = j >= 0 && !bricks[j].empty[cur] ? &bricks[j] : nullptr;
+        any |= around[k] != nullptr;
+    }
+    if (!any) {
+        memset(out, 0, 4 * BRICK * sizeof(uint64_t));
+        return;
+    }
+
+    for (int z = 0; z < BRICK; z++) {
+        uint64_t word[9];
+        for (int k = 0; k < 9; k++)
+            word[k] = around[k] ? around[k]->slices[cur][z] : 0;
+
+        // Row sums of the bricks south (dy = -1), level and north, then rows y - 1 and y + 1 of the
+        // level sums brought in line with row y
+        uint64_t south0, south1, mid0, mid1, north0, north1;
+        rowSum(word[1], word[0], word[2], south0, south1);
+        rowSum(word[4], word[3], word[5], mid0, mid1);
+        rowSum(word[7], word[6], word[8], north0, north1);
+
+        uint64_t down0 = (mid0 << 8) | (south0 >> 56), down1 = (mid1 << 8) | (south1 >> 56);
+        uint64_t up0 = (mid0 >> 8) | (north0 << 56), up1 = (mid1 >> 8) | (north1 << 56);
+
+        // Three two-bit numbers into four bits
+        uint64_t h0 = mid0 ^ down0;
+        uint64_t bit0 = h0 ^ up0;
+        uint64_t carry0 = (mid0 & down0) | (h0 & up0);
+        uint64_t h1 = mid1 ^ down1;
+        uint64_t twos = h1 ^ up1;
+        uint64_t carry1 = (mid1 & down1) | (h1 & up1);
+        uint64_t bit1 = twos ^ carry0;
+        uint64_t fours = twos & carry0;
+
+        uint64_t* planes = out + 4 * z;
+        planes[0] = bit0;
+        planes[1] = bit1;
+        planes[2] = carry1 ^ fours;
+        planes[3] = carry1 & fours;
+    }
+}
+
+
+// Second pass: adds the xy sums of the slices below and above and applies the rule
+void life3D::computeBrick(size_t i)
+{
+    static const uint64_t none[4 * BRICK] = {};
+    lifeBrick& b = bricks[i];
+    int next = cur ^ 1;
+
+    const uint64_t* own = &sums[i * 4 * BRICK];
+    const uint64_t* below = b.nb[BELOW] >= 0 ? &sums[(size_t)b.nb[BELOW] * 4 * BRICK] : none;
+    const uint64_t* above = b.nb[ABOVE] >= 0 ? &sums[(size_t)b.nb[ABOVE] * 4 * BRICK] : none;
+
+    // Totals, cell included, that leave a cell alive whichever its state, only if alive, only if dead
+    uint32_t either = (rule.survive << 1) & rule.birth;
+    uint32_t ifAlive = (rule.survive << 1) & ~rule.birth;
+    uint32_t ifDead = rule.birth & ~(rule.survive << 1);
+
+    uint64_t any = 0;
+    for (int z = 0; z < BRICK; z++) {
+        const uint64_t* a = z > 0 ? own + 4 * (z - 1) : below + 4 * (BRICK - 1);
+        const uint64_t* m = own + 4 * z;
+        const uint64_t* c = z < BRICK - 1 ? own + 4 * (z + 1) : above;
+
+        // Carry-save: three four-bit numbers into a sum and a carry word per plane, then one ripple add
+        uint64_t s[4], k[4];
+        for (int p = 0; p < 4; p++) {
+            uint64_t h = a[p] ^ m[p];
+            s[p] = h ^ c[p];
+            k[p] = (a[p] & m[p]) | (h & c[p]);
+        }
+        uint64_t t[5];
+        t[0] = s[0];
+        t[1] = s[1] ^ k[0];
+        uint64_t r = s[1] & k[0];
+        uint64_t h2 = s[2] ^ k[1];
+        t[2] = h2 ^ r;
+        r = (s[2] & k[1]) | (h2 & r);
+        uint64_t h3 = s[3] ^ k[2];
+        t[3] = h3 ^ r;
+        r = (s[3] & k[2]) | (h3 & r);
+        t[4] = k[3] ^ r;
+
+        uint64_t alive = b.slices[cur][z];
+        uint64_t born = 0, kept = 0, fixed = 0;
+        for (int n = 1; n <= 27; n++) {
+            uint32_t bit = 1u << n;
+            if (!((either | ifAlive | ifDead) & bit))
+                continue;
+            uint64_t eq = ~0ull;
+            for (int p = 0; p < 5; p++)
+                eq &= n >> p & 1 ? t[p] : ~t[p];
+            if (either & bit)
+                fixed |= eq;
+            else if (ifAlive & bit)
+                kept |= eq;
+            else
+                born |= eq;
+        }
+
+        uint64_t result = fixed | (kept & alive) | (born & ~alive);
+        b.slices[next][z] = result;
+        any |= result;
+    }
+    b.empty[next] = any == 0;
+}
+
+
+void life3D::step()
+{
+    size_t count = bricks.size();
+    size_t batches = (count + BRICK_BATCH - 1) / BRICK_BATCH;
+    if (sums.size() < count * 4 * BRICK) {
+        METRIC_ADD(COUNTER_ALLOCATIONS, 1);
+        sums.resize(count * 4 * BRICK + count * 2 * BRICK);
+    }
+
+    pool.run(batches, [&](size_t batch) {
+        METRIC_PHASE(PHASE_COUNT);
+        size_t end = std::min(count, (batch + 1) * BRICK_BATCH);
+        for (size_t i = batch * BRICK_BATCH; i < end; i++)
+            sumSlices(i);
+    });
+    pool.run(batches, [&](size_t batch) {
+        METRIC_PHASE(PHASE_RULE);
+        size_t end = std::min(count, (batch + 1) * BRICK_BATCH);
+        for (size_t i = batch * BRICK_BATCH; i < end; i++)
+            computeBrick(i);
+    });
+
+    METRIC_PHASE(PHASE_COMMIT);
+    cur ^= 1;
+    if (++steps % SWEEP_INTERVAL == 0)
+        sweep();
+    count = bricks.size();
+    for (size_t i = 0; i < count; i++)
+        if (!bricks[i].empty[cur])
+            surround(i);
+}
+
+
+void life3D::run(uint64_t generations)
+{
+    for (uint64_t g = 0; g < generations; g++)
+        step();
+}
+
+
+// Drops the bricks that are empty and have no live neighbour, then relinks the rest
+void life3D::sweep()
+{
+    std::vector<char> keep(bricks.size(), 0);
+    for (size_t i = 0; i < bricks.size(); i++) {
+        if (bricks[i].empty[cur])
+            continue;
+        for (int k = 0; k < 27; k++)
+            if (bricks[i].nb[k] >= 0)
+                keep[bricks[i].nb[k]] = 1;
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < bricks.size(); i++)
+        if (keep[i])
+            bricks[kept++] = bricks[i];
+    if (kept == bricks.size())
+        return;
+
+    bricks.resize(kept);
+    dir.reset(kept);
+    for (size_t i = 0; i < kept; i++)
+        dir.insertKey(brickKey(bricks[i].bx, bricks[i].by, bricks[i].bz), (int)i);
+    for (size_t i = 0; i < kept; i++) {
+        lifeBrick& b = bricks[i];
+        for (int k = 0; k < 27; k++)
+            b.nb[k] = dir.findKey(brickKey(wrapBrick(b.bx + k % 3 - 1), wrapBrick(b.by + k / 3 % 3 - 1), wrapBrick(b.bz + k / 9 - 1)));
+    }
+}
+
+
+void life3D::store(std::vector<int>& X, std::vector<int>& Y, std::vector<int>& Z) const
+{
+    X.clear();
+    Y.clear();
+    Z.clear();
+
+    for (size_t i = 0; i < bricks.size(); i++) {
+        const lifeBrick& b = bricks[i];
+        if (b.empty[cur])
+            continue;
+        for (int z = 0; z < BRICK; z++) {
+            uint64_t bits = b.slices[cur][z];
+            for (int bit = 0; bits; bit++, bits >>= 1) {
+                if (bits & 1) {
+                    X.push_back(b.bx * BRICK + (bit & 7));
+                    Y.push_back(b.by * BRICK + (bit >> 3));
+                    Z.push_back(b.bz * BRICK + z);
+                }
+            }
+        }
+    }
+}
+
+
+size_t life3D::population() const
+{
+    size_t pop = 0;
+    for (size_t i = 0; i < bricks.size(); i++)
+        if (!bricks[i].empty[cur])
+            for (int z = 0; z < BRICK; z++)
+                pop += std::bitset<64>(bricks[i].slices[cur][z]).count();
+    return pop;
+}
+
+
+void life3D::slice(int z, std::vector<int>& X, std::vector<int>& Y) const
+{
+    X.clear();
+    Y.clear();
+
+    int bz = wrapBrick(z >> 3);
+    for (size_t i = 0; i < bricks.size(); i++) {
+        const lifeBrick& b = bricks[i];
+        if (b.bz != bz || b.empty[cur])
+            continue;
+        uint64_t bits = b.slices[cur][z & 7];
+        for (int bit = 0; bits; bit++, bits >>= 1) {
+            if (bits & 1) {
+                X.push_back(b.bx * BRICK + (bit & 7));
+                Y.push_back(b.by * BRICK + (bit >> 3));
+            }
+        }
+    }
+}
+
+
+void drawSlice(const life3D& world, int z, frameRenderer& screen)
+{
+    std::vector<int> X, Y;
+    world.slice(z, X, Y);
+    screen.draw(X, Y);
+}
+
+
+int run3D(const runOptions& options)
+{
+    typedef std::chrono::steady_clock timer;
+
+    if (rejectFileOptions(options, "3D"))
+        return 1;
+    lifeRule3D rule = LIFE_4555;
+    if (!options.rule.empty() && !parseRule3D(options.rule, rule)) {
+        std::cout << "ERROR: Unknown 3D rule '" << options.rule << "', e.g. 4555 or B6/S5-7.\n";
+        return 1;
+    }
+
+    std::vector<int> X, Y, Z;
+    int side = options.soupSize > 0 ? options.soupSize : 64;
+    randomCube(side, options.density, options.seed, X, Y, Z);
+
+    life3D world;
+    world.setRule(rule);
+    world.setThreads(options.threads);
+    std::chrono::steady_clock::time_point start = timer::now();
+    world.load(X, Y, Z);
+    double loadMs = msSince(start);
+    size_t initial = world.population();
+
+    if (!options.headless) {
+        frameRenderer screen(GRIDSIZE_3D, true);
+        double fps = options.fps > 0 ? options.fps : 10;
+        for (uint64_t g = 0; ; g++) {
+            drawSlice(world, options.slice, screen);
+            std::cout << "Generation " << g << ", slice z = " << options.slice << ", " << world.population() << " cells\x1b[K" << std::flush;
+            if (g == options.generations)
+                break;
+            std::this_thread::sleep_for(std::chrono::duration<double>(1.0 / fps));
+            world.step();
+        }
+        std::cout << "\n";
+        return 0;
+    }
+
+    start = timer::now();
+    world.run(options.generations);
+    double stepMs = msSince(start);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "engine:          3d bricks (" << options.threads << " thread" << (options.threads == 1 ? "" : "s") << ")\n";
+    std::cout << "rule:            " << rule.name() << "\n";
+    std::cout << "engine load:     " << loadMs << " ms\n";
+    std::cout << "step:            " << stepMs << " ms\n";
+    std::cout << "generations:     " << options.generations << "\n";
+    std::cout << "bricks:          " << world.brickCount() << "\n";
+    std::cout << "population:      " << initial << " -> " << world.population() << "\n";
+
+    double seconds = stepMs / 1000.0;
+    std::cout << std::setprecision(1);
+    std::cout << "generations/sec: " << (seconds > 0 ? options.generations / seconds : 0) << "\n";
+    return 0;
+}
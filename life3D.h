@@ -0,0 +1,97 @@
+#ifndef LIFE_3D_H
+#define LIFE_3D_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "drawGrid.h"
+#include "headless.h"
+#include "memoryPool.h"
+#include "threadPool.h"
+#include "tileEngine.h"
+
+// Outer totalistic rule on the 26-cell 3D Moore neighbourhood. Bit n of 'birth' is set if a dead
+// cell with n live neighbours comes alive, bit n of 'survive' if a live cell with n stays alive.
+struct lifeRule3D
+{
+    uint32_t birth;
+    uint32_t survive;
+
+    std::string name() const;    // Canonical form, e.g. "B5/S4-5"
+
+    bool operator==(const lifeRule3D& other) const { return birth == other.birth && survive == other.survive; }
+};
+
+const lifeRule3D LIFE_4555 = { 1u << 5, (1u << 4) | (1u << 5) };
+
+// Parses Bays' notation "4555" or "4,5,5,5" (survival from the first to the second count, birth
+// from the third to the fourth) or "B5/S4-5" with counts and ranges separated by commas, e.g.
+// "B6/S5-7" or "B5,8/S4,6-9". Rules with birth on 0 are rejected. Returns false if the text is not
+// a 3D rule.
+bool parseRule3D(const std::string& text, lifeRule3D& rule);
+
+const int BRICK = 8;
+
+// One 8x8x8 block of the universe. Bit 8 y + x of slices[p][z] is the cell (8 bx + x, 8 by + y,
+// 8 bz + z), so a z slice is one machine word. As in the tile engine the brick holds two
+// generations and the engine's parity selects the current one.
+struct lifeBrick
+{
+    int bx, by, bz;
+    uint64_t slices[2][BRICK];
+    int nb[27];           // Bricks of the 3x3x3 neighbourhood, index 9 (dz + 1) + 3 (dy + 1) + dx + 1, -1 if absent
+    bool empty[2];
+};
+
+// Sparse 3D engine storing the live cells in bit-packed 8x8x8 bricks found through a tileDirectory.
+// Every non-empty brick has all 26 of its neighbours present, so every cell that could be born lies
+// in a stored brick. The 26-neighbour count is separable: each step first sums every z slice over
+// its 3x3 xy neighbourhood with bit-parallel adders, and then adds the sums of the slices above and
+// below. Both passes work a brick at a time on whole 64-cell slices, run in parallel batches on the
+// work-stealing pool, and read nothing but the current generation and the first pass's sums.
+//
+// Brick coordinates wrap at 2^21, which makes the universe a torus 2^24 cells across on each axis.
+class life3D
+{
+public:
+    life3D();
+
+    void load(const std::vector<int>& X, const std::vector<int>& Y, const std::vector<int>& Z);
+    void step();
+    void run(uint64_t generations);
+    void store(std::vector<int>& X, std::vector<int>& Y, std::vector<int>& Z) const;
+    size_t population() const;
+    void setThreads(int threads) { pool.resize(threads); }
+    void setRule(const lifeRule3D& newRule) { rule = newRule; }
+    const lifeRule3D& getRule() const { return rule; }
+
+    // The live cells of the plane z, for drawing
+    void slice(int z, std::vector<int>& X, std::vector<int>& Y) const;
+
+    size_t brickCount() const { return bricks.size(); }
+
+private:
+    int addBrick(int bx, int by, int bz);
+    void surround(size_t i);
+    void sweep();
+    void sumSlices(size_t i);
+    void computeBrick(size_t i);
+
+    slabPool<lifeBrick, 6> bricks;    // 64 bricks per slab
+    tileDirectory dir;
+    std::vector<uint64_t> sums;       // Per brick and z slice, the four bit planes of the 3x3 xy sum
+    lifeRule3D rule;
+    int cur;
+    uint64_t steps;
+    threadPool pool;
+};
+
+// Draws the plane z of the universe with a frameRenderer
+void drawSlice(const life3D& world, int z, frameRenderer& screen);
+
+// Runs the 3D engine on a random cube. With --headless it prints timings and a summary, otherwise it
+// draws the plane --slice of every generation. Returns the process exit code.
+int run3D(const runOptions& options);
+
+#endif
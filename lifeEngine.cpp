@@ -0,0 +1,295 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   Engine selection and the sparse and sorted engine wrappers. The sparse engine keeps the live cells in the same
+   X/Y vectors as the rest of the program and advances them with calcState. Under a Generations rule
+   it also keeps the state of every cell, and only the live ones are exported.
+
+   Recentering: a pattern grows at most one cell per generation in each direction, so after a check
+   that finds every cell within 'reach' of the local origin nothing can pass RECENTER_LIMIT for
+   another RECENTER_LIMIT - reach generations, and the next check is scheduled then. A check that
+   finds a cell beyond RECENTER_AT moves the origin to the middle of the bounding box. Only a pattern
+   whose own extent passes 2^31 cannot be brought back, and its local coordinates then wrap as
+   described in calcState.cpp.
+*/
+
+// Headers
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include "lifeEngine.h"
+#include "calcState.h"
+#include "tileEngine.h"
+#include "hashLife.h"
+
+
+// Distance from the origin past which the pattern is moved back, and the distance it must never pass
+const int64_t RECENTER_AT = (int64_t)1 << 30;
+const int64_t RECENTER_LIMIT = ((int64_t)1 << 31) - 4096;
+
+
+void lifeEngine::recenter()
+{
+    int64_t minX, minY, maxX, maxY;
+    if (!localBounds(minX, minY, maxX, maxY)) {
+        untilCheck = RECENTER_LIMIT;
+        return;
+    }
+
+    int64_t reach = std::max(std::max(-minX, maxX), std::max(-minY, maxY));
+    if (reach > RECENTER_AT) {
+        // Multiples of 64 keep the tile engine's tiles aligned
+        int64_t dx = ((minX + maxX) / 2) & ~(int64_t)63;
+        int64_t dy = ((minY + maxY) / 2) & ~(int64_t)63;
+
+        shift(dx, dy);
+        chunkX += dx;
+        chunkY += dy;
+        minX -= dx;
+        maxX -= dx;
+        minY -= dy;
+        maxY -= dy;
+        reach = std::max(std::max(-minX, maxX), std::max(-minY, maxY));
+    }
+
+    // A pattern wider than the int range stays where it is and is looked at again much later
+    untilCheck = reach > RECENTER_AT ? RECENTER_AT : RECENTER_LIMIT - reach;
+}
+
+
+bool lifeEngine::alive(int x, int y) const
+{
+    std::vector<int> X, Y;
+    store(X, Y);
+    for (size_t i = 0; i < X.size(); i++)
+        if (X[i] == x && Y[i] == y)
+            return true;
+    return false;
+}
+
+
+size_t lifeEngine::countIn(const cellRect& region) const
+{
+    std::vector<int> X, Y;
+    store(X, Y);
+    size_t count = 0;
+    for (size_t i = 0; i < X.size(); i++)
+        count += region.contains(X[i], Y[i]);
+    return count;
+}
+
+
+void lifeEngine::cellsIn(const cellRect& region, std::vector<int>& X, std::vector<int>& Y) const
+{
+    std::vector<int> allX, allY;
+    store(allX, allY);
+    X.clear();
+    Y.clear();
+    for (size_t i = 0; i < allX.size(); i++) {
+        if (region.contains(allX[i], allY[i])) {
+            X.push_back(allX[i]);
+            Y.push_back(allY[i]);
+        }
+    }
+}
+
+
+bool lifeEngine::nearest(int x, int y, int& nearX, int& nearY) const
+{
+    std::vector<int> X, Y;
+    store(X, Y);
+    uint64_t best = 0;
+    for (size_t i = 0; i < X.size(); i++) {
+        uint64_t d = regionIndex::cellDistance(X[i], Y[i], x, y);
+        if (i == 0 || d < best) {
+            best = d;
+            nearX = X[i];
+            nearY = Y[i];
+        }
+    }
+    return !X.empty();
+}
+
+
+void sparseEngine::load(const std::vector<int>& X, const std::vector<int>& Y)
+{
+    // Kept the same length from here on, so the rest of the engine needs no guard
+    size_t n = cellPairs(X, Y).size();
+    cellX.assign(X.begin(), X.begin() + n);
+    cellY.assign(Y.begin(), Y.begin() + n);
+    cellS.assign(n, 1);
+    indexed = false;
+}
+
+
+void sparseEngine::step()
+{
+    if (rule.generations())
+        calcState(cellX, cellY, cellS, rule);
+    else
+        calcState(cellX, cellY, pool, rule);
+    indexed = false;
+    recenterAfter(1);
+}
+
+
+bool sparseEngine::localBounds(int64_t& minX, int64_t& minY, int64_t& maxX, int64_t& maxY) const
+{
+    if (cellX.empty())
+        return false;
+
+    minX = *std::min_element(cellX.begin(), cellX.end());
+    maxX = *std::max_element(cellX.begin(), cellX.end());
+    minY = *std::min_element(cellY.begin(), cellY.end());
+    maxY = *std::max_element(cellY.begin(), cellY.end());
+    return true;
+}
+
+
+void sparseEngine::shift(int64_t dx, int64_t dy)
+{
+    for (size_t i = 0; i < cellX.size(); i++)
+        cellX[i] = (int)(cellX[i] - dx);
+    for (size_t i = 0; i < cellY.size(); i++)
+        cellY[i] = (int)(cellY[i] - dy);
+    indexed = false;
+}
+
+
+void sparseEngine::store(std::vector<int>& X, std::vector<int>& Y) const
+{
+    if (!rule.generations()) {
+        X = cellX;
+        Y = cellY;
+        return;
+    }
+
+    X.clear();
+    Y.clear();
+    for (size_t i = 0; i < cellS.size(); i++) {
+        if (cellS[i] == 1) {
+            X.push_back(cellX[i]);
+            Y.push_back(cellY[i]);
+        }
+    }
+}
+
+
+bool sparseEngine::alive(int x, int y) const
+{
+    if (!indexed) {
+        lookup.reset(cellX.size());
+        for (size_t i = 0; i < cellX.size(); i++)
+            if (!rule.generations() || cellS[i] == 1)
+                lookup.slot(packCell(cellX[i], cellY[i])) = 1;
+        indexed = true;
+    }
+    return lookup.get(packCell(x, y)) != 0;
+}
+
+
+size_t sparseEngine::countIn(const cellRect& region) const
+{
+    size_t count = 0;
+    for (size_t i = 0; i < cellX.size(); i++)
+        count += region.contains(cellX[i], cellY[i]) && (!rule.generations() || cellS[i] == 1);
+    return count;
+}
+
+
+void sparseEngine::cellsIn(const cellRect& region, std::vector<int>& X, std::vector<int>& Y) const
+{
+    X.clear();
+    Y.clear();
+    for (size_t i = 0; i < cellX.size(); i++) {
+        if (region.contains(cellX[i], cellY[i]) && (!rule.generations() || cellS[i] == 1)) {
+            X.push_back(cellX[i]);
+            Y.push_back(cellY[i]);
+        }
+    }
+}
+
+
+size_t sparseEngine::population() const
+{
+    if (rule.generations())
+        return std::count(cellS.begin(), cellS.end(), 1);
+    return cellX.size();
+}
+
+
+void sortedEngine::step()
+{
+    live.advance(rule);
+    recenterAfter(1);
+}
+
+
+bool sortedEngine::setRule(const lifeRule& newRule)
+{
+    if (newRule.generations())
+        return false;
+    rule = newRule;
+    return true;
+}
+
+
+size_t sortedEngine::countIn(const cellRect& region) const
+{
+    size_t count = 0;
+    live.forEachIn(region, [&](int, int) { count++; });
+    return count;
+}
+
+
+void sortedEngine::cellsIn(const cellRect& region, std::vector<int>& X, std::vector<int>& Y) const
+{
+    X.clear();
+    Y.clear();
+    live.forEachIn(region, [&](int x, int y) {
+        X.push_back(x);
+        Y.push_back(y);
+    });
+}
+
+
+// Scans the store in place rather than a copy of it
+bool sortedEngine::nearest(int x, int y, int& nearX, int& nearY) const
+{
+    uint64_t best = UINT64_MAX;
+    for (cellCoord c : live) {
+        uint64_t d = regionIndex::cellDistance(c.x, c.y, x, y);
+        if (d < best) {
+            best = d;
+            nearX = c.x;
+            nearY = c.y;
+        }
+    }
+    return !live.empty();
+}
+
+
+bool sortedEngine::localBounds(int64_t& minX, int64_t& minY, int64_t& maxX, int64_t& maxY) const
+{
+    return live.bounds(minX, minY, maxX, maxY);
+}
+
+
+std::unique_ptr<lifeEngine> makeEngine(char type)
+{
+    switch (type) {
+    case 's':
+        return std::unique_ptr<lifeEngine>(new sparseEngine());
+    case 't':
+        return std::unique_ptr<lifeEngine>(new tileEngine());
+    case 'h':
+        return std::unique_ptr<lifeEngine>(new hashLife());
+    case 'm':
+        return std::unique_ptr<lifeEngine>(new sortedEngine());
+    default:
+        return nullptr;
+    }
+}
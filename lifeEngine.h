@@ -0,0 +1,158 @@
+#ifndef LIFE_ENGINE_H
+#define LIFE_ENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "cellHash.h"
+#include "threadPool.h"
+#include "lifeRule.h"
+#include "cellStore.h"
+#include "regionIndex.h"
+
+// Common interface for the stepping engines. Every engine imports and exports the live cells as the
+// parallel X/Y coordinate vectors used by the rest of the program, but is free to keep its own
+// internal representation between steps.
+//
+// The X/Y coordinates are 32-bit offsets from a 64-bit origin: the cell at (x, y) is at
+// (originX + x, originY + y) in the universe. Engines keep working on the compact local coordinates,
+// and when the pattern drifts towards the edge of the int range the origin is moved to the middle of
+// its bounding box, so spaceships and puffers can run for any number of generations.
+class lifeEngine
+{
+public:
+    virtual ~lifeEngine() {}
+
+    virtual void load(const std::vector<int>& X, const std::vector<int>& Y) = 0;
+    virtual void step() = 0;
+    virtual void store(std::vector<int>& X, std::vector<int>& Y) const = 0;
+    virtual size_t population() const = 0;
+    virtual const char* name() const = 0;
+
+    // Number of threads used per step. Engines that cannot step in parallel ignore it.
+    virtual void setThreads(int /* threads */) {}
+
+    // Selects the rule, before load. Returns false if the engine cannot run it.
+    virtual bool setRule(const lifeRule& rule) { return rule == LIFE; }
+
+    // The live cells in place, for engines that keep them in a cellStore, otherwise nullptr. Lets the
+    // renderer walk the cells without exporting them first.
+    virtual const cellStore* cells() const { return nullptr; }
+
+    // The cells born and died in the last step, for engines that can find them without going over
+    // every cell. Returns false if the engine does not keep them.
+    virtual bool changes(std::vector<int>& /* bornX */, std::vector<int>& /* bornY */, std::vector<int>& /* diedX */, std::vector<int>& /* diedY */) const
+    {
+        return false;
+    }
+
+    // Region queries in local coordinates, between steps. The defaults go over every cell; engines
+    // that index their cells answer in time that grows with the size of the answer.
+    virtual bool alive(int x, int y) const;
+    virtual size_t countIn(const cellRect& region) const;
+    virtual void cellsIn(const cellRect& region, std::vector<int>& X, std::vector<int>& Y) const;    // Replaces X/Y
+
+    // One of the live cells nearest to (x, y) by Euclidean distance, false if there are none
+    virtual bool nearest(int x, int y, int& nearX, int& nearY) const;
+
+    // Advances the given number of generations. Engines that can take larger steps override this.
+    virtual void run(uint64_t generations)
+    {
+        for (uint64_t g = 0; g < generations; g++)
+            step();
+    }
+
+    // Origin of the local coordinates. setOrigin is called around load with the origin of the cells.
+    void origin(int64_t& x, int64_t& y) const { x = chunkX; y = chunkY; }
+    void setOrigin(int64_t x, int64_t y) { chunkX = x; chunkY = y; untilCheck = 1; }
+
+protected:
+    // Called by the engines after advancing the given number of generations. Checks the bounding box
+    // only when the pattern could have come near the edge since the last check, so it costs nothing
+    // per step.
+    void recenterAfter(uint64_t generations)
+    {
+        if (generations < untilCheck)
+            untilCheck -= generations;
+        else
+            recenter();
+    }
+
+    // Bounding box of the live cells in local coordinates, false if there are none. May be larger
+    // than the exact box.
+    virtual bool localBounds(int64_t& minX, int64_t& minY, int64_t& maxX, int64_t& maxY) const = 0;
+
+    // Moves every cell by (-dx, -dy). Both are multiples of 64.
+    virtual void shift(int64_t dx, int64_t dy) = 0;
+
+private:
+    void recenter();
+
+    int64_t chunkX = 0, chunkY = 0;
+    uint64_t untilCheck = 1;
+};
+
+// Sparse hash-set engine, a thin wrapper around calcState. The only engine that runs Generations
+// rules; it keeps the dying cells internally and imports and exports the live ones.
+class sparseEngine : public lifeEngine
+{
+public:
+    void load(const std::vector<int>& X, const std::vector<int>& Y) override;
+    void step() override;
+    void store(std::vector<int>& X, std::vector<int>& Y) const override;
+    size_t population() const override;
+    const char* name() const override { return "sparse"; }
+    void setThreads(int threads) override { pool.resize(threads); }
+    bool setRule(const lifeRule& newRule) override { rule = newRule; return true; }
+
+    // A lookup table of the live cells is built by the first alive() after the cells change; the
+    // region queries go over the cells in place
+    bool alive(int x, int y) const override;
+    size_t countIn(const cellRect& region) const override;
+    void cellsIn(const cellRect& region, std::vector<int>& X, std::vector<int>& Y) const override;
+
+protected:
+    bool localBounds(int64_t& minX, int64_t& minY, int64_t& maxX, int64_t& maxY) const override;
+    void shift(int64_t dx, int64_t dy) override;
+
+private:
+    std::vector<int> cellX, cellY;
+    std::vector<uint8_t> cellS;    // State of each cell under a Generations rule, 1 = alive
+    lifeRule rule = LIFE;
+    threadPool pool;
+    mutable cellHash lookup;
+    mutable bool indexed = false;  // False until the first alive(), and after the cells change
+};
+
+// Engine on the sorted Morton cell store. Single threaded and two-state rules only, but its memory is
+// a single array of eight bytes per live cell and it walks the cells in a fixed spatial order.
+class sortedEngine : public lifeEngine
+{
+public:
+    void load(const std::vector<int>& X, const std::vector<int>& Y) override { live.assign(X, Y); }
+    void step() override;
+    void store(std::vector<int>& X, std::vector<int>& Y) const override { live.copyTo(X, Y); }
+    size_t population() const override { return live.size(); }
+    const char* name() const override { return "sorted"; }
+    bool setRule(const lifeRule& newRule) override;
+    const cellStore* cells() const override { return &live; }
+    bool alive(int x, int y) const override { return live.contains(x, y); }
+    size_t countIn(const cellRect& region) const override;
+    void cellsIn(const cellRect& region, std::vector<int>& X, std::vector<int>& Y) const override;
+    bool nearest(int x, int y, int& nearX, int& nearY) const override;
+
+protected:
+    bool localBounds(int64_t& minX, int64_t& minY, int64_t& maxX, int64_t& maxY) const override;
+    void shift(int64_t dx, int64_t dy) override { live.shift(dx, dy); }
+
+private:
+    cellStore live;
+    lifeRule rule = LIFE;
+};
+
+// Returns the engine for the given selection character ('s' sparse, 't' tile, 'h' HashLife,
+// 'm' sorted Morton store), or nullptr
+std::unique_ptr<lifeEngine> makeEngine(char type);
+
+#endif
@@ -0,0 +1,130 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   Rule strings. The birth and survival conditions are kept as bitmasks over the neighbour count, so
+   the engines can decide the next state with a shift and a mask instead of comparing counts, and can
+   bake the masks of common rules into specialized kernels at compile time.
+*/
+
+// Headers
+#include <cctype>
+#include <string>
+#include <algorithm>
+#include "lifeRule.h"
+
+
+struct namedRule
+{
+    const char* name;
+    const char* rule;
+};
+
+static const namedRule knownRules[] = {
+    { "life", "B3/S23" },
+    { "highlife", "B36/S23" },
+    { "daynight", "B3678/S34678" },
+    { "seeds", "B2/S" },
+    { "lifewithoutdeath", "B3/S012345678" },
+    { "maze", "B3/S12345" },
+    { "brian", "B2/S/C3" },
+};
+
+
+std::string lifeRule::name() const
+{
+    std::string text = "B";
+    for (int n = 0; n <= 8; n++)
+        if (birth >> n & 1)
+            text += (char)('0' + n);
+    text += "/S";
+    for (int n = 0; n <= 8; n++)
+        if (survive >> n & 1)
+            text += (char)('0' + n);
+    if (states > 2)
+        text += "/C" + std::to_string(states);
+    return text;
+}
+
+
+// Reads a run of neighbour counts into a mask, returning false on a digit above 8
+static bool readCounts(const std::string& text, size_t& at, uint16_t& mask)
+{
+    mask = 0;
+    for (; at < text.size() && isdigit((unsigned char)text[at]); at++) {
+        if (text[at] > '8')
+            return false;
+        mask |= 1 << (text[at] - '0');
+    }
+    return true;
+}
+
+
+bool parseRule(const std::string& input, lifeRule& rule)
+{
+    std::string text;
+    for (char c : input)
+        if (!isspace((unsigned char)c))
+            text += (char)tolower((unsigned char)c);
+
+    for (const namedRule& known : knownRules)
+        if (text == known.name)
+            return parseRule(known.rule, rule);
+
+    lifeRule parsed = { 0, 0, 2 };
+    size_t at = 0;
+
+    if (!text.empty() && text[0] == 'b') {
+        // B.../S...[/C...] or B...S...
+        at = 1;
+        if (!readCounts(text, at, parsed.birth))
+            return false;
+        if (at < text.size() && text[at] == '/')
+            at++;
+        if (at >= text.size() || text[at] != 's')
+            return false;
+        at++;
+        if (!readCounts(text, at, parsed.survive))
+            return false;
+        if (at < text.size()) {
+            if (text[at] == '/')
+                at++;
+            if (at < text.size() && (text[at] == 'c' || text[at] == 'g'))
+                at++;
+            size_t digits = at;
+            while (at < text.size() && isdigit((unsigned char)text[at]))
+                at++;
+            if (digits == at || at - digits > 3)
+                return false;
+            parsed.states = std::stoi(text.substr(digits, at - digits));
+        }
+    }
+    else {
+        // S/B[/C], survival first
+        if (!readCounts(text, at, parsed.survive))
+            return false;
+        if (at >= text.size() || text[at] != '/')
+            return false;
+        at++;
+        if (!readCounts(text, at, parsed.birth))
+            return false;
+        if (at < text.size()) {
+            if (text[at] != '/')
+                return false;
+            at++;
+            size_t digits = at;
+            while (at < text.size() && isdigit((unsigned char)text[at]))
+                at++;
+            if (digits == at || at - digits > 3)
+                return false;
+            parsed.states = std::stoi(text.substr(digits, at - digits));
+        }
+    }
+
+    if (at != text.size() || parsed.states < 2 || parsed.states > 255 || (parsed.birth & 1))
+        return false;
+
+    rule = parsed;
+    return true;
+}
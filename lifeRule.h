@@ -0,0 +1,42 @@
+#ifndef LIFE_RULE_H
+#define LIFE_RULE_H
+
+#include <cstdint>
+#include <string>
+
+// Outer totalistic rule on the Moore neighbourhood. Bit n of 'birth' is set if a dead cell with n
+// live neighbours comes alive, bit n of 'survive' if a live cell with n live neighbours stays alive.
+// Rules with more than two states are Generations rules: a live cell that does not survive goes on
+// through the dying states 2, 3, ... states - 1 before it is dead again, and dying cells neither
+// count as neighbours nor can be born into.
+struct lifeRule
+{
+    uint16_t birth;
+    uint16_t survive;
+    int states;
+
+    // Both masks in one word, survival shifted up by 9, so the next state of a two-state cell is
+    // bit (count + 9 * alive)
+    uint32_t mask() const { return birth | (uint32_t)survive << 9; }
+    bool generations() const { return states > 2; }
+    std::string name() const;    // Canonical form, "B3/S23" or "B2/S/C3"
+
+    bool operator==(const lifeRule& other) const { return birth == other.birth && survive == other.survive && states == other.states; }
+    bool operator!=(const lifeRule& other) const { return !(*this == other); }
+};
+
+const lifeRule LIFE = { 1 << 3, (1 << 2) | (1 << 3), 2 };
+
+// Masks of the rules the engines specialize at compile time, every other rule takes the generic path
+const uint32_t LIFE_MASK = 0x008 | 0x00C << 9;        // B3/S23
+const uint32_t HIGHLIFE_MASK = 0x048 | 0x00C << 9;    // B36/S23
+const uint32_t DAYNIGHT_MASK = 0x1C8 | 0x1D8 << 9;    // B3678/S34678
+const uint32_t SEEDS_MASK = 0x004;                    // B2/S
+
+// Parses "B3/S23", "b36s23", "23/3" (survival first), "B2/S/C3", "12/34/5" (Generations, survival,
+// birth, states) or one of the names life, highlife, daynight, seeds, lifewithoutdeath, maze, brian.
+// Rules with B0 are rejected because they would fill the infinite universe. Returns false if the
+// text is not a rule.
+bool parseRule(const std::string& text, lifeRule& rule);
+
+#endif
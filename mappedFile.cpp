@@ -0,0 +1,131 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   Memory-mapped file access for the pattern loader, using mmap on POSIX systems and a file mapping
+   object on Windows. Files are mapped for sequential reading so the kernel can read ahead.
+*/
+
+// Headers
+#include <string>
+#include "mappedFile.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+#ifdef _WIN32
+
+mappedFile::mappedFile() : ptr(nullptr), len(0), file(INVALID_HANDLE_VALUE), mapping(nullptr) {}
+
+
+bool mappedFile::open(const std::string& path)
+{
+    close();
+
+    file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        close();
+        return false;
+    }
+
+    len = (size_t)size.QuadPart;
+    if (len == 0)
+        return true;
+
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        close();
+        return false;
+    }
+
+    ptr = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!ptr) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+
+void mappedFile::close()
+{
+    if (ptr)
+        UnmapViewOfFile(ptr);
+    if (mapping)
+        CloseHandle(mapping);
+    if (file != INVALID_HANDLE_VALUE)
+        CloseHandle(file);
+
+    ptr = nullptr;
+    mapping = nullptr;
+    file = INVALID_HANDLE_VALUE;
+    len = 0;
+}
+
+#else
+
+mappedFile::mappedFile() : ptr(nullptr), len(0), fd(-1) {}
+
+
+bool mappedFile::open(const std::string& path)
+{
+    close();
+
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close();
+        return false;
+    }
+
+    len = (size_t)info.st_size;
+    if (len == 0)
+        return true;
+
+    void* map = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+        close();
+        return false;
+    }
+
+    madvise(map, len, MADV_SEQUENTIAL);
+    ptr = (const char*)map;
+    return true;
+}
+
+
+void mappedFile::close()
+{
+    if (ptr)
+        munmap((void*)ptr, len);
+    if (fd >= 0)
+        ::close(fd);
+
+    ptr = nullptr;
+    fd = -1;
+    len = 0;
+}
+
+#endif
+
+
+mappedFile::~mappedFile()
+{
+    close();
+}
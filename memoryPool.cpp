@@ -0,0 +1,70 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   The generation scratch arena. Allocations are aligned to 64 bytes by default so that arrays handed
+   to the SIMD kernels and to different threads never share a cache line. A request larger than the
+   chunk size gets a chunk of its own, and reset() folds all the chunks used into one.
+*/
+
+// Headers
+#include <algorithm>
+#include "memoryPool.h"
+#include "metrics.h"
+
+
+scratchArena::scratchArena(size_t chunkBytes) : current(0), used(0), chunkBytes(chunkBytes)
+{
+}
+
+
+void* scratchArena::allocate(size_t bytes, size_t align)
+{
+    while (current < chunks.size()) {
+        chunk& c = chunks[current];
+        uintptr_t base = (uintptr_t)c.data.get();
+        size_t at = (size_t)(((base + used + align - 1) & ~(uintptr_t)(align - 1)) - base);
+        if (at + bytes <= c.size) {
+            used = at + bytes;
+            return c.data.get() + at;
+        }
+        current++;
+        used = 0;
+    }
+
+    METRIC_ADD(COUNTER_ALLOCATIONS, 1);
+    chunk c;
+    c.size = std::max(chunkBytes, bytes + align);
+    c.data.reset(new unsigned char[c.size]);
+    chunks.push_back(std::move(c));
+    current = chunks.size() - 1;
+    used = 0;
+    return allocate(bytes, align);
+}
+
+
+void scratchArena::reset()
+{
+    if (chunks.size() > 1) {
+        size_t total = capacity();
+        chunks.clear();
+
+        METRIC_ADD(COUNTER_ALLOCATIONS, 1);
+        chunk c;
+        c.size = total;
+        c.data.reset(new unsigned char[total]);
+        chunks.push_back(std::move(c));
+    }
+    current = 0;
+    used = 0;
+}
+
+
+size_t scratchArena::capacity() const
+{
+    size_t total = 0;
+    for (size_t i = 0; i < chunks.size(); i++)
+        total += chunks[i].size;
+    return total;
+}
@@ -0,0 +1,84 @@
+#ifndef MEMORY_POOL_H
+#define MEMORY_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "metrics.h"
+
+// Bump allocator for the scratch of one generation. Allocations are never freed one by one; reset()
+// releases all of them at once at the end of the step. The memory itself is kept, and when a
+// generation needed more than one chunk the chunks are replaced by a single one large enough for all
+// of it, so after the first few steps every generation is served from one block without touching
+// the heap. Only for types that need no destructor.
+class scratchArena
+{
+public:
+    explicit scratchArena(size_t chunkBytes = 1 << 20);
+
+    void* allocate(size_t bytes, size_t align);
+
+    template <typename T>
+    T* allocate(size_t n) { return static_cast<T*>(allocate(n * sizeof(T), alignof(T) < 64 ? 64 : alignof(T))); }
+
+    void reset();
+    size_t capacity() const;
+
+private:
+    struct chunk
+    {
+        std::unique_ptr<unsigned char[]> data;
+        size_t size;
+    };
+
+    std::vector<chunk> chunks;
+    size_t current;     // Chunk being filled
+    size_t used;        // Bytes used in it
+    size_t chunkBytes;
+};
+
+// Growable array of fixed-size objects kept in slabs of 2^SHIFT, for the tiles and nodes of the
+// engines. Growing adds a slab instead of moving everything to a larger block, so references stay
+// valid, there is no copy and no transient doubling of memory, and shrinking keeps the slabs for
+// reuse. Indexing costs one extra load over a vector.
+template <typename T, int SHIFT>
+class slabPool
+{
+public:
+    static const size_t SLAB = (size_t)1 << SHIFT;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    T& operator[](size_t i) { return slabs[i >> SHIFT][i & (SLAB - 1)]; }
+    const T& operator[](size_t i) const { return slabs[i >> SHIFT][i & (SLAB - 1)]; }
+    T& back() { return (*this)[count - 1]; }
+
+    // Appends a value-initialised object and returns its index
+    size_t push()
+    {
+        if (count == slabs.size() * SLAB) {
+            METRIC_ADD(COUNTER_ALLOCATIONS, 1);
+            slabs.emplace_back(new T[SLAB]);
+        }
+        (*this)[count] = T();
+        return count++;
+    }
+
+    // Shrinks to the first n objects, keeping the slabs
+    void resize(size_t n)
+    {
+        while (count < n)
+            push();
+        count = n;
+    }
+
+    void clear() { count = 0; }
+    size_t bytes() const { return slabs.size() * SLAB * sizeof(T); }
+
+private:
+    std::vector<std::unique_ptr<T[]>> slabs;
+    size_t count = 0;
+};
+
+#endif
@@ -0,0 +1,270 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   Instrumentation for the generation loop. Every thread that reaches an instrumentation point gets
+   a block of counters from a registry the first time, and then only touches its own block, with
+   relaxed loads and stores rather than atomic adds since no other thread writes it. Blocks are never
+   freed: when a thread exits its block is handed to the next new thread, so counts left behind by a
+   pool that was resized are still collected, and the registry stays as small as the largest number
+   of threads that ran at once.
+
+   Trace events are kept per thread as well, as start and duration in nanoseconds since the program
+   started, and written out as complete ("X") events of the Chrome trace-event format.
+*/
+
+// Headers
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "metrics.h"
+#include "cellPairs.h"
+
+
+const size_t TRACE_LIMIT = 1 << 20;
+
+
+struct traceEvent
+{
+    uint64_t start, duration;
+    metricPhase phase;
+};
+
+struct metricBlock
+{
+    std::atomic<uint64_t> phaseNs[PHASES];
+    std::atomic<uint64_t> counters[COUNTERS];
+    std::vector<traceEvent> events;
+    int tid;
+    bool owned;
+};
+
+static std::mutex registryLock;
+static std::vector<std::unique_ptr<metricBlock>> registry;
+static std::atomic<bool> tracing(false);
+static std::atomic<bool> started(false);
+static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+
+// Holds the calling thread's block, and gives it back when the thread exits
+struct blockOwner
+{
+    metricBlock* block;
+
+    blockOwner() : block(nullptr)
+    {
+        std::lock_guard<std::mutex> guard(registryLock);
+        for (size_t i = 0; i < registry.size() && !block; i++)
+            if (!registry[i]->owned)
+                block = registry[i].get();
+
+        if (!block) {
+            registry.emplace_back(new metricBlock());
+            block = registry.back().get();
+            block->tid = (int)registry.size() - 1;
+            for (int p = 0; p < PHASES; p++)
+                block->phaseNs[p] = 0;
+            for (int c = 0; c < COUNTERS; c++)
+                block->counters[c] = 0;
+        }
+        block->owned = true;
+    }
+
+    ~blockOwner()
+    {
+        std::lock_guard<std::mutex> guard(registryLock);
+        block->owned = false;
+    }
+};
+
+
+static metricBlock& localBlock()
+{
+    static thread_local blockOwner owner;
+    return *owner.block;
+}
+
+
+static inline void bump(std::atomic<uint64_t>& value, uint64_t n)
+{
+    value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+
+bool metricsStarted()
+{
+    return started.load(std::memory_order_relaxed);
+}
+
+
+void metricAdd(metricCounter counter, uint64_t n)
+{
+    bump(localBlock().counters[counter], n);
+}
+
+
+phaseTimer::~phaseTimer()
+{
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+    metricBlock& block = localBlock();
+    bump(block.phaseNs[phase], ns);
+
+    if (tracing.load(std::memory_order_relaxed) && block.events.size() < TRACE_LIMIT) {
+        uint64_t at = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(start - epoch).count();
+        block.events.push_back({ at, ns, phase });
+    }
+}
+
+
+void collectMetrics(uint64_t phaseNs[PHASES], uint64_t counters[COUNTERS])
+{
+    for (int p = 0; p < PHASES; p++)
+        phaseNs[p] = 0;
+    for (int c = 0; c < COUNTERS; c++)
+        counters[c] = 0;
+
+    std::lock_guard<std::mutex> guard(registryLock);
+    for (size_t i = 0; i < registry.size(); i++) {
+        for (int p = 0; p < PHASES; p++)
+            phaseNs[p] += registry[i]->phaseNs[p].exchange(0, std::memory_order_relaxed);
+        for (int c = 0; c < COUNTERS; c++)
+            counters[c] += registry[i]->counters[c].exchange(0, std::memory_order_relaxed);
+    }
+}
+
+
+void clearMetrics()
+{
+    uint64_t phaseNs[PHASES], counters[COUNTERS];
+    collectMetrics(phaseNs, counters);
+}
+
+
+void startTrace()
+{
+    tracing = true;
+}
+
+
+bool writeTrace(const std::string& file)
+{
+    FILE* out = fopen(file.c_str(), "wb");
+    if (!out)
+        return false;
+
+    std::lock_guard<std::mutex> guard(registryLock);
+    fprintf(out, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    bool first = true;
+    for (size_t i = 0; i < registry.size(); i++) {
+        const std::vector<traceEvent>& events = registry[i]->events;
+        for (size_t e = 0; e < events.size(); e++) {
+            // Timestamps are in microseconds
+            fprintf(out, "%s  {\"name\": \"%s\", \"cat\": \"life\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f}",
+                first ? "" : ",\n", phaseName(events[e].phase), registry[i]->tid, events[e].start / 1000.0, events[e].duration / 1000.0);
+            first = false;
+        }
+    }
+    fprintf(out, "\n]}\n");
+    return fclose(out) == 0;
+}
+
+
+const char* phaseName(metricPhase phase)
+{
+    static const char* names[PHASES] = { "step", "count", "rule", "commit", "render" };
+    return phase < PHASES ? names[phase] : "?";
+}
+
+
+generationMetrics measureGeneration(uint64_t generation, const std::vector<int>& X, const std::vector<int>& Y, int64_t originX, int64_t originY)
+{
+    generationMetrics m;
+    m.generation = generation;
+    collectMetrics(m.phaseNs, m.counters);
+
+    cellPairs cells(X, Y);
+    m.population = cells.size();
+    m.hasBounds = !cells.empty();
+    m.minX = m.minY = m.maxX = m.maxY = 0;
+    if (m.hasBounds) {
+        int minX = cells[0].x, maxX = minX, minY = cells[0].y, maxY = minY;
+        for (cellCoord c : cells) {
+            minX = std::min(minX, c.x);
+            maxX = std::max(maxX, c.x);
+            minY = std::min(minY, c.y);
+            maxY = std::max(maxY, c.y);
+        }
+        m.minX = originX + minX;
+        m.maxX = originX + maxX;
+        m.minY = originY + minY;
+        m.maxY = originY + maxY;
+    }
+    return m;
+}
+
+
+bool metricsLog::open(const std::string& file)
+{
+    started = true;
+    json = file.size() >= 5 && file.compare(file.size() - 5, 5, ".json") == 0;
+    first = true;
+    out.open(file);
+    if (!out)
+        return false;
+
+    if (json)
+        out << "[\n";
+    else
+        out << "generation,step_ns,count_ns,rule_ns,commit_ns,render_ns,births,deaths,active_tiles,allocations,population,min_x,min_y,max_x,max_y\n";
+    return true;
+}
+
+
+void metricsLog::record(const generationMetrics& m)
+{
+    if (!out.is_open())
+        return;
+
+    if (json) {
+        out << (first ? "" : ",\n") << "  {\"generation\": " << m.generation;
+        for (int p = 0; p < PHASES; p++)
+            out << ", \"" << phaseName((metricPhase)p) << "_ns\": " << m.phaseNs[p];
+        out << ", \"births\": " << m.counters[COUNTER_BIRTHS] << ", \"deaths\": " << m.counters[COUNTER_DEATHS]
+            << ", \"active_tiles\": " << m.counters[COUNTER_ACTIVE_TILES] << ", \"allocations\": " << m.counters[COUNTER_ALLOCATIONS]
+            << ", \"population\": " << m.population;
+        if (m.hasBounds)
+            out << ", \"bounds\": [" << m.minX << ", " << m.minY << ", " << m.maxX << ", " << m.maxY << "]";
+        out << "}";
+    }
+    else {
+        out << m.generation;
+        for (int p = 0; p < PHASES; p++)
+            out << "," << m.phaseNs[p];
+        out << "," << m.counters[COUNTER_BIRTHS] << "," << m.counters[COUNTER_DEATHS] << "," << m.counters[COUNTER_ACTIVE_TILES]
+            << "," << m.counters[COUNTER_ALLOCATIONS] << "," << m.population;
+        if (m.hasBounds)
+            out << "," << m.minX << "," << m.minY << "," << m.maxX << "," << m.maxY << "\n";
+        else
+            out << ",,,,\n";
+    }
+    first = false;
+}
+
+
+void metricsLog::close()
+{
+    if (!out.is_open())
+        return;
+    if (json)
+        out << (first ? "" : "\n") << "]\n";
+    out.close();
+}
@@ -0,0 +1,108 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Phases of a generation that are timed. The tile and bounded engines compute the neighbour counts
+// and the rule in the same bitwise adders, so their whole kernel is counted as PHASE_COUNT.
+enum metricPhase
+{
+    PHASE_STEP,      // Whole engine step, timed by the caller
+    PHASE_COUNT,     // Neighbour counting
+    PHASE_RULE,      // Applying the rule to the counts, births and survivals
+    PHASE_COMMIT,    // Assembling the next generation: merging bands, expanding and sweeping tiles
+    PHASE_RENDER,
+    PHASES
+};
+
+enum metricCounter
+{
+    COUNTER_BIRTHS,        // Counted by the sparse, tile and sorted engines
+    COUNTER_DEATHS,
+    COUNTER_ACTIVE_TILES,  // Tiles recomputed by the tile engine
+    COUNTER_ALLOCATIONS,   // Heap blocks taken by the arenas, slab pools and hash tables
+    COUNTERS
+};
+
+// Instrumentation points. Each thread adds to its own block of counters, and collectMetrics sums
+// the blocks between generations, so the hot paths never share a cache line. Building with
+// LIFE_NO_METRICS removes every point.
+#ifdef LIFE_NO_METRICS
+#define METRIC_PHASE(phase) ((void)0)
+#define METRIC_ADD(counter, n) ((void)sizeof(n))
+#else
+#define METRIC_JOIN2(a, b) a##b
+#define METRIC_JOIN(a, b) METRIC_JOIN2(a, b)
+#define METRIC_PHASE(phase) phaseTimer METRIC_JOIN(metricTimer, __LINE__)(phase)
+#define METRIC_ADD(counter, n) metricAdd(counter, n)
+#endif
+
+void metricAdd(metricCounter counter, uint64_t n);
+
+// True once a metrics log has been opened. Counters that cost real work to gather, like the births
+// and deaths of a bit-packed tile, are only gathered from then on.
+bool metricsStarted();
+
+// Adds the time until the end of the enclosing scope to the phase, and records a trace event when
+// tracing is on
+class phaseTimer
+{
+public:
+    explicit phaseTimer(metricPhase phase) : phase(phase), start(std::chrono::steady_clock::now()) {}
+    ~phaseTimer();
+
+private:
+    metricPhase phase;
+    std::chrono::steady_clock::time_point start;
+};
+
+// Sums the counters of every thread into the arrays and clears them. Only call between steps, while
+// the engine's worker threads are idle.
+void collectMetrics(uint64_t phaseNs[PHASES], uint64_t counters[COUNTERS]);
+
+void clearMetrics();
+
+// Records every timed scope from now on, for writeTrace. Each thread keeps at most TRACE_LIMIT events.
+void startTrace();
+
+// Writes the recorded scopes as a Chrome trace-event file (chrome://tracing, Perfetto, speedscope)
+bool writeTrace(const std::string& file);
+
+const char* phaseName(metricPhase phase);
+
+// What one generation did
+struct generationMetrics
+{
+    uint64_t generation;
+    uint64_t phaseNs[PHASES];
+    uint64_t counters[COUNTERS];
+    size_t population;
+    bool hasBounds;
+    int64_t minX, minY, maxX, maxY;
+};
+
+// Collects the counters of the generation just stepped and measures the live cells, given in local
+// coordinates around the origin
+generationMetrics measureGeneration(uint64_t generation, const std::vector<int>& X, const std::vector<int>& Y, int64_t originX, int64_t originY);
+
+// Writes one row per generation, as CSV or, if the file name ends in .json, as a JSON array
+class metricsLog
+{
+public:
+    bool open(const std::string& file);
+    void record(const generationMetrics& m);
+    void close();
+    bool isOpen() const { return out.is_open(); }
+
+private:
+    std::ofstream out;
+    bool json = false;
+    bool first = true;
+};
+
+#endif
@@ -0,0 +1,452 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   Pattern loading and saving. Input files are memory mapped and parsed in a single forward pass
+   straight into the X/Y vectors, with no per-line strings or stream extraction, so files of hundreds
+   of megabytes load at close to disk speed. In RLE files a number is a run count for the tag after
+   it: 'b' or '.' for dead cells, 'o' or any other letter for live cells (states of multi-state rules
+   count as alive), '$' for the end of a row and '!' for the end of the pattern.
+
+   The writer sorts the cells into row order once and produces the runs directly into an output
+   buffer that is flushed in large blocks. Rows in the files run from the top down, so file row r is
+   y = -r before the pattern is positioned.
+*/
+
+// Headers
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <climits>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "patternIO.h"
+#include "mappedFile.h"
+#include "cellPairs.h"
+
+
+const int RLE_LINE = 70;          // Longest line written to an RLE file
+const size_t FLUSH_SIZE = 1 << 20; // Output is written in blocks of this size
+
+
+patternFormat formatFor(const std::string& file)
+{
+    size_t dot = file.find_last_of('.');
+    std::string ext = dot == std::string::npos ? "" : file.substr(dot + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+
+    if (ext == "rle")
+        return FORMAT_RLE;
+    if (ext == "cells")
+        return FORMAT_CELLS;
+    return FORMAT_COORDS;
+}
+
+
+// Reads an optionally signed integer, returning false if there are no digits at p
+static bool readInt(const char*& p, const char* end, int64_t& value)
+{
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        negative = (*p++ == '-');
+    if (p == end || *p < '0' || *p > '9')
+        return false;
+
+    value = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+        value = value * 10 + (*p++ - '0');
+    if (negative)
+        value = -value;
+    return true;
+}
+
+
+static void skipLine(const char*& p, const char* end)
+{
+    while (p < end && *p != '\n')
+        p++;
+    if (p < end)
+        p++;
+}
+
+
+static void skipSpaces(const char*& p, const char* end)
+{
+    while (p < end && (*p == ' ' || *p == '\t'))
+        p++;
+}
+
+
+// Positions further than this from (0,0) are returned as an origin
+const int64_t FAR_AWAY = (int64_t)1 << 30;
+
+
+// Coordinates are taken relative to the origin, which the first cell sets if it lies far out
+static bool parseCoords(const char* p, const char* end, std::vector<int>& X, std::vector<int>& Y, int64_t& originX, int64_t& originY)
+{
+    int64_t x, y;
+    bool first = true;
+    while (true) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n' || *p == ','))
+            p++;
+        if (p == end)
+            return true;
+        if (!readInt(p, end, x))
+            return false;
+
+        while (p < end && (*p == ' ' || *p == '\t' || *p == ','))
+            p++;
+        if (!readInt(p, end, y))
+            return false;
+
+        if (first && (x < -FAR_AWAY || x > FAR_AWAY || y < -FAR_AWAY || y > FAR_AWAY)) {
+            originX = x & ~(int64_t)63;
+            originY = y & ~(int64_t)63;
+        }
+        first = false;
+
+        X.push_back((int)(x - originX));
+        Y.push_back((int)(y - originY));
+    }
+}
+
+
+// Parses the "x = m, y = n, rule = R" header line
+static void parseHeader(const char*& p, const char* end, int64_t& width, int64_t& height, std::string& rule)
+{
+    while (p < end && *p != '\n') {
+        skipSpaces(p, end);
+        const char* key = p;
+        while (p < end && *p != '=' && *p != '\n' && *p != ' ')
+            p++;
+        size_t keyLen = p - key;
+        skipSpaces(p, end);
+        if (p == end || *p != '=')
+            break;
+        p++;
+        skipSpaces(p, end);
+
+        if (keyLen == 1 && *key == 'x')
+            readInt(p, end, width);
+        else if (keyLen == 1 && *key == 'y')
+            readInt(p, end, height);
+        else if (keyLen == 4 && strncmp(key, "rule", 4) == 0) {
+            const char* value = p;
+            while (p < end && *p != ',' && *p != '\n' && *p != '\r' && *p != ' ')
+                p++;
+            rule.assign(value, p);
+        }
+
+        while (p < end && *p != ',' && *p != '\n')
+            p++;
+        if (p < end && *p == ',')
+            p++;
+    }
+    skipLine(p, end);
+}
+
+
+static bool parseRLE(const char* p, const char* end, std::vector<int>& X, std::vector<int>& Y, std::string& rule,
+    bool& placed, int64_t& posX, int64_t& posY)
+{
+    int64_t width = 0, height = 0;
+
+    // Comment lines and the header
+    while (p < end) {
+        if (*p == '#') {
+            if (end - p > 11 && strncmp(p, "#CXRLE", 6) == 0) {
+                const char* pos = p + 6;
+                while (pos < end && *pos != '\n' && strncmp(pos, "Pos=", 4) != 0)
+                    pos++;
+                if (pos < end && *pos != '\n') {
+                    pos += 4;
+                    if (readInt(pos, end, posX) && pos < end && *pos++ == ',' && readInt(pos, end, posY))
+                        placed = true;
+                }
+            }
+            skipLine(p, end);
+        }
+        else if (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
+            p++;
+        else if (*p == 'x') {
+            parseHeader(p, end, width, height, rule);
+            break;
+        }
+        else
+            break;
+    }
+
+    int64_t run = 0, col = 0, row = 0;
+    for (; p < end; p++) {
+        char c = *p;
+        if (c >= '0' && c <= '9') {
+            run = run * 10 + (c - '0');
+            continue;
+        }
+
+        int64_t count = run ? run : 1;
+        if (c == 'b' || c == '.')
+            col += count;
+        else if (c == '$') {
+            row += count;
+            col = 0;
+        }
+        else if (c == '!')
+            return true;
+        else if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+            // Multi-state patterns write states above 24 as a prefix letter p-y before the state
+            if (c >= 'p' && c <= 'y' && p + 1 < end && *(p + 1) >= 'A' && *(p + 1) <= 'X')
+                p++;
+            for (int64_t k = 0; k < count; k++) {
+                X.push_back((int)(col + k));
+                Y.push_back((int)-row);
+            }
+            col += count;
+        }
+        else if (c != ' ' && c != '\t' && c != '\r' && c != '\n')
+            return false;
+
+        run = 0;
+    }
+
+    return true;
+}
+
+
+static bool parseCells(const char* p, const char* end, std::vector<int>& X, std::vector<int>& Y)
+{
+    int row = 0;
+
+    while (p < end) {
+        if (*p == '!') {
+            skipLine(p, end);
+            continue;
+        }
+
+        for (int col = 0; p < end && *p != '\n'; p++, col++) {
+            if (*p == 'O' || *p == '*') {
+                X.push_back(col);
+                Y.push_back(-row);
+            }
+            else if (*p == '\r')
+                col--;
+            else if (*p != '.' && *p != ' ')
+                return false;
+        }
+        if (p < end)
+            p++;
+        row++;
+    }
+    return true;
+}
+
+
+bool loadPattern(const std::string& file, std::vector<int>& X, std::vector<int>& Y, std::string& rule)
+{
+    int64_t originX, originY;
+    size_t first = X.size();
+
+    if (!loadPattern(file, X, Y, rule, originX, originY))
+        return false;
+    for (size_t i = first; i < X.size(); i++) {
+        X[i] = (int)(X[i] + originX);
+        Y[i] = (int)(Y[i] + originY);
+    }
+    return true;
+}
+
+
+bool loadPattern(const std::string& file, std::vector<int>& X, std::vector<int>& Y, std::string& rule, int64_t& originX, int64_t& originY)
+{
+    originX = originY = 0;
+
+    mappedFile map;
+    if (!map.open(file))
+        return false;
+
+    const char* p = map.data();
+    const char* end = p + map.size();
+    patternFormat format = formatFor(file);
+    bool placed = false;
+    int64_t posX = 0, posY = 0;
+    size_t first = X.size();
+
+    X.reserve(first + map.size() / 4);
+    Y.reserve(first + map.size() / 4);
+
+    bool ok;
+    if (format == FORMAT_COORDS)
+        return parseCoords(p, end, X, Y, originX, originY);
+    else if (format == FORMAT_RLE)
+        ok = parseRLE(p, end, X, Y, rule, placed, posX, posY);
+    else
+        ok = parseCells(p, end, X, Y);
+    if (!ok || X.size() == first)
+        return ok;
+
+    // Position the pattern: at the recorded top left corner, or centred on the origin
+    int64_t dx, dy;
+    if (placed) {
+        dx = posX;
+        dy = -posY;
+    }
+    else {
+        int maxX = *std::max_element(X.begin() + first, X.end());
+        int minY = *std::min_element(Y.begin() + first, Y.end());
+        dx = -(int64_t)maxX / 2;
+        dy = -(int64_t)minY / 2;
+    }
+
+    // A position beyond the int range becomes the origin, rounded to a multiple of 64 for the tiles
+    if (dx < -FAR_AWAY || dx > FAR_AWAY || dy < -FAR_AWAY || dy > FAR_AWAY) {
+        originX = dx & ~(int64_t)63;
+        originY = dy & ~(int64_t)63;
+        dx -= originX;
+        dy -= originY;
+    }
+
+    for (size_t i = first; i < X.size(); i++) {
+        X[i] = (int)(X[i] + dx);
+        Y[i] = (int)(Y[i] + dy);
+    }
+    return true;
+}
+
+
+// Output buffer that is written to the file whenever it passes FLUSH_SIZE
+class patternWriter
+{
+public:
+    explicit patternWriter(FILE* out) : out(out), ok(true), line(0) { buffer.reserve(FLUSH_SIZE + 64); }
+
+    void put(const char* s, size_t n)
+    {
+        buffer.append(s, n);
+        line += (int)n;
+        if (buffer.size() >= FLUSH_SIZE)
+            flush();
+    }
+    void put(const std::string& s) { put(s.data(), s.size()); }
+    void newline() { put("\n", 1); line = 0; }
+
+    // Appends one RLE run, wrapping the line first if it would pass RLE_LINE characters
+    void run(int64_t count, char tag)
+    {
+        char token[24];
+        int n = sizeof(token);
+
+        // Digits are written backwards from the end of the token, which is quicker than snprintf
+        token[--n] = tag;
+        if (count > 1)
+            for (; count > 0; count /= 10)
+                token[--n] = (char)('0' + count % 10);
+        if (line + (int)sizeof(token) - n > RLE_LINE)
+            newline();
+        put(token + n, sizeof(token) - n);
+    }
+
+    bool flush()
+    {
+        if (!buffer.empty() && fwrite(buffer.data(), 1, buffer.size(), out) != buffer.size())
+            ok = false;
+        buffer.clear();
+        return ok;
+    }
+
+private:
+    FILE* out;
+    bool ok;
+    int line;
+    std::string buffer;
+};
+
+
+bool savePattern(const std::string& file, const std::vector<int>& X, const std::vector<int>& Y, const std::string& rule,
+    int64_t originX, int64_t originY)
+{
+    cellPairs cells(X, Y);
+    patternFormat format = formatFor(file);
+
+    FILE* out = fopen(file.c_str(), "wb");
+    if (!out)
+        return false;
+    patternWriter writer(out);
+
+    if (format == FORMAT_COORDS) {
+        char line[48];
+        for (cellCoord c : cells)
+            writer.put(line, snprintf(line, sizeof(line), "%lld %lld\n", (long long)(originX + c.x), (long long)(originY + c.y)));
+    }
+    else if (cells.empty()) {
+        if (format == FORMAT_RLE)
+            writer.put("x = 0, y = 0, rule = " + rule + "\n!\n");
+    }
+    else {
+        int minX = cells[0].x, maxX = minX, minY = cells[0].y, maxY = minY;
+        for (cellCoord c : cells) {
+            minX = std::min(minX, c.x);
+            maxX = std::max(maxX, c.x);
+            minY = std::min(minY, c.y);
+            maxY = std::max(maxY, c.y);
+        }
+
+        // Sort once into file order: rows from the top down, then left to right
+        std::vector<uint64_t> keys;
+        keys.reserve(cells.size());
+        for (cellCoord c : cells)
+            keys.push_back(((uint64_t)((int64_t)maxY - c.y) << 32) | (uint32_t)((int64_t)c.x - minX));
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+        char header[128];
+        int64_t width = (int64_t)maxX - minX + 1, height = (int64_t)maxY - minY + 1;
+
+        if (format == FORMAT_RLE) {
+            writer.put(header, snprintf(header, sizeof(header), "#CXRLE Pos=%lld,%lld\n", (long long)(originX + minX), -(long long)(originY + maxY)));
+            writer.put(header, snprintf(header, sizeof(header), "x = %lld, y = %lld, rule = ", (long long)width, (long long)height));
+            writer.put(rule);
+            writer.newline();
+
+            int64_t row = 0, col = 0, alive = 0;
+            for (size_t i = 0; i < keys.size(); i++) {
+                int64_t r = keys[i] >> 32, c = (uint32_t)keys[i];
+
+                if (r != row || c != col + alive) {
+                    if (alive)
+                        writer.run(alive, 'o');
+                    col += alive;
+                    alive = 0;
+                    if (r != row) {
+                        writer.run(r - row, '$');
+                        row = r;
+                        col = 0;
+                    }
+                    if (c > col)
+                        writer.run(c - col, 'b');
+                    col = c;
+                }
+                alive++;
+            }
+            if (alive)
+                writer.run(alive, 'o');
+            writer.run(1, '!');
+            writer.newline();
+        }
+        else {
+            std::string line;
+            size_t i = 0;
+            for (int64_t r = 0; r < height; r++) {
+                line.assign((size_t)width, '.');
+                for (; i < keys.size() && (int64_t)(keys[i] >> 32) == r; i++)
+                    line[(uint32_t)keys[i]] = 'O';
+                line += '\n';
+                writer.put(line);
+            }
+        }
+    }
+
+    bool ok = writer.flush();
+    return fclose(out) == 0 && ok;
+}
@@ -0,0 +1,33 @@
+#ifndef PATTERN_IO_H
+#define PATTERN_IO_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Pattern file formats, chosen from the file extension
+enum patternFormat
+{
+    FORMAT_COORDS,   // Whitespace separated "x y" pairs (any other extension)
+    FORMAT_RLE,      // .rle run length encoding with an "x = , y = , rule = " header
+    FORMAT_CELLS     // .cells plaintext, '.' dead and 'O' alive, '!' comment lines
+};
+
+patternFormat formatFor(const std::string& file);
+
+// Reads a pattern into X/Y, appending nothing else. RLE and plaintext patterns are centred on (0,0)
+// unless the file carries a "#CXRLE Pos=x,y" line, which places them exactly. The rule from an RLE
+// header is returned in 'rule', otherwise it is left untouched. Returns false if the file cannot be
+// opened or is malformed.
+bool loadPattern(const std::string& file, std::vector<int>& X, std::vector<int>& Y, std::string& rule);
+
+// As above, but a recorded position outside the int range is returned as a 64-bit origin, with X/Y
+// relative to it, instead of being wrapped. The origin is (0,0) for every other file.
+bool loadPattern(const std::string& file, std::vector<int>& X, std::vector<int>& Y, std::string& rule, int64_t& originX, int64_t& originY);
+
+// Writes the cells at (originX + X, originY + Y) in the format matching the file extension. RLE
+// output records the position so that loading it back gives the same coordinates.
+bool savePattern(const std::string& file, const std::vector<int>& X, const std::vector<int>& Y, const std::string& rule,
+    int64_t originX = 0, int64_t originY = 0);
+
+#endif
@@ -0,0 +1,84 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   A small library of standard patterns used by the benchmarks and for seeding runs. Patterns are
+   written as plaintext rows from the top down, with 'O' for a live cell.
+*/
+
+// Headers
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include "patterns.h"
+
+
+struct namedRows
+{
+    const char* name;
+    std::vector<const char*> rows;
+};
+
+static const namedRows library[] = {
+    { "rpentomino", { ".OO", "OO.", ".O." } },
+    { "acorn", { ".O.....", "...O...", "OO..OOO" } },
+    { "glider", { ".O.", "..O", "OOO" } },
+    { "lwss", { ".O..O", "O....", "O...O", "OOOO." } },
+    { "blinker", { "OOO" } },
+    { "gosper", {
+        "........................O...........",
+        "......................O.O...........",
+        "............OO......OO............OO",
+        "...........O...O....OO............OO",
+        "OO........O.....O...OO..............",
+        "OO........O...O.OO....O.O...........",
+        "..........O.....O.......O...........",
+        "...........O...O....................",
+        "............OO......................" } },
+};
+
+
+bool namedPattern(const std::string& name, int x0, int y0, std::vector<int>& X, std::vector<int>& Y)
+{
+    for (const namedRows& pattern : library) {
+        if (name != pattern.name)
+            continue;
+
+        for (size_t r = 0; r < pattern.rows.size(); r++) {
+            for (int c = 0; pattern.rows[r][c]; c++) {
+                if (pattern.rows[r][c] == 'O') {
+                    X.push_back(x0 + c);
+                    Y.push_back(y0 - (int)r);
+                }
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+
+void spaceshipField(int count, int spacing, unsigned seed, std::vector<int>& X, std::vector<int>& Y)
+{
+    std::mt19937 rng(seed);
+    int side = (int)std::ceil(std::sqrt((double)count));
+
+    X.clear();
+    Y.clear();
+    for (int i = 0; i < count; i++) {
+        std::vector<int> shipX, shipY;
+        namedPattern(rng() % 2 ? "glider" : "lwss", 0, 0, shipX, shipY);
+
+        // Mirror and transpose at random so the ships head off in different directions
+        bool flipX = rng() % 2, flipY = rng() % 2, swap = rng() % 2;
+        int x0 = (i % side - side / 2) * spacing, y0 = (i / side - side / 2) * spacing;
+        for (size_t k = 0; k < shipX.size(); k++) {
+            int x = flipX ? -shipX[k] : shipX[k];
+            int y = flipY ? -shipY[k] : shipY[k];
+            X.push_back(x0 + (swap ? y : x));
+            Y.push_back(y0 + (swap ? x : y));
+        }
+    }
+}
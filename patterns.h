@@ -0,0 +1,15 @@
+#ifndef PATTERNS_H
+#define PATTERNS_H
+
+#include <string>
+#include <vector>
+
+// Appends a named pattern to X/Y at offset (x0, y0). Known names are "rpentomino", "acorn",
+// "gosper" (glider gun), "glider", "lwss" and "blinker". Returns false for an unknown name.
+bool namedPattern(const std::string& name, int x0, int y0, std::vector<int>& X, std::vector<int>& Y);
+
+// Fills X/Y with 'count' gliders and lightweight spaceships scattered over a square with the given
+// spacing between them, all heading out in random directions, the same field for the same seed
+void spaceshipField(int count, int spacing, unsigned seed, std::vector<int>& X, std::vector<int>& Y);
+
+#endif
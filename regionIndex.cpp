@@ -0,0 +1,191 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   Region index. The population of every tile and of every square of 2^k by 2^k tiles above it is kept
+   in one open addressing table keyed by level and position, so a node's children are looked up by
+   computing their keys. Setting a tile adds the change in its population to the tile and to the TOP
+   nodes above it; setting a batch merges the changes of siblings first, so that after a step the nodes
+   above the changed tiles are each updated once. Nodes are not removed when their population drops to
+   zero; the owner rebuilds the index when too few of its nodes are live.
+
+   Squared distances are kept in 64 bits and saturate, since the distance across the whole plane of
+   ints does not fit.
+*/
+
+// Headers
+#include <algorithm>
+#include <limits>
+#include "regionIndex.h"
+
+
+regionIndex::regionIndex() : mask(0), nodes(0), live(0)
+{
+    clear();
+}
+
+
+void regionIndex::clear()
+{
+    keys.assign(64, 0);
+    counts.assign(64, 0);
+    used.assign(64, 0);
+    mask = 63;
+    nodes = 0;
+    live = 0;
+}
+
+
+uint64_t regionIndex::key(int level, int qx, int qy)
+{
+    return (uint64_t)level << 52 | (uint64_t)(qx & 0x3FFFFFF) << 26 | (uint64_t)(qy & 0x3FFFFFF);
+}
+
+
+size_t regionIndex::slotFor(uint64_t k) const
+{
+    size_t i = (size_t)((k * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+    while (used[i] && keys[i] != k)
+        i = (i + 1) & mask;
+    return i;
+}
+
+
+uint64_t regionIndex::population(int level, int qx, int qy) const
+{
+    size_t i = slotFor(key(level, qx, qy));
+    return used[i] ? counts[i] : 0;
+}
+
+
+void regionIndex::add(int level, int qx, int qy, uint64_t change)
+{
+    uint64_t k = key(level, qx, qy);
+    size_t i = slotFor(k);
+    if (!used[i]) {
+        if (2 * (nodes + 1) > keys.size()) {
+            grow();
+            i = slotFor(k);
+        }
+        used[i] = 1;
+        keys[i] = k;
+        counts[i] = 0;
+        nodes++;
+    }
+    bool wasLive = counts[i] > 0;
+    counts[i] += change;
+    live += (counts[i] > 0) - wasLive;
+}
+
+
+void regionIndex::set(int tx, int ty, uint64_t population)
+{
+    // Wraps around when the population falls, which adds the same negative change to every level
+    uint64_t change = population - regionIndex::population(0, tx, ty);
+    if (change == 0)
+        return;
+    for (int level = 0; level <= TOP; level++)
+        add(level, tx >> level, ty >> level, change);
+}
+
+
+// The entries are turned into the changes of their nodes and then, level by level, sorted so that
+// siblings meet, merged, and applied
+void regionIndex::set(std::vector<tileCount>& changes)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < changes.size(); i++) {
+        tileCount c = changes[i];
+        c.population -= population(0, c.tx, c.ty);
+        if (c.population != 0)
+            changes[n++] = c;
+    }
+    changes.resize(n);
+
+    for (int level = 0; level <= TOP && !changes.empty(); level++) {
+        if (level > 0) {
+            for (size_t i = 0; i < changes.size(); i++) {
+                changes[i].tx >>= 1;
+                changes[i].ty >>= 1;
+            }
+            std::sort(changes.begin(), changes.end(), [](const tileCount& a, const tileCount& b) {
+                return a.ty != b.ty ? a.ty < b.ty : a.tx < b.tx;
+            });
+
+            n = 0;
+            for (size_t i = 0; i < changes.size(); i++) {
+                if (n > 0 && changes[n - 1].tx == changes[i].tx && changes[n - 1].ty == changes[i].ty)
+                    changes[n - 1].population += changes[i].population;
+                else
+                    changes[n++] = changes[i];
+            }
+            changes.resize(n);
+        }
+
+        for (size_t i = 0; i < changes.size(); i++)
+            if (changes[i].population != 0)
+                add(level, changes[i].tx, changes[i].ty, changes[i].population);
+    }
+}
+
+
+void regionIndex::grow()
+{
+    std::vector<uint64_t> oldKeys, oldCounts;
+    std::vector<uint8_t> oldUsed;
+    oldKeys.swap(keys);
+    oldCounts.swap(counts);
+    oldUsed.swap(used);
+
+    keys.assign(oldKeys.size() * 2, 0);
+    counts.assign(oldKeys.size() * 2, 0);
+    used.assign(oldKeys.size() * 2, 0);
+    mask = keys.size() - 1;
+    for (size_t i = 0; i < oldKeys.size(); i++) {
+        if (oldUsed[i]) {
+            size_t j = slotFor(oldKeys[i]);
+            used[j] = 1;
+            keys[j] = oldKeys[i];
+            counts[j] = oldCounts[i];
+        }
+    }
+}
+
+
+void regionIndex::box(int level, int qx, int qy, int64_t& minX, int64_t& minY, int64_t& maxX, int64_t& maxY)
+{
+    int64_t side = (int64_t)1 << (level + 6);
+    minX = (int64_t)qx * side;
+    minY = (int64_t)qy * side;
+    maxX = minX + side - 1;
+    maxY = minY + side - 1;
+}
+
+
+uint64_t regionIndex::distance(int64_t dx, int64_t dy)
+{
+    uint64_t a = (uint64_t)(dx < 0 ? -dx : dx), b = (uint64_t)(dy < 0 ? -dy : dy);
+    uint64_t top = std::numeric_limits<uint64_t>::max();
+    if (a > 0xFFFFFFFFull || b > 0xFFFFFFFFull)
+        return top;
+    a *= a;
+    b *= b;
+    return a > top - b ? top : a + b;
+}
+
+
+uint64_t regionIndex::cellDistance(int ax, int ay, int bx, int by)
+{
+    return distance((int64_t)ax - bx, (int64_t)ay - by);
+}
+
+
+uint64_t regionIndex::boxDistance(int level, int qx, int qy, int x, int y)
+{
+    int64_t minX, minY, maxX, maxY;
+    box(level, qx, qy, minX, minY, maxX, maxY);
+    int64_t dx = x < minX ? minX - x : (x > maxX ? x - maxX : 0);
+    int64_t dy = y < minY ? minY - y : (y > maxY ? y - maxY : 0);
+    return distance(dx, dy);
+}
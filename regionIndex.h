@@ -0,0 +1,171 @@
+#ifndef REGION_INDEX_H
+#define REGION_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+// Rectangle of cells, corners included
+struct cellRect
+{
+    int minX, minY, maxX, maxY;
+
+    bool contains(int x, int y) const { return x >= minX && x <= maxX && y >= minY && y <= maxY; }
+};
+
+// Quadtree of population counts over 64x64 tiles. Level 0 holds the population of each tile, and
+// the node (level, qx, qy) the population of the tiles (tx, ty) with tx >> level == qx and
+// ty >> level == qy. Every level is one open addressing table keyed by the node, so setting a tile
+// touches one entry per level and the children of a node are found without pointers. Tile
+// coordinates span [-2^25, 2^25) as in the tile engine, so level TOP has at most four nodes.
+//
+// The queries take the region in cells and call back to the owner of the tiles for the cells of a
+// tile the region only partly covers, so a query costs O(log N) nodes along the edges of the region
+// plus the tiles it has to look into.
+class regionIndex
+{
+public:
+    static const int TOP = 25;
+
+    regionIndex();
+
+    struct tileCount
+    {
+        int tx, ty;
+        uint64_t population;
+    };
+
+    void clear();
+    void set(int tx, int ty, uint64_t population);    // Updates the tile and every node above it
+
+    // Sets many tiles, merging the changes of tiles that share a node before going up a level, so a
+    // node is updated once however many of its tiles changed. Reorders 'changes'.
+    void set(std::vector<tileCount>& changes);
+    uint64_t population(int level, int qx, int qy) const;
+    size_t nodeCount() const { return nodes; }
+    size_t liveNodes() const { return live; }         // Nodes with a population
+
+    // Population of the region. inTile(tx, ty) returns the cells of that tile inside the region, for
+    // the tiles the region does not cover whole.
+    template <class F> uint64_t count(const cellRect& region, F inTile) const
+    {
+        uint64_t total = 0;
+        forTop(region, [&](int qx, int qy) { total += countNode(TOP, qx, qy, region, inTile); });
+        return total;
+    }
+
+    // Calls tile(tx, ty) for every tile with live cells that the region overlaps
+    template <class F> void forEach(const cellRect& region, F tile) const
+    {
+        forTop(region, [&](int qx, int qy) { visitNode(TOP, qx, qy, region, tile); });
+    }
+
+    // Finds the live cell nearest to (x, y) by Euclidean distance, best first: nodes are taken in
+    // order of the distance to their box, and nearestIn(tx, ty, x, y, nearX, nearY) finds the
+    // nearest cell of a tile, returning false if it has none. Returns false if there are no cells.
+    template <class F> bool nearest(int x, int y, F nearestIn, int& nearX, int& nearY) const
+    {
+        // Level -1 entries are cells, whose distance is exact
+        struct entry
+        {
+            uint64_t distance;
+            int level, qx, qy;
+            bool operator>(const entry& other) const { return distance > other.distance; }
+        };
+        std::priority_queue<entry, std::vector<entry>, std::greater<entry>> queue;
+
+        for (int qx = -1; qx <= 0; qx++)
+            for (int qy = -1; qy <= 0; qy++)
+                if (population(TOP, qx, qy) > 0)
+                    queue.push(entry{ boxDistance(TOP, qx, qy, x, y), TOP, qx, qy });
+
+        while (!queue.empty()) {
+            entry e = queue.top();
+            queue.pop();
+            if (e.level < 0) {
+                nearX = e.qx;
+                nearY = e.qy;
+                return true;
+            }
+            if (e.level == 0) {
+                int cx, cy;
+                if (nearestIn(e.qx, e.qy, x, y, cx, cy))
+                    queue.push(entry{ cellDistance(cx, cy, x, y), -1, cx, cy });
+                continue;
+            }
+            for (int k = 0; k < 4; k++) {
+                int cx = 2 * e.qx + (k & 1), cy = 2 * e.qy + (k >> 1);
+                if (population(e.level - 1, cx, cy) > 0)
+                    queue.push(entry{ boxDistance(e.level - 1, cx, cy, x, y), e.level - 1, cx, cy });
+            }
+        }
+        return false;
+    }
+
+    static uint64_t cellDistance(int ax, int ay, int bx, int by);
+    static uint64_t distance(int64_t dx, int64_t dy);    // dx^2 + dy^2, saturating
+
+private:
+    // Cells covered by a node
+    static void box(int level, int qx, int qy, int64_t& minX, int64_t& minY, int64_t& maxX, int64_t& maxY);
+    static uint64_t boxDistance(int level, int qx, int qy, int x, int y);
+    static uint64_t key(int level, int qx, int qy);
+    size_t slotFor(uint64_t k) const;
+    void add(int level, int qx, int qy, uint64_t change);
+    void grow();
+
+    // The top level nodes the region overlaps
+    template <class F> static void forTop(const cellRect& region, F f)
+    {
+        for (int qx = (region.minX >> 6) >> TOP; qx <= (region.maxX >> 6) >> TOP; qx++)
+            for (int qy = (region.minY >> 6) >> TOP; qy <= (region.maxY >> 6) >> TOP; qy++)
+                f(qx, qy);
+    }
+
+    // Where a node lies against the region: 0 outside, 1 partly inside, 2 inside
+    static int overlap(int level, int qx, int qy, const cellRect& region)
+    {
+        int64_t minX, minY, maxX, maxY;
+        box(level, qx, qy, minX, minY, maxX, maxY);
+        if (maxX < region.minX || minX > region.maxX || maxY < region.minY || minY > region.maxY)
+            return 0;
+        return minX >= region.minX && maxX <= region.maxX && minY >= region.minY && maxY <= region.maxY ? 2 : 1;
+    }
+
+    template <class F> uint64_t countNode(int level, int qx, int qy, const cellRect& region, F& inTile) const
+    {
+        uint64_t here = population(level, qx, qy);
+        int where = here > 0 ? overlap(level, qx, qy, region) : 0;
+        if (where != 1)
+            return where == 2 ? here : 0;
+        if (level == 0)
+            return inTile(qx, qy);
+
+        uint64_t total = 0;
+        for (int k = 0; k < 4; k++)
+            total += countNode(level - 1, 2 * qx + (k & 1), 2 * qy + (k >> 1), region, inTile);
+        return total;
+    }
+
+    template <class F> void visitNode(int level, int qx, int qy, const cellRect& region, F& tile) const
+    {
+        if (population(level, qx, qy) == 0 || overlap(level, qx, qy, region) == 0)
+            return;
+        if (level == 0) {
+            tile(qx, qy);
+            return;
+        }
+        for (int k = 0; k < 4; k++)
+            visitNode(level - 1, 2 * qx + (k & 1), 2 * qy + (k >> 1), region, tile);
+    }
+
+    std::vector<uint64_t> keys;
+    std::vector<uint64_t> counts;
+    std::vector<uint8_t> used;
+    size_t mask;
+    size_t nodes;
+    size_t live;
+};
+
+#endif
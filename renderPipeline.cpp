@@ -0,0 +1,130 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   The pipelined game loop. The simulation thread owns the engine: it steps, reads the cells back for
+   the end-of-game checks, and copies the ones inside the viewport into a ring slot only when one is
+   free, so a slow terminal costs it nothing beyond the skipped copies. The calling thread wakes at the
+   frame rate, takes the newest snapshot, draws it and a status line, and sleeps until the next frame
+   is due; when drawing takes longer than a frame the schedule restarts from now instead of trying to
+   catch up.
+
+   The last generation is always drawn: the simulation thread waits for a free slot for it before it
+   signals that it has finished, and the renderer takes one more snapshot after seeing the signal.
+*/
+
+// Headers
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "renderPipeline.h"
+#include "snapshotRing.h"
+
+
+pipelineStats runPipeline(lifeEngine& engine, frameRenderer& screen, double fps, const gameOverCheck& gameOver,
+    std::atomic<bool>& stop, metricsLog* metrics)
+{
+    typedef std::chrono::steady_clock timer;
+
+    snapshotRing ring;
+    std::atomic<bool> finished(false);
+    pipelineStats stats = {};
+
+    // Only the cells the renderer can show go into a snapshot, still as offsets from the engine's
+    // origin, which the snapshot carries to the renderer
+    auto visible = [&](const std::vector<int>& X, const std::vector<int>& Y, lifeSnapshot* slot) {
+        engine.origin(slot->originX, slot->originY);
+        slot->population = X.size();
+        slot->X.clear();
+        slot->Y.clear();
+        cellRect view;
+        if (!screen.viewport(slot->originX, slot->originY, view))
+            return;
+        for (size_t i = 0; i < X.size(); i++) {
+            if (view.contains(X[i], Y[i])) {
+                slot->X.push_back(X[i]);
+                slot->Y.push_back(Y[i]);
+            }
+        }
+    };
+
+    std::thread simulation([&]() {
+        std::vector<int> X, Y;
+        uint64_t generation = 0;
+        bool shown = true;
+
+        while (!stop.load(std::memory_order_relaxed)) {
+            {
+                METRIC_PHASE(PHASE_STEP);
+                engine.step();
+            }
+            generation++;
+            engine.store(X, Y);
+
+            shown = false;
+            if (lifeSnapshot* slot = ring.claim()) {
+                slot->generation = generation;
+                visible(X, Y, slot);
+                ring.publish();
+                shown = true;
+            }
+            else
+                stats.skippedBySimulation++;
+
+            if (metrics) {
+                int64_t originX, originY;
+                engine.origin(originX, originY);
+                metrics->record(measureGeneration(generation, X, Y, originX, originY));
+            }
+
+            stats.reason = gameOver(X, Y, generation);
+            if (!stats.reason.empty())
+                break;
+        }
+
+        // Make sure the final generation reaches the screen
+        if (!shown) {
+            lifeSnapshot* slot;
+            while (!(slot = ring.claim()))
+                std::this_thread::yield();
+            slot->generation = generation;
+            visible(X, Y, slot);
+            ring.publish();
+            stats.skippedBySimulation--;
+        }
+        stats.generations = generation;
+        finished.store(true, std::memory_order_release);
+    });
+
+    timer::duration interval = std::chrono::duration_cast<timer::duration>(std::chrono::duration<double>(1.0 / fps));
+    timer::time_point due = timer::now();
+    for (;;) {
+        bool done = finished.load(std::memory_order_acquire);
+
+        if (const lifeSnapshot* snap = ring.latest()) {
+            METRIC_PHASE(PHASE_RENDER);
+            screen.draw(snap->X, snap->Y, snap->originX, snap->originY);
+            std::cout << "Generation " << snap->generation << ", " << snap->population << " cells\x1b[K" << std::flush;
+            ring.release();
+            stats.frames++;
+        }
+        if (done)
+            break;
+
+        due += interval;
+        timer::time_point now = timer::now();
+        if (due < now)
+            due = now;
+        else
+            std::this_thread::sleep_until(due);
+    }
+
+    simulation.join();
+    stats.skippedByRenderer = ring.dropped();
+    std::cout << "\n";
+    return stats;
+}
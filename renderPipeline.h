@@ -0,0 +1,35 @@
+#ifndef RENDER_PIPELINE_H
+#define RENDER_PIPELINE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "lifeEngine.h"
+#include "drawGrid.h"
+#include "metrics.h"
+
+// Called on the simulation thread after every generation with the live cells and the generation
+// number. Returns why the game ends there, or an empty string to go on.
+typedef std::function<std::string(const std::vector<int>& X, const std::vector<int>& Y, uint64_t generation)> gameOverCheck;
+
+struct pipelineStats
+{
+    uint64_t generations;
+    size_t frames;              // Frames drawn
+    size_t skippedByRenderer;   // Snapshots replaced by a newer one before they were drawn
+    size_t skippedBySimulation; // Generations not snapshotted because every slot was waiting to be drawn
+    std::string reason;         // What ended the run, empty if it was stopped
+};
+
+// Runs the game with stepping and drawing decoupled. A simulation thread steps the engine as fast as
+// it can and hands snapshots to the calling thread through a snapshotRing; the calling thread draws
+// the newest one at up to fps frames per second. The simulation never waits for the display, and
+// the frame on screen is never more than one frame interval behind it. Setting stop ends the run
+// after the current generation. If metrics is given, the simulation thread records every generation.
+pipelineStats runPipeline(lifeEngine& engine, frameRenderer& screen, double fps, const gameOverCheck& gameOver,
+    std::atomic<bool>& stop, metricsLog* metrics = nullptr);
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef SNAPSHOT_RING_H
+#define SNAPSHOT_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One generation as handed from the simulation to the renderer
+struct lifeSnapshot
+{
+    uint64_t generation;
+    int64_t originX, originY;   // Of the engine, which the cells are offsets from
+    size_t population;
+    std::vector<int> X, Y;    // Only the cells inside the renderer's viewport
+};
+
+// Bounded lock-free ring between exactly one producer and one consumer. The producer fills the slot
+// it claims and publishes it; if every slot is still waiting to be drawn, claim returns nullptr and
+// that generation is simply not snapshotted, so the producer never waits. The consumer only ever
+// takes the newest published snapshot and frees the older ones unread, so what it draws is at most
+// one frame behind. A slot's vectors keep their capacity, so snapshots stop allocating once the
+// pattern has reached its largest size.
+class snapshotRing
+{
+public:
+    explicit snapshotRing(size_t capacity = 4) : slots(capacity), head(0), tail(0), skipped(0) {}
+
+    // Producer side
+    lifeSnapshot* claim()
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == slots.size())
+            return nullptr;
+        return &slots[h % slots.size()];
+    }
+
+    void publish()
+    {
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Consumer side: the newest snapshot not yet taken, or nullptr. It stays valid until release.
+    const lifeSnapshot* latest()
+    {
+        size_t h = head.load(std::memory_order_acquire);
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (h == t)
+            return nullptr;
+
+        skipped += h - 1 - t;
+        tail.store(h - 1, std::memory_order_release);
+        return &slots[(h - 1) % slots.size()];
+    }
+
+    void release()
+    {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Published snapshots the consumer passed over for a newer one
+    size_t dropped() const { return skipped; }
+
+private:
+    std::vector<lifeSnapshot> slots;
+    alignas(64) std::atomic<size_t> head;    // Snapshots published
+    alignas(64) std::atomic<size_t> tail;    // Snapshots released by the consumer
+    size_t skipped;
+};
+
+#endif
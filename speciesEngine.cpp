@@ -0,0 +1,666 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   Multi-species Life on 64x64 tiles. A cell's state is one bit in each of the species planes, at
+   most one of them set, so with two species (Immigration) a cell takes two bits and with four
+   (QuadLife) four. Stepping a tile first lays out, as in the tile engine, 66 rows of west, centre
+   and east neighbour words for every plane and for their OR. The row kernel then:
+
+      1. advances the OR with nextCells, which says which cells live, exactly like one species;
+      2. copies every species plane masked by that, so survivors keep their species;
+      3. only if the rows hold a birth, counts the neighbours of each species with one adder tree
+         per plane, four bit planes of count each, and adds every newborn to the plane its species
+         was picked from. Every newborn gets exactly one species, so the last species takes the
+         newborns no other species picked.
+
+   When the rule's only birth count is 3 the pick is cheap and the last species is never counted: of
+   three parents, the species with two or more is the one with the twos bit of its count set; with
+   none such the parents are three different species and the newborn takes the lowest species with
+   no count. Other rules compare the counts pairwise with bit-sliced comparisons.
+
+   The halo rows are built with the vector shifts of bitKernel.h, as the compiler does not vectorize
+   those loops on its own at -O2 and they cost as much as the kernel otherwise.
+
+   Empty tiles are dropped every SWEEP_INTERVAL steps. After every step each tile with live cells on
+   an edge gets the neighbour past that edge, so every cell that could be born is in a stored tile.
+*/
+
+// Headers
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "speciesEngine.h"
+#include "bitKernel.h"
+#include "drawGrid.h"
+#include "cellPairs.h"
+#include "metrics.h"
+
+
+const int SPECIES_TILE_RANGE = 1 << 25;     // As the tile engine, cell coordinates cover the int range
+const size_t SPECIES_BATCH = 8;
+const uint64_t SWEEP_INTERVAL = 64;
+const int GRIDSIZE_SPECIES = 40;    // Side of the window drawn by runSpecies
+
+const uint8_t EDGE_W = 1, EDGE_E = 2, EDGE_S = 4, EDGE_N = 8;
+const uint8_t EDGE_SW = 16, EDGE_SE = 32, EDGE_NW = 64, EDGE_NE = 128;
+
+
+std::string speciesRule::name() const
+{
+    if (life == LIFE && species == 2)
+        return "Immigration";
+    if (life == LIFE && species == 4)
+        return "QuadLife";
+    return life.name() + " with " + std::to_string(species) + " species";
+}
+
+
+bool parseSpecies(const std::string& text, speciesRule& rule)
+{
+    std::string lower;
+    for (char c : text)
+        lower += (char)tolower((unsigned char)c);
+
+    if (lower == "immigration")
+        rule = IMMIGRATION;
+    else if (lower == "quadlife")
+        rule = QUADLIFE;
+    else if (lower.size() == 1 && lower[0] >= '2' && lower[0] <= '0' + MAX_SPECIES)
+        rule = { LIFE, lower[0] - '0' };
+    else
+        return false;
+    return true;
+}
+
+
+static inline int wrapTile(int t)
+{
+    return (int)(((uint32_t)t + SPECIES_TILE_RANGE) & (2 * SPECIES_TILE_RANGE - 1)) - SPECIES_TILE_RANGE;
+}
+
+
+template <class Op>
+static inline bool anySet(typename Op::V v)
+{
+    uint64_t words[Op::lanes];
+    Op::store(words, v);
+    uint64_t any = 0;
+    for (int i = 0; i < Op::lanes; i++)
+        any |= words[i];
+    return any != 0;
+}
+
+
+// Picks the species of the newborns from the per-species neighbour counts, setting win[s] where species
+// s + 1 is chosen, for every species but the last: exactly one species is picked, so the last one takes
+// whatever is left. THREE: the newborns have exactly three live neighbours, and only the first
+// species - 1 counts are needed, of which only the low two bits can be set.
+template <class Op, bool THREE>
+static inline void pickSpecies(typename Op::V (*count)[4], int species, typename Op::V* win)
+{
+    typedef typename Op::V V;
+
+    if (THREE) {
+        // Two or three parents of one species make the twos bit of its count. Otherwise the parents
+        // are of three species, which needs two of the counted ones.
+        V major = Op::zero(), seen = Op::zero(), twice = Op::zero(), taken = Op::zero();
+        V absent[MAX_SPECIES];
+        for (int s = 0; s < species - 1; s++) {
+            V present = Op::orV(count[s][0], count[s][1]);
+            major = Op::orV(major, count[s][1]);
+            twice = Op::orV(twice, Op::andV(seen, present));
+            seen = Op::orV(seen, present);
+            absent[s] = Op::andNot(Op::orV(taken, present), Op::ones());
+            taken = Op::orV(taken, absent[s]);
+        }
+        V mixed = Op::andNot(major, twice);
+        for (int s = 0; s < species - 1; s++)
+            win[s] = Op::orV(count[s][1], Op::andV(mixed, absent[s]));
+
+        // Three species of three: all are present and the lowest is picked. Of four the last is absent.
+        if (species == 3)
+            win[0] = Op::orV(win[0], Op::andNot(taken, mixed));
+        return;
+    }
+
+    // Lowest species with no neighbours, and whether there is one
+    V absent[MAX_SPECIES], taken = Op::zero();
+    for (int s = 0; s < species; s++) {
+        V none = Op::andNot(Op::orV(Op::orV(count[s][0], count[s][1]), Op::orV(count[s][2], count[s][3])), Op::ones());
+        absent[s] = Op::andNot(taken, none);
+        taken = Op::orV(taken, none);
+    }
+
+    // greater[s][t]: count s > count t; equal[s][t]: count s == count t
+    V greater[MAX_SPECIES][MAX_SPECIES], equal[MAX_SPECIES][MAX_SPECIES];
+    for (int s = 0; s < species; s++) {
+        for (int t = s + 1; t < species; t++) {
+            V gt = Op::zero(), eq = Op::ones();
+            for (int k = 3; k >= 0; k--) {
+                gt = Op::orV(gt, Op::andV(eq, Op::andNot(count[t][k], count[s][k])));
+                eq = Op::andNot(Op::xorV(count[s][k], count[t][k]), eq);
+            }
+            greater[s][t] = gt;
+            equal[s][t] = equal[t][s] = eq;
+            greater[t][s] = Op::andNot(Op::orV(gt, eq), Op::ones());
+        }
+    }
+
+    // A unique most common species wins; on a tie the lowest absent species, else the lowest tied
+    V unique[MAX_SPECIES], lowest[MAX_SPECIES], anyUnique = Op::zero();
+    for (int s = 0; s < species; s++) {
+        unique[s] = lowest[s] = Op::ones();
+        for (int t = 0; t < species; t++) {
+            if (t == s)
+                continue;
+            unique[s] = Op::andV(unique[s], greater[s][t]);
+            lowest[s] = Op::andV(lowest[s], s < t ? Op::orV(greater[s][t], equal[s][t]) : greater[s][t]);
+        }
+        anyUnique = Op::orV(anyUnique, unique[s]);
+    }
+    V tied = Op::andNot(anyUnique, Op::ones());
+    V full = Op::andNot(taken, tied);
+    for (int s = 0; s < species - 1; s++)
+        win[s] = Op::orV(unique[s], Op::orV(Op::andV(tied, absent[s]), Op::andV(full, lowest[s])));
+}
+
+
+// Advances the 64 rows of a tile. Index 0 of L, C and R is the OR of the species planes, index s the
+// plane of species s; each holds 66 rows, -1 to 64, shifted so that bit i holds the west neighbour,
+// the cell itself and the east neighbour respectively. out[s - 1] receives species s.
+template <class Op, uint32_t MASK, bool THREE>
+static void stepSpecies(uint64_t (*L)[TILESIZE + 2], uint64_t (*C)[TILESIZE + 2], uint64_t (*R)[TILESIZE + 2],
+    uint64_t (*out)[TILESIZE], int species, uint32_t mask)
+{
+    typedef typename Op::V V;
+
+    int counted = THREE ? species - 1 : species;
+    for (int r = 1; r <= TILESIZE; r += Op::lanes) {
+        V alive = Op::load(C[0] + r);
+        V next = nextCells<Op, MASK>(Op::load(L[0] + r - 1), Op::load(C[0] + r - 1), Op::load(R[0] + r - 1),
+            Op::load(L[0] + r), Op::load(R[0] + r), Op::load(L[0] + r + 1), Op::load(C[0] + r + 1), Op::load(R[0] + r + 1),
+            alive, mask);
+        V born = Op::andNot(alive, next);
+
+        if (!anySet<Op>(born)) {
+            for (int s = 1; s <= species; s++)
+                Op::store(out[s - 1] + r - 1, Op::andV(Op::load(C[s] + r), next));
+            continue;
+        }
+
+        V count[MAX_SPECIES][4], win[MAX_SPECIES];
+        for (int s = 1; s <= counted; s++) {
+            neighbourCount<Op>(Op::load(L[s] + r - 1), Op::load(C[s] + r - 1), Op::load(R[s] + r - 1),
+                Op::load(L[s] + r), Op::load(R[s] + r), Op::load(L[s] + r + 1), Op::load(C[s] + r + 1), Op::load(R[s] + r + 1),
+                count[s - 1]);
+        }
+        pickSpecies<Op, THREE>(count, species, win);
+
+        V rest = born;
+        for (int s = 1; s < species; s++) {
+            V newborn = Op::andV(born, win[s - 1]);
+            rest = Op::andNot(newborn, rest);
+            Op::store(out[s - 1] + r - 1, Op::orV(Op::andV(Op::load(C[s] + r), next), newborn));
+        }
+        Op::store(out[species - 1] + r - 1, Op::orV(Op::andV(Op::load(C[species] + r), next), rest));
+    }
+}
+
+
+speciesEngine::speciesEngine() : species(2), cur(0), steps(0)
+{
+    setRule(LIFE);
+}
+
+
+void speciesEngine::setSpecies(int count)
+{
+    species = std::max(2, std::min(MAX_SPECIES, count));
+}
+
+
+bool speciesEngine::setRule(const lifeRule& rule)
+{
+    if (rule.generations())
+        return false;
+    ruleMask = rule.mask();
+    chooseKernel();
+    return true;
+}
+
+
+void speciesEngine::chooseKernel()
+{
+    bool three = (ruleMask & 0x1FF) == (1u << 3);
+    if (ruleMask == LIFE_MASK)
+        kernel = stepSpecies<simdOps, LIFE_MASK, true>;
+    else if (ruleMask == HIGHLIFE_MASK)
+        kernel = stepSpecies<simdOps, HIGHLIFE_MASK, false>;
+    else if (three)
+        kernel = stepSpecies<simdOps, RUNTIME_MASK, true>;
+    else
+        kernel = stepSpecies<simdOps, RUNTIME_MASK, false>;
+}
+
+
+// Live cells on each edge and corner of a tile
+static uint8_t edgesOf(const uint64_t (*planes)[TILESIZE], int species)
+{
+    const uint64_t WEST = 1ull, EAST = 1ull << 63;
+    uint64_t any = 0, south = 0, north = 0;
+    for (int s = 0; s < species; s++) {
+        for (int r = 0; r < TILESIZE; r++)
+            any |= planes[s][r];
+        south |= planes[s][0];
+        north |= planes[s][TILESIZE - 1];
+    }
+    return (any & WEST ? EDGE_W : 0) | (any & EAST ? EDGE_E : 0) | (south ? EDGE_S : 0) | (north ? EDGE_N : 0)
+        | (south & WEST ? EDGE_SW : 0) | (south & EAST ? EDGE_SE : 0) | (north & WEST ? EDGE_NW : 0) | (north & EAST ? EDGE_NE : 0);
+}
+
+
+// Adds an empty tile and links it with its neighbours. Returns its index.
+int speciesEngine::addTile(int tx, int ty)
+{
+    int index = (int)tiles.push();
+
+    speciesTile& t = tiles[index];
+    t.tx = tx;
+    t.ty = ty;
+    t.empty[0] = t.empty[1] = true;
+    dir.insert(tx, ty, index);
+
+    for (int k = 0; k < 9; k++) {
+        int j = k == 4 ? index : dir.find(wrapTile(tx + k % 3 - 1), wrapTile(ty + k / 3 - 1));
+        t.nb[k] = j;
+        if (j >= 0)
+            tiles[j].nb[8 - k] = index;
+    }
+    return index;
+}
+
+
+// Makes sure the tiles past the edges of tile i that hold live cells exist
+void speciesEngine::expand(size_t i)
+{
+    static const uint8_t side[8] = { EDGE_W, EDGE_E, EDGE_S, EDGE_N, EDGE_SW, EDGE_SE, EDGE_NW, EDGE_NE };
+    static const int slot[8] = { 3, 5, 1, 7, 0, 2, 6, 8 };
+
+    uint8_t edges = tiles[i].edges[cur];
+    for (int d = 0; d < 8; d++) {
+        if ((edges & side[d]) && tiles[i].nb[slot[d]] < 0)
+            addTile(wrapTile(tiles[i].tx + slot[d] % 3 - 1), wrapTile(tiles[i].ty + slot[d] / 3 - 1));
+    }
+}
+
+
+void speciesEngine::load(const std::vector<int>& X, const std::vector<int>& Y)
+{
+    loadSpecies(X, Y, std::vector<int>());
+}
+
+
+void speciesEngine::loadSpecies(const std::vector<int>& X, const std::vector<int>& Y, const std::vector<int>& S)
+{
+    cellPairs cells(X, Y);
+
+    tiles.clear();
+    dir.reset(cells.size() / 64);
+    cur = 0;
+    steps = 0;
+
+    for (size_t i = 0; i < cells.size(); i++) {
+        cellCoord c = cells[i];
+        int tx = c.x >> 6, ty = c.y >> 6;
+        int index = dir.find(tx, ty);
+        if (index < 0)
+            index = addTile(tx, ty);
+
+        int s = i < S.size() && S[i] >= 1 && S[i] <= species ? S[i] - 1 : 0;
+        uint64_t bit = 1ull << (c.x & 63);
+        speciesTile& t = tiles[index];
+        for (int other = 0; other < species; other++)
+            t.planes[cur][other][c.y & 63] &= ~bit;    // A cell listed twice keeps its last species
+        t.planes[cur][s][c.y & 63] |= bit;
+    }
+
+    size_t loaded = tiles.size();
+    for (size_t i = 0; i < loaded; i++) {
+        tiles[i].edges[cur] = edgesOf(tiles[i].planes[cur], species);
+        tiles[i].empty[cur] = false;
+    }
+    for (size_t i = 0; i < loaded; i++)
+        expand(i);
+}
+
+
+// Sets index 0 of L, C and R to the OR of the species planes at rows r to r + Op::lanes - 1
+template <class Op>
+static inline void orPlanes(uint64_t (*L)[TILESIZE + 2], uint64_t (*C)[TILESIZE + 2], uint64_t (*R)[TILESIZE + 2],
+    int species, int r)
+{
+    typename Op::V l = Op::load(L[1] + r), c = Op::load(C[1] + r), e = Op::load(R[1] + r);
+    for (int s = 2; s <= species; s++) {
+        l = Op::orV(l, Op::load(L[s] + r));
+        c = Op::orV(c, Op::load(C[s] + r));
+        e = Op::orV(e, Op::load(R[s] + r));
+    }
+    Op::store(L[0] + r, l);
+    Op::store(C[0] + r, c);
+    Op::store(R[0] + r, e);
+}
+
+
+void speciesEngine::computeTile(speciesTile& t)
+{
+    int next = cur ^ 1;
+
+    const speciesTile* around[9];
+    bool any = false;
+    for (int k = 0; k < 9; k++) {
+        around[k] = t.nb[k] >= 0 && !tiles[t.nb[k]].empty[cur] ? &tiles[t.nb[k]] : nullptr;
+        any |= around[k] != nullptr;
+    }
+    if (!any) {
+        memset(t.planes[next], 0, sizeof(t.planes[next]));
+        t.edges[next] = 0;
+        t.empty[next] = true;
+        return;
+    }
+
+    // Rows -1 to 64 of every plane and of their OR, shifted for the west and east neighbours
+    static const uint64_t none[TILESIZE] = {};
+    uint64_t L[MAX_SPECIES + 1][TILESIZE + 2], C[MAX_SPECIES + 1][TILESIZE + 2], R[MAX_SPECIES + 1][TILESIZE + 2];
+
+    for (int s = 0; s < species; s++) {
+        const uint64_t* column[3][3];
+        for (int k = 0; k < 9; k++)
+            column[k % 3][k / 3] = around[k] ? around[k]->planes[cur][s] : none;
+
+        uint64_t* l = L[s + 1];
+        uint64_t* c = C[s + 1];
+        uint64_t* e = R[s + 1];
+        const uint64_t* west = column[0][1];
+        const uint64_t* centre = column[1][1];
+        const uint64_t* east = column[2][1];
+        for (int r = 0; r < TILESIZE; r += simdOps::lanes) {
+            simdOps::V mid = simdOps::load(centre + r);
+            simdOps::store(l + r + 1, simdOps::orV(simdOps::shiftLeft(mid, 1), simdOps::shiftRight(simdOps::load(west + r), 63)));
+            simdOps::store(c + r + 1, mid);
+            simdOps::store(e + r + 1, simdOps::orV(simdOps::shiftRight(mid, 1), simdOps::shiftLeft(simdOps::load(east + r), 63)));
+        }
+
+        // Row -1 from the tiles below, row 64 from the tiles above
+        for (int dy = 0; dy <= 2; dy += 2) {
+            int row = dy ? 0 : TILESIZE - 1, at = dy ? TILESIZE + 1 : 0;
+            uint64_t mid = column[1][dy][row];
+            l[at] = (mid << 1) | (column[0][dy][row] >> 63);
+            c[at] = mid;
+            e[at] = (mid >> 1) | (column[2][dy][row] << 63);
+        }
+    }
+
+    // The OR of the species; 66 rows is a whole number of vectors of 1 or 2 rows, and for 4 the last
+    // two rows are done alone
+    int r = 0;
+    for (; r + simdOps::lanes <= TILESIZE + 2; r += simdOps::lanes)
+        orPlanes<simdOps>(L, C, R, species, r);
+    for (; r < TILESIZE + 2; r++)
+        orPlanes<scalarOps>(L, C, R, species, r);
+
+    kernel(L, C, R, t.planes[next], species, ruleMask);
+
+    t.edges[next] = edgesOf(t.planes[next], species);
+    t.empty[next] = true;
+    for (int s = 0; s < species && t.empty[next]; s++)
+        for (int r = 0; r < TILESIZE; r++)
+            if (t.planes[next][s][r]) {
+                t.empty[next] = false;
+                break;
+            }
+}
+
+
+void speciesEngine::step()
+{
+    size_t count = tiles.size();
+    size_t batches = (count + SPECIES_BATCH - 1) / SPECIES_BATCH;
+
+    // Tiles only read the current generation and write their own other buffer
+    pool.run(batches, [&](size_t b) {
+        METRIC_PHASE(PHASE_COUNT);
+        size_t end = std::min(count, (b + 1) * SPECIES_BATCH);
+        for (size_t i = b * SPECIES_BATCH; i < end; i++)
+            computeTile(tiles[i]);
+    });
+
+    METRIC_PHASE(PHASE_COMMIT);
+    cur ^= 1;
+    if (++steps % SWEEP_INTERVAL == 0)
+        sweep();
+
+    count = tiles.size();
+    for (size_t i = 0; i < count; i++)
+        if (!tiles[i].empty[cur])
+            expand(i);
+
+    recenterAfter(1);
+}
+
+
+// Drops the empty tiles. Births only happen next to live cells, and expand puts back any tile that
+// a live edge needs.
+void speciesEngine::sweep()
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < tiles.size(); i++)
+        if (!tiles[i].empty[cur])
+            tiles[kept++] = tiles[i];
+    if (kept == tiles.size())
+        return;
+
+    tiles.resize(kept);
+    relink();
+}
+
+
+void speciesEngine::relink()
+{
+    dir.reset(tiles.size());
+    for (size_t i = 0; i < tiles.size(); i++)
+        dir.insert(tiles[i].tx, tiles[i].ty, (int)i);
+    for (size_t i = 0; i < tiles.size(); i++)
+        for (int k = 0; k < 9; k++)
+            tiles[i].nb[k] = dir.find(wrapTile(tiles[i].tx + k % 3 - 1), wrapTile(tiles[i].ty + k / 3 - 1));
+}
+
+
+bool speciesEngine::localBounds(int64_t& minX, int64_t& minY, int64_t& maxX, int64_t& maxY) const
+{
+    if (tiles.empty())
+        return false;
+
+    minX = minY = INT64_MAX;
+    maxX = maxY = INT64_MIN;
+    for (size_t i = 0; i < tiles.size(); i++) {
+        minX = std::min<int64_t>(minX, (int64_t)tiles[i].tx * TILESIZE);
+        maxX = std::max<int64_t>(maxX, (int64_t)tiles[i].tx * TILESIZE + TILESIZE - 1);
+        minY = std::min<int64_t>(minY, (int64_t)tiles[i].ty * TILESIZE);
+        maxY = std::max<int64_t>(maxY, (int64_t)tiles[i].ty * TILESIZE + TILESIZE - 1);
+    }
+    return true;
+}
+
+
+void speciesEngine::shift(int64_t dx, int64_t dy)
+{
+    for (size_t i = 0; i < tiles.size(); i++) {
+        tiles[i].tx = wrapTile((int)(tiles[i].tx - dx / TILESIZE));
+        tiles[i].ty = wrapTile((int)(tiles[i].ty - dy / TILESIZE));
+    }
+    relink();
+}
+
+
+void speciesEngine::store(std::vector<int>& X, std::vector<int>& Y) const
+{
+    std::vector<int> S;
+    storeSpecies(X, Y, S);
+}
+
+
+void speciesEngine::storeSpecies(std::vector<int>& X, std::vector<int>& Y, std::vector<int>& S) const
+{
+    X.clear();
+    Y.clear();
+    S.clear();
+
+    for (size_t i = 0; i < tiles.size(); i++) {
+        const speciesTile& t = tiles[i];
+        if (t.empty[cur])
+            continue;
+        for (int s = 0; s < species; s++) {
+            for (int r = 0; r < TILESIZE; r++) {
+                uint64_t bits = t.planes[cur][s][r];
+                for (int b = 0; bits; b++, bits >>= 1) {
+                    if (bits & 1) {
+                        X.push_back(t.tx * TILESIZE + b);
+                        Y.push_back(t.ty * TILESIZE + r);
+                        S.push_back(s + 1);
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+size_t speciesEngine::population() const
+{
+    std::vector<size_t> counts = speciesPopulation();
+    size_t pop = 0;
+    for (size_t c : counts)
+        pop += c;
+    return pop;
+}
+
+
+std::vector<size_t> speciesEngine::speciesPopulation() const
+{
+    std::vector<size_t> counts(species, 0);
+    for (size_t i = 0; i < tiles.size(); i++)
+        if (!tiles[i].empty[cur])
+            for (int s = 0; s < species; s++)
+                for (int r = 0; r < TILESIZE; r++)
+                    counts[s] += std::bitset<64>(tiles[i].planes[cur][s][r]).count();
+    return counts;
+}
+
+
+void randomSpeciesSoup(int width, int height, double density, int species, unsigned seed,
+    std::vector<int>& X, std::vector<int>& Y, std::vector<int>& S)
+{
+    std::mt19937 rng(seed);
+    std::bernoulli_distribution alive(density);
+    std::uniform_int_distribution<int> kind(1, std::max(1, species));
+
+    X.clear();
+    Y.clear();
+    S.clear();
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (alive(rng)) {
+                X.push_back(x - width / 2);
+                Y.push_back(y - height / 2);
+                S.push_back(kind(rng));
+            }
+        }
+    }
+}
+
+
+int runSpecies(const runOptions& options)
+{
+    typedef std::chrono::steady_clock timer;
+
+    if (rejectFileOptions(options, "Species"))
+        return 1;
+    speciesRule rule;
+    if (!parseSpecies(options.species, rule)) {
+        std::cout << "ERROR: Unknown species '" << options.species << "', use immigration, quadlife or 2 to " << MAX_SPECIES << ".\n";
+        return 1;
+    }
+    if (!options.rule.empty() && !parseRule(options.rule, rule.life)) {
+        std::cout << "ERROR: Unknown rule '" << options.rule << "'.\n";
+        return 1;
+    }
+    if (options.topo != TOPOLOGY_PLANE) {
+        std::cout << "ERROR: Species only run on the plane.\n";
+        return 1;
+    }
+
+    speciesEngine engine;
+    engine.setSpecies(rule.species);
+    if (!engine.setRule(rule.life)) {
+        std::cout << "ERROR: Species need a two-state rule, not " << rule.life.name() << ".\n";
+        return 1;
+    }
+    engine.setThreads(options.threads);
+
+    std::vector<int> X, Y, S;
+    int side = options.soupSize > 0 ? options.soupSize : (options.headless ? 512 : GRIDSIZE_SPECIES);
+    randomSpeciesSoup(side, side, options.density, rule.species, options.seed, X, Y, S);
+
+    std::chrono::steady_clock::time_point start = timer::now();
+    engine.loadSpecies(X, Y, S);
+    double loadMs = msSince(start);
+    std::vector<size_t> initial = engine.speciesPopulation();
+
+    if (!options.headless) {
+        frameRenderer screen(GRIDSIZE_SPECIES, true);
+        double fps = options.fps > 0 ? options.fps : 10;
+        for (uint64_t g = 0; ; g++) {
+            engine.storeSpecies(X, Y, S);
+            int64_t originX, originY;
+            engine.origin(originX, originY);
+            screen.draw(X, Y, S, originX, originY);
+            std::cout << "Generation " << g << ", " << rule.name() << ", " << X.size() << " cells\x1b[K" << std::flush;
+            if (g == options.generations)
+                break;
+            std::this_thread::sleep_for(std::chrono::duration<double>(1.0 / fps));
+            engine.step();
+        }
+        std::cout << "\n";
+        return 0;
+    }
+
+    start = timer::now();
+    engine.run(options.generations);
+    double stepMs = msSince(start);
+    std::vector<size_t> last = engine.speciesPopulation();
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "engine:          species (" << options.threads << " thread" << (options.threads == 1 ? "" : "s") << ")\n";
+    std::cout << "rule:            " << rule.name() << "\n";
+    std::cout << "engine load:     " << loadMs << " ms\n";
+    std::cout << "step:            " << stepMs << " ms\n";
+    std::cout << "generations:     " << options.generations << "\n";
+    std::cout << "population:      " << engine.population() << "\n";
+    for (int s = 0; s < rule.species; s++)
+        std::cout << "  species " << s + 1 << ":      " << initial[s] << " -> " << last[s] << "\n";
+
+    double seconds = stepMs / 1000.0;
+    std::cout << std::setprecision(1);
+    std::cout << "generations/sec: " << (seconds > 0 ? options.generations / seconds : 0) << "\n";
+    return 0;
+}
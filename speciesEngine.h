@@ -0,0 +1,113 @@
+#ifndef SPECIES_ENGINE_H
+#define SPECIES_ENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "headless.h"
+#include "lifeEngine.h"
+#include "lifeRule.h"
+#include "memoryPool.h"
+#include "threadPool.h"
+#include "tileEngine.h"
+
+const int MAX_SPECIES = 4;
+
+// A two-state rule played by competing species. Whether a cell lives is decided by the rule on the
+// total count, as if there was one species. A survivor keeps its species. A newborn takes the
+// species most common among its live neighbours. If several species are tied for most common it
+// takes the lowest-numbered species that has no neighbours there, or the lowest of the tied
+// species if every species does. For three parents that is the majority, or with four species the
+// one missing: Immigration and QuadLife.
+struct speciesRule
+{
+    lifeRule life;
+    int species;
+
+    std::string name() const;    // e.g. "B3/S23 with 4 species"
+};
+
+const speciesRule IMMIGRATION = { LIFE, 2 };
+const speciesRule QUADLIFE = { LIFE, 4 };
+
+// Parses "immigration", "quadlife" or a species count from 2 to MAX_SPECIES, which plays Life until
+// a rule is set. Returns false if the text is none of these.
+bool parseSpecies(const std::string& text, speciesRule& rule);
+
+// One 64x64 block. Bit i of planes[p][s][r] is set if the cell (64 tx + i, 64 ty + r) is alive and
+// of species s + 1, so a cell takes one bit per species and the planes of a row are one word each.
+struct speciesTile
+{
+    int tx, ty;
+    uint64_t planes[2][MAX_SPECIES][TILESIZE];
+    int nb[9];            // Tiles of the 3x3 neighbourhood, index 3 (dy + 1) + dx + 1, -1 if absent
+    uint8_t edges[2];     // Edges and corners with live cells
+    bool empty[2];
+};
+
+// Dense multi-species engine on 64x64 tiles. The live cells of every row are advanced with the same
+// bit-parallel adders as the tile engine on the OR of the species planes, a vector of rows at a
+// time. Survivors keep their planes. Only rows with a birth count their neighbours per species, with
+// one adder tree per species plane, and the newborns' species are picked from those counts.
+//
+// Loading plain X/Y cells makes them all species 1; loadSpecies and storeSpecies carry the species.
+class speciesEngine : public lifeEngine
+{
+public:
+    speciesEngine();
+
+    void load(const std::vector<int>& X, const std::vector<int>& Y) override;
+    void step() override;
+    void store(std::vector<int>& X, std::vector<int>& Y) const override;
+    size_t population() const override;
+    const char* name() const override { return "species"; }
+    void setThreads(int threads) override { pool.resize(threads); }
+    bool setRule(const lifeRule& rule) override;    // Two-state rules only
+
+    void setSpecies(int count);    // 2 to MAX_SPECIES, before load
+    int speciesCount() const { return species; }
+
+    // Cells with their species, 1 to speciesCount(). Species outside that range are loaded as 1.
+    void loadSpecies(const std::vector<int>& X, const std::vector<int>& Y, const std::vector<int>& S);
+    void storeSpecies(std::vector<int>& X, std::vector<int>& Y, std::vector<int>& S) const;
+
+    // Live cells of each species, index 0 for species 1
+    std::vector<size_t> speciesPopulation() const;
+
+protected:
+    bool localBounds(int64_t& minX, int64_t& minY, int64_t& maxX, int64_t& maxY) const override;
+    void shift(int64_t dx, int64_t dy) override;
+
+private:
+    int addTile(int tx, int ty);
+    void expand(size_t i);
+    void sweep();
+    void relink();
+    void computeTile(speciesTile& t);
+
+    slabPool<speciesTile, 5> tiles;    // 32 tiles per slab
+    tileDirectory dir;
+    int species;
+    int cur;
+    uint64_t steps;
+    uint32_t ruleMask;
+    threadPool pool;
+
+    // Row kernel specialized for the current rule. Index 0 of L, C and R is the OR of the species.
+    typedef void (*rowKernel)(uint64_t (*L)[TILESIZE + 2], uint64_t (*C)[TILESIZE + 2], uint64_t (*R)[TILESIZE + 2],
+        uint64_t (*out)[TILESIZE], int species, uint32_t mask);
+    rowKernel kernel;
+    void chooseKernel();
+};
+
+// Fills X/Y/S with a random soup whose live cells are of random species 1 to 'species'
+void randomSpeciesSoup(int width, int height, double density, int species, unsigned seed,
+    std::vector<int>& X, std::vector<int>& Y, std::vector<int>& S);
+
+// Runs the multi-species engine on a random soup of every species, under --rule if given. With
+// --headless it prints timings and the population of each species, otherwise it draws every
+// generation. Returns the process exit code.
+int runSpecies(const runOptions& options);
+
+#endif
@@ -0,0 +1,766 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   Stochastic rules on the bounded universe. The grid, halo and neighbour bitmaps are the bounded
+   engine's; only the row kernel differs. It counts the neighbours of a vector of words into four
+   bit planes with the same adders, then:
+
+      1. picks out the cells of every neighbour count the rule mentions, and ORs in the cells whose
+         outcome is certain;
+      2. for every distinct probability p, selects the cells whose outcome has that probability,
+         and ORs in the ones whose draw U is below p.
+
+   U is a 16-bit number per cell kept bit-sliced: word k of the draws holds bit k of the U of all 64
+   cells, so U < p is found for a whole word with an AND or OR per bit. Every cell is in exactly one
+   outcome, so one U per cell serves all of them. The comparison goes from the top bit down and a
+   cell is decided at the first bit where U and p differ, so after the top SPLIT_BIT bits all but 1
+   in 256 cells are; the rest of the bits are only drawn for the blocks with a cell left, and bits
+   below the lowest set bit of every p are never drawn at all. Skipping bits never changes a draw.
+
+   The draws come from Philox4x32-10, a counter-based generator: ten rounds of multiplies and XORs
+   turn a 128-bit counter and a 64-bit key into 128 random bits, with no state carried from one call
+   to the next. The counter is (64-cell block of x, y, generation, call), the key is the seed. Each
+   call gives two draw words, and a row evaluates the calls of all its blocks in vector batches: the
+   32-bit lanes hold different counters, and the 32x32 -> 64 bit multiplies of SSE2 and AVX2 are
+   applied to the even and odd lanes apart. The engine's words start one cell before the universe,
+   so each one is put together from the draws of the two blocks it overlaps.
+
+   The observables are taken from each row as it is written: the population, the cells that changed,
+   and, on every second row, the 2x2 blocks it forms with the row below, as 16 pattern counts. They
+   are added up in bit-sliced counters, three bit planes per count, and only turned into numbers
+   every seventh word, which costs far less than counting the bits of every word. Bands of
+   BAND_ROWS rows, an even number so no block straddles two, run on the thread pool and each keeps
+   its own counts, which are summed after the step.
+*/
+
+// Headers
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "stochasticEngine.h"
+#include "bitKernel.h"
+#include "benchmark.h"
+#include "drawGrid.h"
+
+
+const int BAND_ROWS = 32;      // Rows per parallel task, even
+const int DRAW_BITS = 16;      // Bits of the uniform number each cell draws
+const int SPLIT_BIT = 8;       // Draw bits below this are only drawn for the blocks that need them
+const uint32_t CERTAIN = 1u << DRAW_BITS;
+const int GRIDSIZE_STOCHASTIC = 40;    // Side of the window drawn by runStochastic
+
+// Philox4x32 multipliers and key increments
+const uint32_t PHILOX_M0 = 0xD2511F53, PHILOX_M1 = 0xCD9E8D57;
+const uint32_t PHILOX_W0 = 0x9E3779B9, PHILOX_W1 = 0xBB67AE85;
+
+
+// 32-bit lanes for Philox, one or more counters at a time
+struct philoxScalar
+{
+    typedef uint32_t V;
+    static const int lanes = 1;
+    static V load(const uint32_t* p) { return *p; }
+    static void store(uint32_t* p, V v) { *p = v; }
+    static V set(uint32_t x) { return x; }
+    static V xorV(V a, V b) { return a ^ b; }
+    static void mulHiLo(V a, uint32_t m, V& hi, V& lo)
+    {
+        uint64_t product = (uint64_t)a * m;
+        hi = (uint32_t)(product >> 32);
+        lo = (uint32_t)product;
+    }
+};
+
+#if defined(__AVX2__)
+struct philoxOps
+{
+    typedef __m256i V;
+    static const int lanes = 8;
+    static V load(const uint32_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+    static void store(uint32_t* p, V v) { _mm256_storeu_si256((__m256i*)p, v); }
+    static V set(uint32_t x) { return _mm256_set1_epi32((int)x); }
+    static V xorV(V a, V b) { return _mm256_xor_si256(a, b); }
+    static void mulHiLo(V a, uint32_t m, V& hi, V& lo)
+    {
+        V factor = set(m), low = _mm256_set1_epi64x(0xFFFFFFFF);
+        V even = _mm256_mul_epu32(a, factor);
+        V odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), factor);
+        lo = _mm256_or_si256(_mm256_and_si256(even, low), _mm256_slli_epi64(odd, 32));
+        hi = _mm256_or_si256(_mm256_srli_epi64(even, 32), _mm256_andnot_si256(low, odd));
+    }
+};
+#elif defined(BIT_KERNEL_SSE2)
+struct philoxOps
+{
+    typedef __m128i V;
+    static const int lanes = 4;
+    static V load(const uint32_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+    static void store(uint32_t* p, V v) { _mm_storeu_si128((__m128i*)p, v); }
+    static V set(uint32_t x) { return _mm_set1_epi32((int)x); }
+    static V xorV(V a, V b) { return _mm_xor_si128(a, b); }
+    static void mulHiLo(V a, uint32_t m, V& hi, V& lo)
+    {
+        V factor = set(m), low = _mm_set_epi32(0, -1, 0, -1);
+        V even = _mm_mul_epu32(a, factor);
+        V odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), factor);
+        lo = _mm_or_si128(_mm_and_si128(even, low), _mm_slli_epi64(odd, 32));
+        hi = _mm_or_si128(_mm_srli_epi64(even, 32), _mm_andnot_si128(low, odd));
+    }
+};
+#else
+typedef philoxScalar philoxOps;
+#endif
+
+
+// Philox4x32-10 on P::lanes counters at once, in place: x[0..3] are the four counter words of every
+// lane, replaced by the random words
+template <class P>
+static void philox(uint32_t* x0, uint32_t* x1, uint32_t* x2, uint32_t* x3, uint64_t key)
+{
+    typedef typename P::V V;
+    V a = P::load(x0), b = P::load(x1), c = P::load(x2), d = P::load(x3);
+    uint32_t k0 = (uint32_t)key, k1 = (uint32_t)(key >> 32);
+
+    for (int round = 0; round < 10; round++) {
+        V hi0, lo0, hi1, lo1;
+        P::mulHiLo(a, PHILOX_M0, hi0, lo0);
+        P::mulHiLo(c, PHILOX_M1, hi1, lo1);
+        a = P::xorV(P::xorV(hi1, b), P::set(k0));
+        b = lo1;
+        c = P::xorV(P::xorV(hi0, d), P::set(k1));
+        d = lo0;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    P::store(x0, a);
+    P::store(x1, b);
+    P::store(x2, c);
+    P::store(x3, d);
+}
+
+
+// Draw words 2 firstCall to 2 endCall - 1 of the 64-cell blocks firstBlock to firstBlock + blocks - 1
+// of row y, or only of those with 'wanted' set. Word k of block i goes to raw[k * blocks + i]. Call j
+// of a block gives words 2j and 2j + 1, so a word is the same whichever words are drawn with it.
+static void drawRow(int64_t firstBlock, size_t blocks, int y, uint64_t generation, uint64_t seed, int firstCall,
+    int endCall, const uint8_t* wanted, uint64_t* raw)
+{
+    const int L = philoxOps::lanes;
+    uint32_t x[4][L];
+    size_t block[L];
+    int call[L];
+    size_t b = 0;
+    int j = firstCall;
+
+    while (wanted && b < blocks && !wanted[b])
+        b++;
+
+    // The calls of a block go to consecutive lanes. Lanes past the last call are computed and dropped.
+    // The generator overwrites its counters, so they are set again for every batch.
+    while (b < blocks) {
+        for (int l = 0; l < L; l++) {
+            block[l] = b;
+            call[l] = j;
+            x[0][l] = (uint32_t)(firstBlock + (int64_t)b);
+            x[1][l] = (uint32_t)y;
+            x[2][l] = (uint32_t)generation;
+            x[3][l] = (uint32_t)(generation >> 32) << 3 | (uint32_t)j;
+            if (b < blocks && ++j == endCall) {
+                j = firstCall;
+                do
+                    b++;
+                while (wanted && b < blocks && !wanted[b]);
+            }
+        }
+        philox<philoxOps>(x[0], x[1], x[2], x[3], seed);
+
+        for (int l = 0; l < L; l++) {
+            if (block[l] < blocks) {
+                raw[(2 * call[l]) * blocks + block[l]] = x[0][l] | (uint64_t)x[1][l] << 32;
+                raw[(2 * call[l] + 1) * blocks + block[l]] = x[2][l] | (uint64_t)x[3][l] << 32;
+            }
+        }
+    }
+}
+
+
+// Cells whose neighbour count, as the bit planes of neighbourCount, is n
+template <class Op>
+static inline typename Op::V countEquals(const typename Op::V* bits, int n)
+{
+    typename Op::V set = Op::ones(), clear = Op::zero();
+    for (int k = 0; k < 4; k++) {
+        if (n >> k & 1)
+            set = Op::andV(set, bits[k]);
+        else
+            clear = Op::orV(clear, bits[k]);
+    }
+    return Op::andNot(clear, set);
+}
+
+
+// Cells whose outcome is in the rule mask, given which cells have each count
+template <class Op>
+static inline typename Op::V outcomes(uint32_t mask, typename Op::V alive, const typename Op::V* is)
+{
+    typename Op::V born = Op::zero(), stays = Op::zero();
+    for (int n = 0; n <= 8; n++) {
+        if (mask >> n & 1)
+            born = Op::orV(born, is[n]);
+        if (mask >> (n + 9) & 1)
+            stays = Op::orV(stays, is[n]);
+    }
+    return Op::orV(Op::andNot(alive, born), Op::andV(alive, stays));
+}
+
+
+// Continues U < p from bit 'from' down to bit 'to' for the cells in 'equal', whose U matched p on the
+// bits above. The words hold the complement of U, which is as random as U. A set bit of p decides
+// the cells whose bit of U is clear, a clear bit of p drops those whose bit is set. Cells still equal
+// at the lowest set bit of p have U >= p.
+template <class Op>
+static inline typename Op::V below(uint32_t p, int from, int to, const uint64_t* words, size_t stride,
+    typename Op::V& equal)
+{
+    typename Op::V less = Op::zero();
+    for (int k = from; k >= to; k--) {
+        typename Op::V u = Op::load(words + k * stride);
+        if (p >> k & 1) {
+            less = Op::orV(less, Op::andV(equal, u));
+            equal = Op::andNot(u, equal);
+        }
+        else
+            equal = Op::andV(equal, u);
+    }
+    return less;
+}
+
+
+// Bit-sliced counter of the set bits of many vectors, three bits per position, emptied into a
+// scalar total every seventh vector
+template <class Op>
+struct bitTally
+{
+    typename Op::V ones, twos, fours;
+    int adds;
+    uint64_t total;
+
+    bitTally() : ones(Op::zero()), twos(Op::zero()), fours(Op::zero()), adds(0), total(0) {}
+
+    void add(typename Op::V x)
+    {
+        typename Op::V carry = Op::andV(ones, x);
+        ones = Op::xorV(ones, x);
+        fours = Op::xorV(fours, Op::andV(twos, carry));
+        twos = Op::xorV(twos, carry);
+        if (++adds == 7)
+            flush();
+    }
+
+    uint64_t flush()
+    {
+        uint64_t o[Op::lanes], t[Op::lanes], f[Op::lanes];
+        Op::store(o, ones);
+        Op::store(t, twos);
+        Op::store(f, fours);
+        for (int l = 0; l < Op::lanes; l++)
+            total += std::bitset<64>(o[l]).count() + 2 * std::bitset<64>(t[l]).count() + 4 * std::bitset<64>(f[l]).count();
+        ones = twos = fours = Op::zero();
+        adds = 0;
+        return total;
+    }
+};
+
+
+static int lowestBit(uint32_t p)
+{
+    int k = 0;
+    while (!(p >> k & 1))
+        k++;
+    return k;
+}
+
+
+static double probability(const std::string& text, bool& ok)
+{
+    char* end;
+    double p = strtod(text.c_str(), &end);
+    ok = !text.empty() && *end == '\0' && p >= 0 && p <= 1;
+    return p;
+}
+
+
+static void appendCounts(std::ostringstream& out, const double* p, bool plain)
+{
+    bool first = true;
+    for (int n = 0; n <= 8; n++) {
+        if (p[n] <= 0)
+            continue;
+        if (!plain && !first)
+            out << ",";
+        out << n;
+        if (p[n] < 1)
+            out << ":" << p[n];
+        first = false;
+    }
+}
+
+
+std::string stochasticRule::name() const
+{
+    bool plain = true;
+    for (int n = 0; n <= 8; n++)
+        plain = plain && (birth[n] == 0 || birth[n] == 1) && (survive[n] == 0 || survive[n] == 1);
+
+    std::ostringstream out;
+    out << "B";
+    appendCounts(out, birth, plain);
+    out << "/S";
+    appendCounts(out, survive, plain);
+    return out.str();
+}
+
+
+stochasticRule stochasticFrom(const lifeRule& rule)
+{
+    stochasticRule result;
+    for (int n = 0; n <= 8; n++) {
+        result.birth[n] = rule.birth >> n & 1;
+        result.survive[n] = rule.survive >> n & 1;
+    }
+    return result;
+}
+
+
+stochasticRule thermalRule(const stochasticRule& rule, double temperature)
+{
+    if (temperature <= 0)
+        return rule;
+
+    double flip = 1 / (1 + std::exp(1 / temperature));
+    stochasticRule result;
+    for (int n = 0; n <= 8; n++) {
+        result.birth[n] = rule.birth[n] * (1 - flip) + (1 - rule.birth[n]) * flip;
+        result.survive[n] = rule.survive[n] * (1 - flip) + (1 - rule.survive[n]) * flip;
+    }
+    return result;
+}
+
+
+bool parseStochastic(const std::string& text, stochasticRule& rule)
+{
+    lifeRule plain;
+    if (parseRule(text, plain)) {
+        if (plain.generations())
+            return false;
+        rule = stochasticFrom(plain);
+        return true;
+    }
+
+    // "B" counts "/S" counts, each count a digit with an optional ":p", separated by commas
+    size_t slash = text.find('/');
+    if (slash == std::string::npos || text.size() < 3 || (text[0] != 'B' && text[0] != 'b') ||
+        slash + 1 >= text.size() || (text[slash + 1] != 'S' && text[slash + 1] != 's'))
+        return false;
+
+    stochasticRule result = stochasticFrom(lifeRule{ 0, 0, 2 });
+    for (int part = 0; part < 2; part++) {
+        std::string counts = part == 0 ? text.substr(1, slash - 1) : text.substr(slash + 2);
+        double* p = part == 0 ? result.birth : result.survive;
+        std::istringstream items(counts);
+        std::string item;
+
+        while (std::getline(items, item, ',')) {
+            if (item.empty() || item[0] < '0' || item[0] > '8')
+                return false;
+            int n = item[0] - '0';
+            bool ok = true;
+            if (item.size() == 1)
+                p[n] = 1;
+            else if (item[1] == ':')
+                p[n] = probability(item.substr(2), ok);
+            else
+                ok = false;
+            if (!ok)
+                return false;
+        }
+    }
+
+    rule = result;
+    return true;
+}
+
+
+double stochasticStats::density() const
+{
+    return cells > 0 ? (double)population / cells : 0;
+}
+
+
+double stochasticStats::activity() const
+{
+    return cells > 0 ? (double)flips / cells : 0;
+}
+
+
+double stochasticStats::entropy() const
+{
+    double bits = 0;
+    for (int i = 0; i < 16; i++) {
+        if (patterns[i] > 0) {
+            double q = (double)patterns[i] / blocks;
+            bits -= q * std::log2(q);
+        }
+    }
+    return bits / 4;
+}
+
+
+stochasticEngine::stochasticEngine(topology topo, int width, int height)
+    : boundedEngine(topo, width, height), seed(0), generation(0), last()
+{
+    setStochastic(stochasticFrom(LIFE), 0);
+    last.cells = (size_t)this->width * this->height;
+
+    blockMask.assign(stride, 0);
+    for (size_t w = 0; w < stride; w++)
+        blockMask[w] = rowMask[w] & rowMask[w] >> 1 & 0x5555555555555555ull;
+}
+
+
+bool stochasticEngine::setRule(const lifeRule& newRule)
+{
+    if (newRule.generations())
+        return false;
+    setStochastic(stochasticFrom(newRule), seed);
+    return true;
+}
+
+
+// Sorts the outcomes into those that are certain and those drawn for, one threshold per distinct
+// probability. Probabilities are rounded to 1/65536ths, so anything below half of one never happens.
+void stochasticEngine::setStochastic(const stochasticRule& newRule, uint64_t newSeed)
+{
+    rule = newRule;
+    seed = newSeed;
+    certain = 0;
+    countsUsed = 0;
+    draws.clear();
+
+    for (int alive = 0; alive < 2; alive++) {
+        for (int n = 0; n <= 8; n++) {
+            double p = alive ? rule.survive[n] : rule.birth[n];
+            uint32_t scaled = (uint32_t)std::min<double>(CERTAIN, std::floor(p * CERTAIN + 0.5));
+            uint32_t bit = 1u << (n + 9 * alive);
+
+            if (scaled == 0)
+                continue;
+            countsUsed |= 1u << n;
+            if (scaled == CERTAIN)
+                certain |= bit;
+            else {
+                auto same = std::find_if(draws.begin(), draws.end(), [&](const threshold& t) { return t.p == scaled; });
+                if (same != draws.end())
+                    same->mask |= bit;
+                else
+                    draws.push_back(threshold{ bit, scaled, lowestBit(scaled) });
+            }
+        }
+    }
+}
+
+
+void stochasticEngine::load(const std::vector<int>& X, const std::vector<int>& Y)
+{
+    boundedEngine::load(X, Y);
+    generation = 0;
+    last = stochasticStats();
+    last.cells = (size_t)width * height;
+    last.population = population();
+}
+
+
+// Advances rows first to first + rows - 1 into 'next' and counts their observables
+void stochasticEngine::computeBand(int first, int rows, stochasticStats& band, bandScratch& scratch)
+{
+    typedef simdOps Op;
+    typedef Op::V V;
+
+    // The engine's word w of a row starts at x = x0 - 1 + 64 w, 'offset' cells into block firstBlock + w
+    int64_t start = (int64_t)x0 - 1;
+    int64_t firstBlock = start >= 0 ? start / 64 : -((-start + 63) / 64);
+    int offset = (int)(start - firstBlock * 64);
+    size_t blocks = stride + 1, groups = draws.size();
+    int lowest = DRAW_BITS;
+    for (const threshold& t : draws)
+        lowest = std::min(lowest, t.low);
+    int split = std::max(lowest, SPLIT_BIT);
+
+    scratch.raw.resize(DRAW_BITS * blocks);
+    scratch.words.resize(DRAW_BITS * stride);
+    scratch.selected.resize(groups * stride);
+    scratch.undecided.resize(groups * stride);
+    scratch.wanted.resize(blocks);
+    uint64_t* raw = scratch.raw.data();
+    uint64_t* words = scratch.words.data();
+
+    // Lines up draw words from..to with the engine's words, all of them or those flagged in 'need'
+    auto align = [&](int from, int to, const uint8_t* need) {
+        for (int k = from; k <= to; k++) {
+            const uint64_t* in = raw + k * blocks;
+            for (size_t w = 0; w < stride; w++)
+                if (!need || need[w])
+                    words[k * stride + w] = offset ? in[w] >> offset | in[w + 1] << (64 - offset) : in[w];
+        }
+    };
+
+    const uint64_t* L = west.data();
+    const uint64_t* C = cells.data();
+    const uint64_t* R = east.data();
+    uint64_t* out = next.data();
+    bitTally<Op> population, flips, patterns[16];
+
+    for (int r = first; r < first + rows; r++) {
+        uint64_t* row = out + r * stride;
+
+        // The certain outcomes, and the cells of each threshold
+        for (size_t w = 0; w < stride; w += Op::lanes) {
+            size_t i = r * stride + w, below = i - stride, above = i + stride;
+            V alive = Op::load(C + i), inside = Op::load(rowMask.data() + w);
+            V bits[4], is[9];
+            neighbourCount<Op>(Op::load(L + below), Op::load(C + below), Op::load(R + below), Op::load(L + i),
+                Op::load(R + i), Op::load(L + above), Op::load(C + above), Op::load(R + above), bits);
+            for (int n = 0; n <= 8; n++)
+                is[n] = countsUsed >> n & 1 ? countEquals<Op>(bits, n) : Op::zero();
+
+            Op::store(row + w, Op::andV(outcomes<Op>(certain, alive, is), inside));
+            for (size_t g = 0; g < groups; g++)
+                Op::store(&scratch.selected[g * stride + w], Op::andV(outcomes<Op>(draws[g].mask, alive, is), inside));
+        }
+
+        // The draws. Comparing U with p from the top bit down decides all but 1 in 2^8 cells on the
+        // top eight bits, so the low bits are only drawn for the blocks that still have a cell to decide.
+        if (groups > 0) {
+            drawRow(firstBlock, blocks, y0 + r - 1, generation, seed, split / 2, DRAW_BITS / 2, nullptr, raw);
+            align(split, DRAW_BITS - 1, nullptr);
+
+            bool undecided = false;
+            for (size_t w = 0; w < stride; w += Op::lanes) {
+                V result = Op::load(row + w);
+                for (size_t g = 0; g < groups; g++) {
+                    const threshold& t = draws[g];
+                    V equal = Op::load(&scratch.selected[g * stride + w]);
+                    result = Op::orV(result, below<Op>(t.p, DRAW_BITS - 1, std::max(t.low, split), words + w, stride, equal));
+                    if (t.low < split)
+                        Op::store(&scratch.undecided[g * stride + w], equal);
+                }
+                Op::store(row + w, result);
+            }
+
+            std::fill(scratch.wanted.begin(), scratch.wanted.end(), 0);
+            for (size_t g = 0; g < groups; g++) {
+                if (draws[g].low >= split)
+                    continue;
+                for (size_t w = 0; w < stride; w++) {
+                    if (scratch.undecided[g * stride + w]) {
+                        scratch.wanted[w] = scratch.wanted[w + 1] = 1;
+                        undecided = true;
+                    }
+                }
+            }
+
+            if (undecided) {
+                drawRow(firstBlock, blocks, y0 + r - 1, generation, seed, lowest / 2, split / 2, scratch.wanted.data(), raw);
+
+                // A word needs the low bits of its own block and, when it straddles two, of the next
+                std::vector<uint8_t>& need = scratch.wanted;
+                for (size_t w = 0; w < stride; w++)
+                    need[w] = need[w] && (need[w + 1] || !offset);
+                align(lowest, split - 1, need.data());
+
+                for (size_t w = 0; w < stride; w++) {
+                    if (!need[w])
+                        continue;
+                    for (size_t g = 0; g < groups; g++) {
+                        const threshold& t = draws[g];
+                        uint64_t equal = t.low < split ? scratch.undecided[g * stride + w] : 0;
+                        if (equal)
+                            row[w] |= below<scalarOps>(t.p, split - 1, t.low, words + w, stride, equal);
+                    }
+                }
+            }
+        }
+
+        // Observables of the finished row, and of the 2x2 blocks of padded columns (2j, 2j + 1) it
+        // forms with the row below on every second row
+        bool pair = (r - first) % 2 == 1;
+        for (size_t w = 0; w < stride; w += Op::lanes) {
+            V now = Op::load(row + w);
+            population.add(now);
+            flips.add(Op::xorV(now, Op::load(C + r * stride + w)));
+            if (!pair)
+                continue;
+
+            V inside = Op::load(blockMask.data() + w), low = Op::load(row - stride + w);
+            V a = Op::andV(low, inside), b = Op::andV(Op::shiftRight(low, 1), inside);
+            V c = Op::andV(now, inside), d = Op::andV(Op::shiftRight(now, 1), inside);
+            V lower[4] = { Op::andNot(Op::orV(a, b), inside), Op::andNot(b, a), Op::andNot(a, b), Op::andV(a, b) };
+            V upper[4] = { Op::andNot(Op::orV(c, d), inside), Op::andNot(d, c), Op::andNot(c, d), Op::andV(c, d) };
+            for (int p = 1; p < 16; p++)
+                patterns[p].add(Op::andV(lower[p & 3], upper[p >> 2]));
+        }
+        if (pair)
+            for (size_t w = 0; w < stride; w++)
+                band.blocks += std::bitset<64>(blockMask[w]).count();
+    }
+
+    band.population = population.flush();
+    band.flips = flips.flush();
+    band.patterns[0] = band.blocks;
+    for (int p = 1; p < 16; p++) {
+        band.patterns[p] = patterns[p].flush();
+        band.patterns[0] -= band.patterns[p];
+    }
+}
+
+
+void stochasticEngine::step()
+{
+    fillHalo();
+    shiftNeighbours();
+
+    size_t bands = (height + BAND_ROWS - 1) / BAND_ROWS;
+    bandStats.resize(bands);
+    bandScratches.resize(bands);
+    pool.run(bands, [&](size_t b) {
+        bandStats[b] = stochasticStats();
+        int first = 1 + (int)b * BAND_ROWS;
+        computeBand(first, std::min(BAND_ROWS, height + 1 - first), bandStats[b], bandScratches[b]);
+    });
+
+    cells.swap(next);
+    generation++;
+
+    last = stochasticStats();
+    last.generation = generation;
+    last.cells = (size_t)width * height;
+    for (const stochasticStats& band : bandStats) {
+        last.population += band.population;
+        last.flips += band.flips;
+        last.blocks += band.blocks;
+        for (int p = 0; p < 16; p++)
+            last.patterns[p] += band.patterns[p];
+    }
+}
+
+
+int runStochastic(const runOptions& options)
+{
+    typedef std::chrono::steady_clock timer;
+
+    if (rejectFileOptions(options, "Stochastic"))
+        return 1;
+    stochasticRule rule;
+    if (!parseStochastic(options.stochastic, rule)) {
+        std::cout << "ERROR: Unknown stochastic rule '" << options.stochastic << "', e.g. B3/S23 or B3:0.9/S2:0.95,3.\n";
+        return 1;
+    }
+    std::string ruleName = rule.name();
+    if (options.temperature > 0) {
+        std::ostringstream name;
+        name << ruleName << " at temperature " << options.temperature;
+        ruleName = name.str();
+    }
+    rule = thermalRule(rule, options.temperature);
+
+    // The noise can bring cells to life anywhere, so the universe has to be bounded
+    topology topo = options.topo == TOPOLOGY_PLANE ? TOPOLOGY_TORUS : options.topo;
+    stochasticEngine engine(topo, options.width, options.height);
+    engine.setStochastic(rule, options.seed);
+    engine.setThreads(options.threads);
+
+    std::vector<int> X, Y;
+    int side = options.soupSize;
+    randomSoup(side > 0 ? side : options.width, side > 0 ? side : options.height, options.density, options.seed, X, Y);
+
+    std::chrono::steady_clock::time_point start = timer::now();
+    engine.load(X, Y);
+    double loadMs = msSince(start);
+    size_t initial = engine.population();
+
+    if (!options.headless) {
+        frameRenderer screen(GRIDSIZE_STOCHASTIC, true);
+        double fps = options.fps > 0 ? options.fps : 10;
+        for (uint64_t g = 0; ; g++) {
+            engine.store(X, Y);
+            screen.draw(X, Y);
+            std::cout << "Generation " << g << ", " << ruleName << ", " << X.size() << " cells, entropy "
+                << std::setprecision(3) << engine.stats().entropy() << "\x1b[K" << std::flush;
+            if (g == options.generations)
+                break;
+            std::this_thread::sleep_for(std::chrono::duration<double>(1.0 / fps));
+            engine.step();
+        }
+        std::cout << "\n";
+        return 0;
+    }
+
+    std::ofstream csv;
+    if (!options.metricsFile.empty()) {
+        csv.open(options.metricsFile);
+        if (!csv) {
+            std::cout << "ERROR: Could not write " << options.metricsFile << "\n";
+            return 1;
+        }
+        csv << "generation,population,density,activity,entropy\n";
+    }
+
+    // The observables come out of the step itself, so reading them costs nothing
+    double stepMs = 0, density = 0, activity = 0, entropy = 0;
+    for (uint64_t g = 0; g < options.generations; g++) {
+        start = timer::now();
+        engine.step();
+        stepMs += msSince(start);
+
+        const stochasticStats& stats = engine.stats();
+        density += stats.density();
+        activity += stats.activity();
+        entropy += stats.entropy();
+        if (csv.is_open())
+            csv << stats.generation << "," << stats.population << "," << stats.density() << "," << stats.activity() << "," << stats.entropy() << "\n";
+    }
+    double runs = options.generations > 0 ? (double)options.generations : 1;
+    const stochasticStats& stats = engine.stats();
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "engine:          stochastic (" << options.threads << " thread" << (options.threads == 1 ? "" : "s") << ")\n";
+    std::cout << "rule:            " << ruleName << "\n";
+    std::cout << "universe:        " << topologyName(topo) << " " << options.width << "x" << options.height << "\n";
+    std::cout << "engine load:     " << loadMs << " ms\n";
+    std::cout << "step:            " << stepMs << " ms\n";
+    std::cout << "generations:     " << options.generations << "\n";
+    std::cout << "population:      " << initial << " -> " << stats.population << "\n";
+    std::cout << std::setprecision(4);
+    std::cout << "density:         " << stats.density() << " last, " << density / runs << " mean\n";
+    std::cout << "activity:        " << stats.activity() << " last, " << activity / runs << " mean\n";
+    std::cout << "block entropy:   " << stats.entropy() << " last, " << entropy / runs << " mean, bits per cell\n";
+
+    double seconds = stepMs / 1000.0;
+    std::cout << std::setprecision(1);
+    std::cout << "generations/sec: " << (seconds > 0 ? options.generations / seconds : 0) << "\n";
+    std::cout << "cells/sec:       " << (seconds > 0 ? (double)stats.cells * options.generations / seconds : 0) << "\n";
+    return 0;
+}
@@ -0,0 +1,112 @@
+#ifndef STOCHASTIC_ENGINE_H
+#define STOCHASTIC_ENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "boundedEngine.h"
+#include "headless.h"
+#include "lifeRule.h"
+#include "threadPool.h"
+
+// Outer totalistic rule with a probability per neighbour count: a dead cell with n live neighbours
+// comes alive with probability birth[n], a live one stays alive with probability survive[n]. A rule
+// whose probabilities are all 0 or 1 is an ordinary two-state rule.
+struct stochasticRule
+{
+    double birth[9];
+    double survive[9];
+
+    std::string name() const;    // "B3/S23" if deterministic, otherwise e.g. "B3:0.9/S2,3:0.99"
+};
+
+stochasticRule stochasticFrom(const lifeRule& rule);
+
+// The rule at temperature T: each outcome is flipped with the Boltzmann probability 1 / (1 + e^(1/T))
+// of paying one unit of energy for it, so T = 0 is the rule itself and a high T approaches a coin toss
+stochasticRule thermalRule(const stochasticRule& rule, double temperature);
+
+// Parses any two-state rule parseRule takes, or birth and survival counts with probabilities, e.g.
+// "B3:0.9,6:0.05/S2,3:0.99". A count without a probability is certain. Returns false if the text is
+// neither.
+bool parseStochastic(const std::string& text, stochasticRule& rule);
+
+// Observables of one generation, gathered while it is computed
+struct stochasticStats
+{
+    uint64_t generation;
+    size_t cells;             // Cells in the universe
+    size_t population;
+    size_t flips;             // Cells whose state changed in the step
+    size_t blocks;            // 2x2 blocks inside the universe, see 'patterns'
+    uint64_t patterns[16];    // Blocks of each pattern, bit 0 the lower left cell, then lower right,
+                              // upper left and upper right
+
+    double density() const;
+    double activity() const;
+    double entropy() const;   // Shannon entropy of the 2x2 block patterns, in bits per cell
+};
+
+// Bounded universe stepped by a stochastic rule. Each cell draws a 16-bit uniform number per
+// generation from a Philox4x32-10 counter-based generator keyed by the seed and counting the cell's
+// 64-cell block, row and generation, so a cell's draw depends only on its coordinates, the generation
+// and the seed: a run gives the same cells for any thread count, and a pattern gives the same
+// history in any universe its cells never reach the edges of.
+class stochasticEngine : public boundedEngine
+{
+public:
+    stochasticEngine(topology topo, int width, int height);
+
+    void load(const std::vector<int>& X, const std::vector<int>& Y) override;    // Restarts at generation 0
+    void step() override;
+    const char* name() const override { return "stochastic"; }
+    void setThreads(int threads) override { pool.resize(threads); }
+    bool setRule(const lifeRule& rule) override;    // Two-state rules only
+
+    void setStochastic(const stochasticRule& rule, uint64_t seed);
+
+    // Observables of the current generation. They are gathered by the step that made it, so before
+    // the first step only the generation, the cell count and the population are set.
+    const stochasticStats& stats() const { return last; }
+
+private:
+    struct threshold
+    {
+        uint32_t mask;    // Rule mask of the outcomes, bit n + 9 alive, that happen with this probability
+        uint32_t p;       // Probability in 1/65536ths, 1 to 65535
+        int low;          // Lowest set bit of p
+    };
+
+    // Buffers of one band's rows, kept between steps
+    struct bandScratch
+    {
+        std::vector<uint64_t> raw;          // Draw words of the 64-cell blocks
+        std::vector<uint64_t> words;        // The same aligned with the engine's words
+        std::vector<uint64_t> selected;     // Cells of each threshold
+        std::vector<uint64_t> undecided;    // Cells of each threshold the top draw bits do not decide
+        std::vector<uint8_t> wanted;        // Blocks whose low draw bits are needed
+    };
+
+    void computeBand(int first, int rows, stochasticStats& band, bandScratch& scratch);
+
+    stochasticRule rule;
+    uint32_t certain;                 // Rule mask of the outcomes that always happen
+    uint32_t countsUsed;              // Neighbour counts the rule tells apart
+    std::vector<threshold> draws;     // Outcomes that need a random draw, one entry per probability
+    uint64_t seed;
+    uint64_t generation;
+    stochasticStats last;
+    std::vector<stochasticStats> bandStats;
+    std::vector<bandScratch> bandScratches;
+    std::vector<uint64_t> blockMask;  // Bit 2j of a word if padded columns 2j and 2j + 1 are inside
+    threadPool pool;
+};
+
+// Runs the stochastic engine on a random soup filling the --bounds universe, a torus unless another
+// --topology is given. With --headless it prints timings and the density, activity and block
+// entropy, and --metrics FILE writes them for every generation as CSV; otherwise it draws every
+// generation. Returns the process exit code.
+int runStochastic(const runOptions& options);
+
+#endif
@@ -0,0 +1,180 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   Checks that stepping does not allocate once a run has warmed up. The global operator new is
+   replaced by one that counts every call from any thread. Each workload is stepped until its
+   buffers have reached their size, and then must get through many more steps without a single
+   allocation. The workloads are fields of blinkers and pulsars, whose population never changes, and
+   the ash of a soup, on calcState and on every engine, serial and threaded. Build from the
+   repository root with
+
+      g++ -std=c++17 -O2 -pthread -I. tests/allocationTest.cpp $(ls *.cpp | grep -v GameofLife2D) -o allocationTest
+
+   The program prints one line per workload and exits with 1 if any of them allocated.
+*/
+
+// Headers
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+#include "calcState.h"
+#include "lifeEngine.h"
+#include "benchmark.h"
+#include "threadPool.h"
+
+
+static std::atomic<size_t> allocations(0);
+
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+
+// Steps before counting, and steps counted
+const int WARM_UP = 200;
+const int MEASURED = 1000;
+
+static int failures = 0;
+
+
+// Runs 'step' WARM_UP times, then counts the allocations of MEASURED more
+static void measure(const std::string& name, const std::function<void()>& step)
+{
+    for (int g = 0; g < WARM_UP; g++)
+        step();
+
+    size_t before = allocations.load();
+    for (int g = 0; g < MEASURED; g++)
+        step();
+    size_t made = allocations.load() - before;
+
+    std::cout << name << ": " << made << " allocations in " << MEASURED << " steps\n";
+    if (made) {
+        std::cout << "ERROR: " << name << " allocates after warming up\n";
+        failures++;
+    }
+}
+
+
+// A grid of blinkers, or of pulsars, spaced so that they never touch
+static void oscillatorField(bool pulsars, std::vector<int>& X, std::vector<int>& Y)
+{
+    static const char* PULSAR[] = {
+        "..OOO...OOO..", ".............", "O....O.O....O", "O....O.O....O", "O....O.O....O", "..OOO...OOO..",
+        ".............", "..OOO...OOO..", "O....O.O....O", "O....O.O....O", "O....O.O....O", ".............",
+        "..OOO...OOO.." };
+
+    X.clear();
+    Y.clear();
+    for (int i = 0; i < 20; i++) {
+        for (int j = 0; j < 20; j++) {
+            if (!pulsars) {
+                for (int k = 0; k < 3; k++) {
+                    X.push_back(6 * i + k);
+                    Y.push_back(6 * j);
+                }
+                continue;
+            }
+            for (int r = 0; r < 13; r++)
+                for (int c = 0; c < 13; c++)
+                    if (PULSAR[r][c] == 'O') {
+                        X.push_back(17 * i + c);
+                        Y.push_back(17 * j + r);
+                    }
+        }
+    }
+}
+
+
+int main()
+{
+    std::vector<int> blinkers, blinkersY, pulsars, pulsarsY, soup, soupY;
+    oscillatorField(false, blinkers, blinkersY);
+    oscillatorField(true, pulsars, pulsarsY);
+
+    // Ash of a soup: run well past its settling time first, so the warm-up only sees the ash. The
+    // gliders it sent out are hundreds of cells away by then and are dropped, as a pattern that keeps
+    // spreading has to grow its storage.
+    std::vector<int> settledX, settledY;
+    randomSoup(64, 64, 0.35, 3, settledX, settledY);
+    for (int g = 0; g < 2000; g++)
+        calcState(settledX, settledY);
+    for (size_t i = 0; i < settledX.size(); i++)
+        if (std::abs(settledX[i]) <= 100 && std::abs(settledY[i]) <= 100) {
+            soup.push_back(settledX[i]);
+            soupY.push_back(settledY[i]);
+        }
+
+    struct workload
+    {
+        std::string name;
+        const std::vector<int>* X;
+        const std::vector<int>* Y;
+    };
+    std::vector<workload> workloads = { { "blinkers", &blinkers, &blinkersY }, { "pulsars", &pulsars, &pulsarsY }, { "ash", &soup, &soupY } };
+
+    for (const workload& w : workloads) {
+        std::vector<int> X = *w.X, Y = *w.Y;
+        measure("calcState/" + w.name, [&] { calcState(X, Y); });
+
+        for (int threads : { 2, 4 }) {
+            threadPool pool(threads);
+            X = *w.X;
+            Y = *w.Y;
+            measure("calcState/" + std::to_string(threads) + "/" + w.name, [&] { calcState(X, Y, pool); });
+        }
+
+        for (char type : { 's', 't', 'm', 'h' }) {
+            for (int threads : { 1, 4 }) {
+                std::unique_ptr<lifeEngine> engine = makeEngine(type);
+                if (threads > 1 && (type == 'm' || type == 'h'))
+                    continue;
+                engine->setThreads(threads);
+                engine->load(*w.X, *w.Y);
+                measure(std::string(engine->name()) + "/" + std::to_string(threads) + "/" + w.name, [&] { engine->step(); });
+            }
+        }
+    }
+
+    if (failures)
+        std::cout << failures << " workloads allocated\n";
+    else
+        std::cout << "allocation: all checks passed\n";
+    return failures ? 1 : 0;
+}
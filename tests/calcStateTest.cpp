@@ -0,0 +1,123 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   Checks the hash-set calcState, serial and band-parallel, against the O(N^2) calcStateNaive on
+   oscillators, spaceships, methuselahs and a soup, and checks that the known oscillators and
+   spaceships come back to their own shape after one period. Build from the repository root with
+
+      g++ -std=c++17 -O2 -pthread -I. tests/calcStateTest.cpp $(ls *.cpp | grep -v GameofLife2D) -o calcStateTest
+
+   The program prints one line per failure and exits with 1 if there was any.
+*/
+
+// Headers
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "calcState.h"
+#include "patterns.h"
+#include "benchmark.h"
+#include "threadPool.h"
+
+
+// Generations each pattern is run for
+const int GENERATIONS = 60;
+
+static int failures = 0;
+
+
+static std::vector<std::pair<int, int>> sorted(const std::vector<int>& X, const std::vector<int>& Y)
+{
+    std::vector<std::pair<int, int>> cells;
+    for (size_t i = 0; i < X.size(); i++)
+        cells.push_back(std::make_pair(X[i], Y[i]));
+    std::sort(cells.begin(), cells.end());
+    return cells;
+}
+
+
+static void check(bool ok, const std::string& what)
+{
+    if (!ok) {
+        std::cout << "ERROR: " << what << "\n";
+        failures++;
+    }
+}
+
+
+// Steps the pattern with every calcState and compares each generation with calcStateNaive
+static void compareWithNaive(const std::string& name, const std::vector<int>& X, const std::vector<int>& Y)
+{
+    std::vector<int> naiveX = X, naiveY = Y, serialX = X, serialY = Y;
+    std::vector<std::vector<int>> bandX(3, X), bandY(3, Y);
+    threadPool pools[3] = { threadPool(1), threadPool(2), threadPool(4) };
+
+    for (int g = 1; g <= GENERATIONS; g++) {
+        calcStateNaive(naiveX, naiveY);
+        calcState(serialX, serialY);
+        std::vector<std::pair<int, int>> want = sorted(naiveX, naiveY);
+
+        check(sorted(serialX, serialY) == want, name + ": serial calcState differs at generation " + std::to_string(g));
+        for (int p = 0; p < 3; p++) {
+            calcState(bandX[p], bandY[p], pools[p]);
+            check(sorted(bandX[p], bandY[p]) == want, name + ": calcState on " + std::to_string(pools[p].size())
+                + " threads differs at generation " + std::to_string(g));
+        }
+    }
+}
+
+
+// Runs the pattern for one period and checks it is the same shape moved by exactly one of the
+// given displacements, which cover the directions it may head in
+static void checkPeriod(const std::string& name, int period, const std::vector<std::pair<int, int>>& moves)
+{
+    std::vector<int> X, Y;
+    namedPattern(name, 0, 0, X, Y);
+    std::vector<std::pair<int, int>> start = sorted(X, Y);
+    for (int g = 0; g < period; g++)
+        calcState(X, Y);
+
+    int matches = 0;
+    for (const std::pair<int, int>& move : moves) {
+        std::vector<int> movedX = X, movedY = Y;
+        for (size_t i = 0; i < X.size(); i++) {
+            movedX[i] -= move.first;
+            movedY[i] -= move.second;
+        }
+        matches += sorted(movedX, movedY) == start;
+    }
+    check(matches == 1, name + ": not the same shape after " + std::to_string(period) + " generations");
+}
+
+
+int main()
+{
+    const char* names[] = { "blinker", "glider", "lwss", "rpentomino", "acorn", "gosper" };
+    for (const char* name : names) {
+        std::vector<int> X, Y;
+        namedPattern(name, -3, 5, X, Y);
+        compareWithNaive(name, X, Y);
+    }
+
+    // A soup across the axes, so that cells have negative coordinates
+    std::vector<int> X, Y;
+    randomSoup(40, 40, 0.35, 7, X, Y);
+    for (size_t i = 0; i < X.size(); i++) {
+        X[i] -= 20;
+        Y[i] -= 20;
+    }
+    compareWithNaive("soup", X, Y);
+
+    checkPeriod("blinker", 2, { { 0, 0 } });
+    checkPeriod("glider", 4, { { 1, 1 }, { 1, -1 }, { -1, 1 }, { -1, -1 } });
+    checkPeriod("lwss", 4, { { 2, 0 }, { -2, 0 }, { 0, 2 }, { 0, -2 } });
+
+    if (failures)
+        std::cout << failures << " checks failed\n";
+    else
+        std::cout << "calcState: all checks passed\n";
+    return failures ? 1 : 0;
+}
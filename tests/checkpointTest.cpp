@@ -0,0 +1,184 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   Checks that a run saved to a checkpoint and resumed carries on exactly as the run that was never
+   stopped. Soups are run on every engine, one of them far enough out that the engine moves its
+   origin and one large enough to span several blocks, saved half way, read back on one thread and
+   on four, loaded into a fresh engine and run to the end. Saving again over the same file has to
+   replace it, and a truncated file has to be refused. Build from the repository root with
+
+      g++ -std=c++17 -O2 -pthread -I. tests/checkpointTest.cpp $(ls *.cpp | grep -v GameofLife2D) -o checkpointTest
+
+   The program writes its checkpoint in the current directory, prints one line per failure and exits
+   with 1 if there was any.
+*/
+
+// Headers
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "benchmark.h"
+#include "checkpoint.h"
+#include "lifeEngine.h"
+#include "lifeRule.h"
+
+
+// Generations run before the checkpoint and after it
+const int HALF = 40;
+const std::string FILE_NAME = "checkpointTest.ckpt";
+
+static int failures = 0;
+
+
+static void check(bool ok, const std::string& what)
+{
+    if (!ok) {
+        std::cout << "ERROR: " << what << "\n";
+        failures++;
+    }
+}
+
+
+// The engine's cells at their position in the plane, modulo 2^32, sorted
+static std::vector<std::pair<int, int>> placed(const lifeEngine& engine)
+{
+    std::vector<int> X, Y;
+    int64_t originX, originY;
+    engine.store(X, Y);
+    engine.origin(originX, originY);
+
+    std::vector<std::pair<int, int>> cells;
+    for (size_t i = 0; i < X.size(); i++)
+        cells.push_back(std::make_pair((int)(uint32_t)(X[i] + originX), (int)(uint32_t)(Y[i] + originY)));
+    std::sort(cells.begin(), cells.end());
+    return cells;
+}
+
+
+// Runs the soup for 2 * HALF generations without stopping, and again with a checkpoint at HALF
+// that is read back and resumed on a fresh engine
+static void resumeMatches(char type, int size, int64_t offset, const lifeRule& rule)
+{
+    std::vector<int> X, Y;
+    randomSoup(size, size, 0.35, 7, X, Y);
+    for (size_t i = 0; i < X.size(); i++)
+        X[i] = (int)(uint32_t)(X[i] + offset);
+
+    std::unique_ptr<lifeEngine> whole = makeEngine(type), first = makeEngine(type);
+    whole->setRule(rule);
+    first->setRule(rule);
+    whole->load(X, Y);
+    first->load(X, Y);
+    for (int g = 0; g < 2 * HALF; g++)
+        whole->step();
+    for (int g = 0; g < HALF; g++)
+        first->step();
+
+    std::string name = std::string(whole->name()) + ", " + std::to_string(size) + " soup at " + std::to_string(offset);
+    checkpointData saved;
+    saved.generation = HALF;
+    saved.rule = rule.name();
+    saved.topo = TOPOLOGY_TORUS;
+    saved.width = 1000;
+    saved.height = 700;
+    first->store(saved.X, saved.Y);
+    first->origin(saved.originX, saved.originY);
+    check(saveCheckpoint(FILE_NAME, saved), name + ": checkpoint not written");
+
+    for (int threads : { 1, 4 }) {
+        std::string at = name + ", read on " + std::to_string(threads) + " threads";
+        checkpointData state;
+        if (!loadCheckpoint(FILE_NAME, state, threads)) {
+            check(false, at + ": checkpoint not read");
+            continue;
+        }
+        check(state.generation == HALF && state.rule == rule.name(), at + ": generation or rule differs");
+        check(state.topo == TOPOLOGY_TORUS && state.width == 1000 && state.height == 700, at + ": topology differs");
+
+        lifeRule resumedRule;
+        check(parseRule(state.rule, resumedRule), at + ": rule does not parse");
+        std::unique_ptr<lifeEngine> rest = makeEngine(type);
+        rest->setRule(resumedRule);
+        rest->setOrigin(state.originX, state.originY);
+        rest->load(state.X, state.Y);
+        check(placed(*rest) == placed(*first), at + ": cells differ from the saved run");
+        for (int g = HALF; g < 2 * HALF; g++)
+            rest->step();
+        check(placed(*rest) == placed(*whole), at + ": resumed run differs from the uninterrupted one");
+    }
+}
+
+
+// Saving over an existing checkpoint replaces it and leaves no temporary file, and a file cut short
+// is refused
+static void replaceAndTruncate()
+{
+    std::vector<int> X, Y;
+    randomSoup(50, 50, 0.35, 3, X, Y);
+    checkpointData state;
+    state.rule = "B3/S23";
+    for (uint64_t generation : { 1, 2 }) {
+        state.generation = generation;
+        state.X = X;
+        state.Y = Y;
+        check(saveCheckpoint(FILE_NAME, state), "checkpoint " + std::to_string(generation) + " not written");
+    }
+
+    checkpointData read;
+    check(loadCheckpoint(FILE_NAME, read) && read.generation == 2, "second checkpoint did not replace the first");
+    FILE* temp = fopen((FILE_NAME + ".tmp").c_str(), "rb");
+    check(!temp, "temporary file left behind");
+    if (temp)
+        fclose(temp);
+
+    // Drop the last bytes, which hold the checksum
+    std::vector<char> bytes;
+    if (FILE* f = fopen(FILE_NAME.c_str(), "rb")) {
+        char buffer[4096];
+        size_t got;
+        while ((got = fread(buffer, 1, sizeof(buffer), f)) > 0)
+            bytes.insert(bytes.end(), buffer, buffer + got);
+        fclose(f);
+    }
+    if (FILE* f = fopen(FILE_NAME.c_str(), "wb")) {
+        fwrite(bytes.data(), 1, bytes.size() - 5, f);
+        fclose(f);
+    }
+
+    // The loader reports the damage itself; keep that out of the test's own output
+    std::ostringstream said;
+    std::streambuf* console = std::cout.rdbuf(said.rdbuf());
+    bool loaded = loadCheckpoint(FILE_NAME, read);
+    std::cout.rdbuf(console);
+    check(!loaded && said.str().find("damaged") != std::string::npos, "truncated checkpoint was not refused as damaged");
+}
+
+
+int main()
+{
+    for (char type : { 's', 't', 'h', 'm' }) {
+        resumeMatches(type, 120, 0, LIFE);
+        resumeMatches(type, 120, 3ll << 29, LIFE);
+    }
+    resumeMatches('s', 600, 0, LIFE);
+
+    lifeRule highLife;
+    check(parseRule("B36/S23", highLife), "B36/S23 does not parse");
+    resumeMatches('t', 120, 0, highLife);
+
+    replaceAndTruncate();
+    std::remove(FILE_NAME.c_str());
+
+    if (failures)
+        std::cout << failures << " checks failed\n";
+    else
+        std::cout << "checkpoint: all checks passed\n";
+    return failures ? 1 : 0;
+}
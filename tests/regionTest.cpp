@@ -0,0 +1,147 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   Checks the region queries of every engine against a scan over the cells the engine stores. Soups
+   are run for a few generations on each engine, some of them placed so that the engine moves its
+   origin, and then random rectangles, points and nearest cell queries are asked in local
+   coordinates. The sparse engine is also run under a Generations rule, where only the live cells
+   count. Build from the repository root with
+
+      g++ -std=c++17 -O2 -pthread -I. tests/regionTest.cpp $(ls *.cpp | grep -v GameofLife2D) -o regionTest
+
+   The program prints one line per failure and exits with 1 if there was any.
+*/
+
+// Headers
+#include <climits>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "benchmark.h"
+#include "lifeEngine.h"
+#include "lifeRule.h"
+#include "regionIndex.h"
+
+
+// Queries asked of each pattern
+const int QUERIES = 200;
+
+static int failures = 0;
+
+
+static std::vector<std::pair<int, int>> sorted(const std::vector<int>& X, const std::vector<int>& Y)
+{
+    std::vector<std::pair<int, int>> cells;
+    for (size_t i = 0; i < X.size(); i++)
+        cells.push_back(std::make_pair(X[i], Y[i]));
+    std::sort(cells.begin(), cells.end());
+    return cells;
+}
+
+
+static void check(bool ok, const std::string& what)
+{
+    if (!ok) {
+        std::cout << "ERROR: " << what << "\n";
+        failures++;
+    }
+}
+
+
+// Asks the engine random queries around its cells and compares every answer with a scan
+static void compareWithScan(const std::string& name, const lifeEngine& engine, std::mt19937& rng)
+{
+    std::vector<int> X, Y;
+    engine.store(X, Y);
+    if (X.empty())
+        return;
+    std::vector<std::pair<int, int>> all = sorted(X, Y);
+
+    for (int q = 0; q < QUERIES; q++) {
+        // Rectangles from a single cell up to wider than the pattern, around a live cell and cut off
+        // at the edge of the int range
+        const std::pair<int, int>& at = all[rng() % all.size()];
+        int64_t w = rng() % 300, h = rng() % 300;
+        int64_t minX = at.first - (int64_t)(rng() % (w + 1)), minY = at.second - (int64_t)(rng() % (h + 1));
+        cellRect region = { (int)std::max<int64_t>(minX, INT32_MIN), (int)std::max<int64_t>(minY, INT32_MIN),
+            (int)std::min<int64_t>(minX + w, INT32_MAX), (int)std::min<int64_t>(minY + h, INT32_MAX) };
+
+        std::vector<std::pair<int, int>> want;
+        for (const std::pair<int, int>& c : all)
+            if (region.contains(c.first, c.second))
+                want.push_back(c);
+
+        std::vector<int> inX, inY;
+        engine.cellsIn(region, inX, inY);
+        std::string where = name + ": region (" + std::to_string(region.minX) + ", " + std::to_string(region.minY) + ") to ("
+            + std::to_string(region.maxX) + ", " + std::to_string(region.maxY) + ")";
+        check(engine.countIn(region) == want.size(), where + " count differs");
+        check(sorted(inX, inY) == want, where + " cells differ");
+
+        // A point next to a live cell, alive or not, wrapping like the plane
+        int x = (int)(uint32_t)(at.first + (int64_t)(rng() % 3) - 1), y = (int)(uint32_t)(at.second + (int64_t)(rng() % 3) - 1);
+        bool live = std::binary_search(all.begin(), all.end(), std::make_pair(x, y));
+        check(engine.alive(x, y) == live, name + ": alive(" + std::to_string(x) + ", " + std::to_string(y) + ") differs");
+
+        // Ties may be broken either way, so only the distance is compared. Distances do not wrap, so
+        // the point stays inside the int range.
+        x = (int)std::min<int64_t>(std::max<int64_t>(at.first + (int64_t)(rng() % 801) - 400, INT32_MIN), INT32_MAX);
+        y = (int)std::min<int64_t>(std::max<int64_t>(at.second + (int64_t)(rng() % 801) - 400, INT32_MIN), INT32_MAX);
+        uint64_t best = UINT64_MAX;
+        for (const std::pair<int, int>& c : all)
+            best = std::min(best, regionIndex::cellDistance(c.first, c.second, x, y));
+        int nearX, nearY;
+        bool found = engine.nearest(x, y, nearX, nearY);
+        check(found && regionIndex::cellDistance(nearX, nearY, x, y) == best && std::binary_search(all.begin(), all.end(), std::make_pair(nearX, nearY)),
+            name + ": nearest(" + std::to_string(x) + ", " + std::to_string(y) + ") differs");
+    }
+}
+
+
+int main()
+{
+    std::mt19937 rng(11);
+
+    // A soup near the origin, one far enough out that the engine moves its origin to it, and one
+    // across the seam at +-2^31
+    for (int64_t offset : { 0ll, 3ll << 29, 1ll << 31 }) {
+        std::vector<int> X, Y;
+        randomSoup(120, 120, 0.35, 5, X, Y);
+        for (size_t i = 0; i < X.size(); i++)
+            X[i] = (int)(uint32_t)(X[i] + offset);
+
+        for (char type : { 's', 't', 'h', 'm' }) {
+            std::unique_ptr<lifeEngine> engine = makeEngine(type);
+            engine->load(X, Y);
+            std::string name = std::string(engine->name()) + " at " + std::to_string(offset);
+            compareWithScan(name + ", loaded", *engine, rng);
+            for (int g = 0; g < 30; g++)
+                engine->step();
+            compareWithScan(name + ", after 30 generations", *engine, rng);
+        }
+    }
+
+    // Under a Generations rule the dying cells are kept but are not alive
+    lifeRule brain;
+    check(parseRule("B2/S/C3", brain) && brain.generations(), "B2/S/C3 does not parse as a Generations rule");
+    std::vector<int> X, Y;
+    randomSoup(80, 80, 0.3, 9, X, Y);
+    std::unique_ptr<lifeEngine> engine = makeEngine('s');
+    engine->setRule(brain);
+    engine->load(X, Y);
+    for (int g = 0; g < 10; g++)
+        engine->step();
+    compareWithScan("sparse under " + brain.name(), *engine, rng);
+
+    if (failures)
+        std::cout << failures << " checks failed\n";
+    else
+        std::cout << "region: all checks passed\n";
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,138 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   Checks the unbounded plane at the edge of the int range, where coordinates wrap modulo 2^32 and
+   the cells at 2^31 - 1 and -2^31 are neighbours. A glider is sent across the corner where both
+   axes wrap, and blinkers are set across each seam. Every stepper must give the same cells as the
+   pattern run near the origin and then moved onto the seam: calcState serial and band-parallel, the
+   sparse and tile engines on one thread and on four, HashLife and the sorted engine. Engines may move
+   their origin, so cells are compared at their position in the plane, modulo 2^32. Build from the
+   repository root with
+
+      g++ -std=c++17 -O2 -pthread -I. tests/wrapTest.cpp $(ls *.cpp | grep -v GameofLife2D) -o wrapTest
+
+   The program prints one line per failure and exits with 1 if there was any.
+*/
+
+// Headers
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "calcState.h"
+#include "lifeEngine.h"
+#include "patterns.h"
+#include "threadPool.h"
+
+
+// Generations each pattern is run for, long enough for the glider to get well past the corner
+const int GENERATIONS = 40;
+
+static int failures = 0;
+
+
+// Moves the cells by (dx, dy) modulo 2^32
+static void moveCells(std::vector<int>& X, std::vector<int>& Y, int64_t dx, int64_t dy)
+{
+    for (size_t i = 0; i < X.size(); i++) {
+        X[i] = (int)(uint32_t)(X[i] + dx);
+        Y[i] = (int)(uint32_t)(Y[i] + dy);
+    }
+}
+
+
+static std::vector<std::pair<int, int>> sorted(const std::vector<int>& X, const std::vector<int>& Y)
+{
+    std::vector<std::pair<int, int>> cells;
+    for (size_t i = 0; i < X.size(); i++)
+        cells.push_back(std::make_pair(X[i], Y[i]));
+    std::sort(cells.begin(), cells.end());
+    return cells;
+}
+
+
+static void check(bool ok, const std::string& what)
+{
+    if (!ok) {
+        std::cout << "ERROR: " << what << "\n";
+        failures++;
+    }
+}
+
+
+// Runs the named pattern placed at the origin, then at (dx, dy), on every stepper, and compares
+// each generation with the first run moved to (dx, dy)
+static void acrossSeam(const std::string& name, int64_t dx, int64_t dy)
+{
+    std::vector<int> refX, refY;
+    namedPattern(name, 0, 0, refX, refY);
+    std::vector<int> startX = refX, startY = refY;
+    moveCells(startX, startY, dx, dy);
+
+    std::vector<int> serialX = startX, serialY = startY, bandX = startX, bandY = startY;
+    threadPool pool(4);
+
+    struct engineRun
+    {
+        std::string name;
+        std::unique_ptr<lifeEngine> engine;
+    };
+    std::vector<engineRun> engines;
+    for (char type : { 's', 't', 'h', 'm' }) {
+        for (int threads : { 1, 4 }) {
+            if (threads > 1 && (type == 'h' || type == 'm'))
+                continue;
+            std::unique_ptr<lifeEngine> engine = makeEngine(type);
+            engine->setThreads(threads);
+            engine->load(startX, startY);
+            std::string label = std::string(engine->name()) + " on " + std::to_string(threads) + " threads";
+            engines.push_back(engineRun{ label, std::move(engine) });
+        }
+    }
+
+    for (int g = 1; g <= GENERATIONS; g++) {
+        calcState(refX, refY);
+        std::vector<int> wantX = refX, wantY = refY;
+        moveCells(wantX, wantY, dx, dy);
+        std::vector<std::pair<int, int>> want = sorted(wantX, wantY);
+        std::string at = name + " at generation " + std::to_string(g) + ": ";
+
+        calcState(serialX, serialY);
+        check(sorted(serialX, serialY) == want, at + "serial calcState differs");
+        calcState(bandX, bandY, pool);
+        check(sorted(bandX, bandY) == want, at + "band-parallel calcState differs");
+
+        for (engineRun& run : engines) {
+            run.engine->step();
+            std::vector<int> X, Y;
+            int64_t originX, originY;
+            run.engine->store(X, Y);
+            run.engine->origin(originX, originY);
+            moveCells(X, Y, originX, originY);
+            check(sorted(X, Y) == want, at + run.name + " differs");
+        }
+    }
+}
+
+
+int main()
+{
+    const int64_t SEAM = 1ll << 31;
+
+    // The glider starts on the corner and heads on across it; the blinkers straddle the column seam,
+    // the row seam once they turn upright, and the corner
+    acrossSeam("glider", SEAM - 2, SEAM - 2);
+    acrossSeam("blinker", SEAM - 1, 0);
+    acrossSeam("blinker", 0, SEAM - 1);
+    acrossSeam("blinker", SEAM - 1, SEAM - 1);
+
+    if (failures)
+        std::cout << failures << " checks failed\n";
+    else
+        std::cout << "wrap: all checks passed\n";
+    return failures ? 1 : 0;
+}
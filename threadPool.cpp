@@ -0,0 +1,151 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   Work-stealing thread pool used by the parallel stepping modes. Each worker owns a queue of task
+   indices. A batch is split into one contiguous block per worker, so neighbouring bands or tiles
+   usually stay on the same core, and workers that finish early steal single tasks from the far end
+   of the busiest-looking queue.
+*/
+
+// Headers
+#include <algorithm>
+#include "threadPool.h"
+
+
+threadPool::threadPool(int threads) : call(nullptr), job(nullptr), pending(0), batch(0), stopping(false)
+{
+    start(threads);
+}
+
+
+threadPool::~threadPool()
+{
+    stop();
+}
+
+
+void threadPool::resize(int threads)
+{
+    if (threads < 1)
+        threads = 1;
+    if (threads == size())
+        return;
+
+    stop();
+    start(threads);
+}
+
+
+void threadPool::start(int threads)
+{
+    if (threads < 1)
+        threads = 1;
+
+    stopping = false;
+    queues.clear();
+    for (int i = 0; i < threads; i++) {
+        queues.emplace_back(new taskQueue());
+        queues.back()->next = queues.back()->last = 0;
+    }
+    for (int i = 1; i < threads; i++)
+        workers.emplace_back(&threadPool::workerLoop, this, i);
+}
+
+
+void threadPool::stop()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (size_t i = 0; i < workers.size(); i++)
+        workers[i].join();
+    workers.clear();
+}
+
+
+void threadPool::dispatch(size_t count, void (*call)(const void*, size_t), const void* task)
+{
+    this->call = call;
+    job = task;
+    pending = count;
+
+    // Deal out contiguous blocks, which each owner takes in order
+    int n = size();
+    for (int w = 0; w < n; w++) {
+        std::lock_guard<std::mutex> guard(queues[w]->lock);
+        queues[w]->next = count * w / n;
+        queues[w]->last = count * (w + 1) / n;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        batch++;
+    }
+    wake.notify_all();
+
+    drain(0);
+
+    std::unique_lock<std::mutex> guard(lock);
+    done.wait(guard, [this] { return pending == 0; });
+    call = nullptr;
+    job = nullptr;
+}
+
+
+bool threadPool::take(int id, size_t& item)
+{
+    {
+        std::lock_guard<std::mutex> guard(queues[id]->lock);
+        if (queues[id]->next < queues[id]->last) {
+            item = queues[id]->next++;
+            return true;
+        }
+    }
+
+    // Steal from the other end of the other queues, starting with the next worker along
+    int n = size();
+    for (int k = 1; k < n; k++) {
+        taskQueue& victim = *queues[(id + k) % n];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (victim.next < victim.last) {
+            item = --victim.last;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+void threadPool::drain(int id)
+{
+    size_t item;
+    while (take(id, item)) {
+        call(job, item);
+        if (--pending == 0) {
+            std::lock_guard<std::mutex> guard(lock);
+            done.notify_all();
+        }
+    }
+}
+
+
+void threadPool::workerLoop(int id)
+{
+    unsigned long long seen = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            wake.wait(guard, [&] { return stopping || batch != seen; });
+            if (stopping)
+                return;
+            seen = batch;
+        }
+        drain(id);
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads with one task queue each. run() deals a batch of task indices out to
+// the queues in contiguous blocks, every worker drains its own block from the start and, once it is
+// empty, steals from the far end of the others, so uneven tasks still keep every thread busy. The
+// calling thread takes part as worker 0. A batch allocates nothing: the task is referred to, not
+// copied, and a queue is just the part of its block not yet taken.
+class threadPool
+{
+public:
+    explicit threadPool(int threads = 1);
+    ~threadPool();
+
+    void resize(int threads);
+    int size() const { return (int)queues.size(); }
+
+    // Calls task(i) for every i in [0, count) and returns once all of them have finished
+    template <class F> void run(size_t count, const F& task)
+    {
+        if (size() == 1 || count <= 1) {
+            for (size_t i = 0; i < count; i++)
+                task(i);
+            return;
+        }
+        dispatch(count, [](const void* f, size_t i) { (*static_cast<const F*>(f))(i); }, &task);
+    }
+
+private:
+    // Tasks [next, last) still to be taken
+    struct taskQueue
+    {
+        std::mutex lock;
+        size_t next, last;
+    };
+
+    void dispatch(size_t count, void (*call)(const void*, size_t), const void* task);
+
+    void start(int threads);
+    void stop();
+    void workerLoop(int id);
+    void drain(int id);
+    bool take(int id, size_t& item);
+
+    std::vector<std::unique_ptr<taskQueue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex lock;
+    std::condition_variable wake, done;
+    void (*call)(const void*, size_t);
+    const void* job;
+    std::atomic<size_t> pending;
+    unsigned long long batch;
+    bool stopping;
+};
+
+#endif
@@ -0,0 +1,701 @@
+// Author: Jonathan M. Blisko
+// Updates: Started Oct. 18, 2026
+
+/*
+Description:
+   Bit-packed tile engine. The universe is cut into 64x64 tiles and each tile row is one 64-bit word,
+   so a single bitwise instruction advances 64 cells. For every row the eight neighbour words are
+   formed by shifting the row above, the row itself and the row below one bit east and west (carrying
+   the edge bit in from the neighbouring tile), and then summed with a tree of full adders into a
+   four bit count per cell. The Life rule is then a handful of boolean operations on those bits.
+
+   Other two-state rules OR together one term per neighbour count that the rule mentions. The kernel
+   is instantiated with the rule mask as a template constant for the common rules, so the unused
+   terms are dropped at compile time; any other rule uses the instantiation that reads the mask at
+   run time and tests it once per word rather than once per cell. Rules with B0 are never accepted,
+   so a tile with no live neighbours stays empty and the candidate set below is still complete.
+
+   Only tiles that hold live cells are stored. Before each step the candidate set is every stored tile
+   plus any neighbour that one of its edge cells can reach. Tile coordinates wrap at the edge of the
+   int range, so a pattern leaving x = 2^31 - 1 reappears at x = -2^31 as it does in calcState.
+
+   The adder tree and the rule terms live in bitKernel.h, shared with the bounded engine. Build with
+   AVX2 enabled (-mavx2 or /arch:AVX2) to process four rows per instruction, otherwise SSE2 is used
+   on x86-64 and plain 64-bit words elsewhere.
+*/
+
+// Headers
+#include <cstdint>
+#include <cstring>
+#include <bitset>
+#include <algorithm>
+#include <vector>
+#include <atomic>
+#include "tileEngine.h"
+#include "cellHash.h"
+#include "cellPairs.h"
+#include "bitKernel.h"
+#include "metrics.h"
+
+
+// Advances the 64 rows of a tile. L, C and R each hold 66 rows (index -1 to 64 are valid) of the cells
+// shifted so that bit i holds the west neighbour, the cell itself and the east neighbour respectively.
+template <class Op, uint32_t MASK>
+static void stepRows(const uint64_t* L, const uint64_t* C, const uint64_t* R, uint64_t* out, uint32_t mask)
+{
+    for (int r = 0; r < TILESIZE; r += Op::lanes) {
+        Op::store(out + r, nextCells<Op, MASK>(Op::load(L + r - 1), Op::load(C + r - 1), Op::load(R + r - 1),
+            Op::load(L + r), Op::load(R + r), Op::load(L + r + 1), Op::load(C + r + 1), Op::load(R + r + 1),
+            Op::load(C + r), mask));
+    }
+}
+
+
+// Tile coordinates span [-2^25, 2^25), so that cell coordinates span the whole int range
+const int TILE_RANGE = 1 << 25;
+
+// Tiles computed per task when stepping in parallel
+const size_t TILE_BATCH = 16;
+
+// Tile flags, for the generation in one of the tile's two row buffers
+const uint8_t TILE_STILL = 1;      // Same as the generation before
+const uint8_t TILE_PERIOD2 = 2;    // Same as the generation two before
+const uint8_t TILE_EMPTY = 4;      // No live cells
+
+// Edges of a tile holding live cells, which can give births in the tile on that side
+const uint8_t TILE_EDGE_W = 1, TILE_EDGE_E = 2, TILE_EDGE_S = 4, TILE_EDGE_N = 8;
+const uint8_t TILE_EDGE_SW = 16, TILE_EDGE_SE = 32, TILE_EDGE_NW = 64, TILE_EDGE_NE = 128;
+
+// Generations between removals of tiles that have stayed empty
+const uint64_t SWEEP_INTERVAL = 64;
+
+
+tileEngine::tileEngine() : cur(0), steps(0), computed(0), skippedStill(0), skippedPeriod2(0), indexed(false)
+{
+    setRule(LIFE);
+}
+
+
+bool tileEngine::setRule(const lifeRule& rule)
+{
+    if (rule.generations())
+        return false;
+
+    ruleMask = rule.mask();
+    switch (ruleMask) {
+    case LIFE_MASK:
+        kernel = stepRows<simdOps, LIFE_MASK>;
+        break;
+    case HIGHLIFE_MASK:
+        kernel = stepRows<simdOps, HIGHLIFE_MASK>;
+        break;
+    case DAYNIGHT_MASK:
+        kernel = stepRows<simdOps, DAYNIGHT_MASK>;
+        break;
+    case SEEDS_MASK:
+        kernel = stepRows<simdOps, SEEDS_MASK>;
+        break;
+    default:
+        kernel = stepRows<simdOps, RUNTIME_MASK>;
+        break;
+    }
+
+    // Nothing known about the tiles under the new rule, so recompute them all next step
+    for (size_t i = 0; i < tiles.size(); i++)
+        tiles[i].flags[cur] &= TILE_EMPTY;
+    return true;
+}
+
+
+tileDirectory::tileDirectory() : mask(0), count(0)
+{
+    reset(0);
+}
+
+
+void tileDirectory::reset(size_t expected)
+{
+    size_t cap = 16;
+    while (cap < 2 * expected)
+        cap <<= 1;
+
+    if (cap > keys.size())
+        keys.resize(cap);
+    vals.assign(keys.size(), -1);
+    mask = keys.size() - 1;
+    count = 0;
+}
+
+
+// Doubles the table, keeping the load under one half as tiles are added between rebuilds
+void tileDirectory::grow()
+{
+    METRIC_ADD(COUNTER_ALLOCATIONS, 2);
+    std::vector<uint64_t> oldKeys(keys.size() * 2);
+    std::vector<int> oldVals(vals.size() * 2, -1);
+    oldKeys.swap(keys);
+    oldVals.swap(vals);
+    mask = keys.size() - 1;
+
+    for (size_t i = 0; i < oldKeys.size(); i++) {
+        if (oldVals[i] >= 0) {
+            size_t j = slotFor(oldKeys[i]);
+            keys[j] = oldKeys[i];
+            vals[j] = oldVals[i];
+        }
+    }
+}
+
+
+size_t tileDirectory::slotFor(uint64_t key) const
+{
+    size_t i = (size_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+    while (vals[i] >= 0 && keys[i] != key)
+        i = (i + 1) & mask;
+    return i;
+}
+
+
+int tileDirectory::find(int tx, int ty) const
+{
+    return findKey(packCell(tx, ty));
+}
+
+
+int tileDirectory::insert(int tx, int ty, int index)
+{
+    return insertKey(packCell(tx, ty), index);
+}
+
+
+int tileDirectory::findKey(uint64_t key) const
+{
+    return vals[slotFor(key)];
+}
+
+
+int tileDirectory::insertKey(uint64_t key, int index)
+{
+    size_t i = slotFor(key);
+
+    if (vals[i] < 0) {
+        if (2 * (count + 1) > keys.size()) {
+            grow();
+            i = slotFor(key);
+        }
+        keys[i] = key;
+        vals[i] = index;
+        count++;
+    }
+    return vals[i];
+}
+
+
+// Tile coordinate modulo 2^26, which makes the plane a 2^32 x 2^32 torus exactly like the sparse engine
+static inline int wrapTile(int t)
+{
+    return (int)(((uint32_t)t + TILE_RANGE) & (2 * TILE_RANGE - 1)) - TILE_RANGE;
+}
+
+
+// Adds an empty tile and links it with its neighbours. Returns its index.
+int tileEngine::addTile(int tx, int ty)
+{
+    int index = (int)tiles.push();
+
+    lifeTile& t = tiles[index];
+    t.tx = tx;
+    t.ty = ty;
+    t.flags[0] = t.flags[1] = TILE_STILL | TILE_PERIOD2 | TILE_EMPTY;
+    dir.insert(tx, ty, index);
+
+    for (int k = 0; k < 9; k++) {
+        int j = k == 4 ? index : dir.find(wrapTile(tx + k % 3 - 1), wrapTile(ty + k / 3 - 1));
+        t.nb[k] = j;
+        if (j >= 0)
+            tiles[j].nb[8 - k] = index;
+    }
+    return index;
+}
+
+
+// Makes sure the tiles next to the given edges of tile i exist
+void tileEngine::expand(size_t i, uint8_t edges)
+{
+    static const int side[8] = { TILE_EDGE_W, TILE_EDGE_E, TILE_EDGE_S, TILE_EDGE_N, TILE_EDGE_SW, TILE_EDGE_SE, TILE_EDGE_NW, TILE_EDGE_NE };
+    static const int slot[8] = { 3, 5, 1, 7, 0, 2, 6, 8 };
+
+    for (int d = 0; d < 8; d++) {
+        if ((edges & side[d]) && tiles[i].nb[slot[d]] < 0)
+            addTile(wrapTile(tiles[i].tx + slot[d] % 3 - 1), wrapTile(tiles[i].ty + slot[d] / 3 - 1));
+    }
+}
+
+
+// Live cells on each edge of a block of rows
+static uint8_t edgesOf(const uint64_t* rows)
+{
+    const uint64_t WEST = 1ull, EAST = 1ull << 63;
+    uint64_t any = 0;
+    for (int r = 0; r < TILESIZE; r++)
+        any |= rows[r];
+
+    uint64_t south = rows[0], north = rows[TILESIZE - 1];
+    return (any & WEST ? TILE_EDGE_W : 0) | (any & EAST ? TILE_EDGE_E : 0) | (south ? TILE_EDGE_S : 0) | (north ? TILE_EDGE_N : 0)
+        | (south & WEST ? TILE_EDGE_SW : 0) | (south & EAST ? TILE_EDGE_SE : 0) | (north & WEST ? TILE_EDGE_NW : 0) | (north & EAST ? TILE_EDGE_NE : 0);
+}
+
+
+void tileEngine::load(const std::vector<int>& X, const std::vector<int>& Y)
+{
+    cellPairs cells(X, Y);
+
+    tiles.clear();
+    dir.reset(cells.size());
+    cur = 0;
+    steps = 0;
+    indexed = false;
+
+    for (cellCoord c : cells) {
+        int tx = c.x >> 6, ty = c.y >> 6;
+        int index = dir.find(tx, ty);
+        if (index < 0)
+            index = addTile(tx, ty);
+        tiles[index].rows[cur][c.y & 63] |= 1ull << (c.x & 63);
+    }
+
+    // Nothing is known about the history of the loaded tiles
+    size_t loaded = tiles.size();
+    for (size_t i = 0; i < loaded; i++) {
+        tiles[i].flags[cur] = 0;
+        tiles[i].edges[cur] = edgesOf(tiles[i].rows[cur]);
+    }
+    for (size_t i = 0; i < loaded; i++)
+        expand(i, tiles[i].edges[cur]);
+}
+
+
+void tileEngine::step()
+{
+    int next = cur ^ 1;
+    size_t count = tiles.size();
+    size_t batches = (count + TILE_BATCH - 1) / TILE_BATCH;
+    std::atomic<size_t> active(0), still(0), period2(0);
+
+    // Every tile only reads the current generation of its neighbourhood and writes its own other
+    // buffer, so the batches are independent
+    pool.run(batches, [&](size_t b) {
+        METRIC_PHASE(PHASE_COUNT);
+        size_t end = std::min(count, (b + 1) * TILE_BATCH);
+        size_t done[3] = { 0, 0, 0 };
+
+        for (size_t i = b * TILE_BATCH; i < end; i++)
+            done[computeTile(tiles[i])]++;
+
+        active += done[0];
+        still += done[1];
+        period2 += done[2];
+    });
+
+    computed = active;
+    skippedStill = still;
+    skippedPeriod2 = period2;
+    METRIC_ADD(COUNTER_ACTIVE_TILES, computed);
+
+    METRIC_PHASE(PHASE_COMMIT);
+
+    cur = next;
+    if (++steps % SWEEP_INTERVAL == 0)
+        sweep();
+
+    // A tile that changed can affect the tiles next to the edges that held live cells before or
+    // after, whether by a birth or by a neighbour disappearing. An unchanged tile already has them,
+    // or they were swept while empty and unchanged, and stay empty until that tile changes.
+    count = tiles.size();
+    for (size_t i = 0; i < count; i++) {
+        if (!(tiles[i].flags[cur] & TILE_STILL)) {
+            expand(i, tiles[i].edges[cur] | tiles[i].edges[cur ^ 1]);
+            if (indexed)
+                markStale(i);
+        }
+    }
+
+    recenterAfter(1);
+}
+
+
+// Adds the cells born and died between two generations of a tile to the metrics
+static void countChanges(const uint64_t* before, const uint64_t* after)
+{
+#ifndef LIFE_NO_METRICS
+    uint64_t births = 0, deaths = 0;
+    for (int r = 0; r < TILESIZE; r++) {
+        births += std::bitset<64>(after[r] & ~before[r]).count();
+        deaths += std::bitset<64>(before[r] & ~after[r]).count();
+    }
+    METRIC_ADD(COUNTER_BIRTHS, births);
+    METRIC_ADD(COUNTER_DEATHS, deaths);
+#else
+    (void)before;
+    (void)after;
+#endif
+}
+
+
+// Advances one tile into its other buffer. Returns 0 if it was computed, 1 if skipped because its
+// neighbourhood was still, 2 if skipped because its neighbourhood had period 2.
+int tileEngine::computeTile(lifeTile& t)
+{
+    int next = cur ^ 1;
+    uint8_t all = TILE_STILL | TILE_PERIOD2;
+    for (int k = 0; k < 9; k++)
+        if (t.nb[k] >= 0)
+            all &= tiles[t.nb[k]].flags[cur];
+
+    // Still neighbourhood: the next generation is this one, which the other buffer already holds
+    // since the tile itself was still
+    if (all & TILE_STILL) {
+        t.flags[next] = (t.flags[next] & TILE_EMPTY) | TILE_STILL | TILE_PERIOD2;
+        return 1;
+    }
+
+    // Period 2 neighbourhood: the next generation is the one before, already in the other buffer
+    if (all & TILE_PERIOD2) {
+        t.flags[next] = (t.flags[next] & TILE_EMPTY) | TILE_PERIOD2 | (t.flags[cur] & TILE_STILL);
+        if (!(t.flags[cur] & TILE_STILL) && metricsStarted())
+            countChanges(t.rows[cur], t.rows[next]);
+        return 2;
+    }
+
+    // 66 rows per array so that rows -1 and 64 come from the tiles below and above
+    static const uint64_t none[TILESIZE] = {};
+    uint64_t L[TILESIZE + 2], C[TILESIZE + 2], R[TILESIZE + 2];
+    uint64_t out[TILESIZE];
+
+    const uint64_t* column[3][3];
+    for (int k = 0; k < 9; k++)
+        column[k % 3][k / 3] = t.nb[k] >= 0 ? tiles[t.nb[k]].rows[cur] : none;
+
+    for (int r = -1; r <= TILESIZE; r++) {
+        int dy = r < 0 ? 0 : (r >= TILESIZE ? 2 : 1);
+        int row = r & 63;
+        uint64_t w = column[0][dy][row];
+        uint64_t c = column[1][dy][row];
+        uint64_t e = column[2][dy][row];
+
+        L[r + 1] = (c << 1) | (w >> 63);
+        C[r + 1] = c;
+        R[r + 1] = (c >> 1) | (e << 63);
+    }
+
+    kernel(L + 1, C + 1, R + 1, out, ruleMask);
+
+    bool same = true, repeat = true;
+    uint64_t any = 0;
+    for (int r = 0; r < TILESIZE; r++) {
+        same &= out[r] == t.rows[cur][r];
+        repeat &= out[r] == t.rows[next][r];
+        any |= out[r];
+    }
+
+    // After a load the other buffer holds no real generation, so the first step cannot tell period 2
+    repeat &= steps > 0;
+
+    if (!same && metricsStarted())
+        countChanges(t.rows[cur], out);
+    memcpy(t.rows[next], out, sizeof(out));
+    t.flags[next] = (same ? TILE_STILL : 0) | (repeat ? TILE_PERIOD2 : 0) | (any ? 0 : TILE_EMPTY);
+    t.edges[next] = edgesOf(out);
+    return 0;
+}
+
+
+// Removes the tiles that have been empty for the last three generations. Fewer would not do: an
+// absent tile counts as still and period 2, which must be true of the tile it replaces. A removed
+// tile the index has not counted since it changed is set to empty there, and the stale marks move
+// with the tiles that stay.
+void tileEngine::sweep()
+{
+    const uint8_t GONE = TILE_STILL | TILE_PERIOD2 | TILE_EMPTY;
+
+    if (indexed)
+        stale.resize(tiles.size(), 0);
+
+    size_t kept = 0;
+    for (size_t i = 0; i < tiles.size(); i++) {
+        if ((tiles[i].flags[cur] & GONE) == GONE) {
+            if (indexed && stale[i])
+                index.set(tiles[i].tx, tiles[i].ty, 0);
+            continue;
+        }
+        if (indexed)
+            stale[kept] = stale[i];
+        tiles[kept++] = tiles[i];
+    }
+    if (kept == tiles.size())
+        return;
+
+    tiles.resize(kept);
+    if (indexed) {
+        stale.resize(kept);
+        staleTiles.clear();
+        for (size_t i = 0; i < kept; i++)
+            if (stale[i])
+                staleTiles.push_back((int)i);
+    }
+    rebuildDirectory();
+    for (size_t i = 0; i < tiles.size(); i++)
+        for (int k = 0; k < 9; k++)
+            tiles[i].nb[k] = dir.find(wrapTile(tiles[i].tx + k % 3 - 1), wrapTile(tiles[i].ty + k / 3 - 1));
+}
+
+
+void tileEngine::rebuildDirectory()
+{
+    dir.reset(tiles.size());
+    for (size_t i = 0; i < tiles.size(); i++)
+        dir.insert(tiles[i].tx, tiles[i].ty, (int)i);
+}
+
+
+bool tileEngine::localBounds(int64_t& minX, int64_t& minY, int64_t& maxX, int64_t& maxY) const
+{
+    if (tiles.empty())
+        return false;
+
+    // Whole tiles, which is close enough for deciding when to recenter
+    minX = minY = INT64_MAX;
+    maxX = maxY = INT64_MIN;
+    for (size_t i = 0; i < tiles.size(); i++) {
+        minX = std::min<int64_t>(minX, (int64_t)tiles[i].tx * TILESIZE);
+        maxX = std::max<int64_t>(maxX, (int64_t)tiles[i].tx * TILESIZE + TILESIZE - 1);
+        minY = std::min<int64_t>(minY, (int64_t)tiles[i].ty * TILESIZE);
+        maxY = std::max<int64_t>(maxY, (int64_t)tiles[i].ty * TILESIZE + TILESIZE - 1);
+    }
+    return true;
+}
+
+
+void tileEngine::shift(int64_t dx, int64_t dy)
+{
+    for (size_t i = 0; i < tiles.size(); i++) {
+        tiles[i].tx = wrapTile((int)(tiles[i].tx - dx / TILESIZE));
+        tiles[i].ty = wrapTile((int)(tiles[i].ty - dy / TILESIZE));
+    }
+
+    // The neighbourhoods are unchanged, only their keys move, and the index is built again by the
+    // next query
+    rebuildDirectory();
+    indexed = false;
+}
+
+
+void tileEngine::store(std::vector<int>& X, std::vector<int>& Y) const
+{
+    X.clear();
+    Y.clear();
+
+    for (size_t i = 0; i < tiles.size(); i++) {
+        if (tiles[i].flags[cur] & TILE_EMPTY)
+            continue;
+        for (int r = 0; r < TILESIZE; r++) {
+            uint64_t bits = tiles[i].rows[cur][r];
+            for (int b = 0; bits; b++, bits >>= 1) {
+                if (bits & 1) {
+                    X.push_back(tiles[i].tx * TILESIZE + b);
+                    Y.push_back(tiles[i].ty * TILESIZE + r);
+                }
+            }
+        }
+    }
+}
+
+
+// After a step the other buffer of every tile holds the generation before: computed and skipped tiles
+// alike only ever write their next buffer, and tiles added since are empty in both. Still tiles have
+// no changes and are passed over.
+bool tileEngine::changes(std::vector<int>& bornX, std::vector<int>& bornY, std::vector<int>& diedX, std::vector<int>& diedY) const
+{
+    bornX.clear();
+    bornY.clear();
+    diedX.clear();
+    diedY.clear();
+
+    for (size_t i = 0; i < tiles.size(); i++) {
+        const lifeTile& t = tiles[i];
+        if (t.flags[cur] & TILE_STILL)
+            continue;
+        for (int r = 0; r < TILESIZE; r++) {
+            uint64_t now = t.rows[cur][r], before = t.rows[cur ^ 1][r];
+            for (uint64_t bits = now & ~before; bits; bits &= bits - 1) {
+                bornX.push_back(t.tx * TILESIZE + (int)std::bitset<64>((bits & (0 - bits)) - 1).count());
+                bornY.push_back(t.ty * TILESIZE + r);
+            }
+            for (uint64_t bits = before & ~now; bits; bits &= bits - 1) {
+                diedX.push_back(t.tx * TILESIZE + (int)std::bitset<64>((bits & (0 - bits)) - 1).count());
+                diedY.push_back(t.ty * TILESIZE + r);
+            }
+        }
+    }
+    return true;
+}
+
+
+size_t tileEngine::population() const
+{
+    size_t pop = 0;
+    for (size_t i = 0; i < tiles.size(); i++)
+        if (!(tiles[i].flags[cur] & TILE_EMPTY))
+            for (int r = 0; r < TILESIZE; r++)
+                pop += std::bitset<64>(tiles[i].rows[cur][r]).count();
+    return pop;
+}
+
+
+// Marks tile i as changed since the index counted it
+void tileEngine::markStale(size_t i)
+{
+    if (i >= stale.size())
+        stale.resize(tiles.size(), 0);
+    if (!stale[i]) {
+        stale[i] = 1;
+        staleTiles.push_back((int)i);
+    }
+}
+
+
+static uint64_t tilePopulation(const lifeTile& t, int p)
+{
+    uint64_t pop = 0;
+    if (!(t.flags[p] & TILE_EMPTY))
+        for (int r = 0; r < TILESIZE; r++)
+            pop += std::bitset<64>(t.rows[p][r]).count();
+    return pop;
+}
+
+
+// Builds the index from every tile, or recounts the tiles changed since the last query. Zero nodes
+// left by tiles that emptied are only dropped by a rebuild, once they outnumber the live ones.
+void tileEngine::refreshIndex() const
+{
+    counted.clear();
+    if (!indexed || index.nodeCount() > 4 * index.liveNodes() + 4096) {
+        index.clear();
+        for (size_t i = 0; i < tiles.size(); i++)
+            counted.push_back(regionIndex::tileCount{ tiles[i].tx, tiles[i].ty, tilePopulation(tiles[i], cur) });
+        stale.assign(tiles.size(), 0);
+        indexed = true;
+    }
+    else {
+        for (size_t k = 0; k < staleTiles.size(); k++) {
+            const lifeTile& t = tiles[staleTiles[k]];
+            counted.push_back(regionIndex::tileCount{ t.tx, t.ty, tilePopulation(t, cur) });
+            stale[staleTiles[k]] = 0;
+        }
+    }
+    staleTiles.clear();
+    index.set(counted);
+}
+
+
+// Rows first to last of tile t, and the mask of its columns, that lie inside the region
+static void clipTile(const lifeTile& t, const cellRect& region, int& first, int& last, uint64_t& columns)
+{
+    int64_t x0 = (int64_t)t.tx * TILESIZE, y0 = (int64_t)t.ty * TILESIZE;
+    int west = (int)std::max<int64_t>(region.minX - x0, 0), east = (int)std::min<int64_t>(region.maxX - x0, TILESIZE - 1);
+    first = (int)std::max<int64_t>(region.minY - y0, 0);
+    last = (int)std::min<int64_t>(region.maxY - y0, TILESIZE - 1);
+    columns = (east == 63 ? ~0ull : (2ull << east) - 1) & (~0ull << west);
+}
+
+
+bool tileEngine::alive(int x, int y) const
+{
+    int i = dir.find(x >> 6, y >> 6);
+    return i >= 0 && (tiles[i].rows[cur][y & 63] >> (x & 63) & 1);
+}
+
+
+size_t tileEngine::countIn(const cellRect& region) const
+{
+    if (region.minX > region.maxX || region.minY > region.maxY)
+        return 0;
+    refreshIndex();
+
+    return (size_t)index.count(region, [&](int tx, int ty) {
+        const lifeTile& t = tiles[dir.find(tx, ty)];
+        int first, last;
+        uint64_t columns;
+        clipTile(t, region, first, last, columns);
+
+        uint64_t pop = 0;
+        for (int r = first; r <= last; r++)
+            pop += std::bitset<64>(t.rows[cur][r] & columns).count();
+        return pop;
+    });
+}
+
+
+void tileEngine::cellsIn(const cellRect& region, std::vector<int>& X, std::vector<int>& Y) const
+{
+    X.clear();
+    Y.clear();
+    if (region.minX > region.maxX || region.minY > region.maxY)
+        return;
+    refreshIndex();
+
+    index.forEach(region, [&](int tx, int ty) {
+        const lifeTile& t = tiles[dir.find(tx, ty)];
+        int first, last;
+        uint64_t columns;
+        clipTile(t, region, first, last, columns);
+
+        for (int r = first; r <= last; r++) {
+            for (uint64_t bits = t.rows[cur][r] & columns; bits; bits &= bits - 1) {
+                X.push_back(tx * TILESIZE + (int)std::bitset<64>((bits & (0 - bits)) - 1).count());
+                Y.push_back(ty * TILESIZE + r);
+            }
+        }
+    });
+}
+
+
+// In every row the nearest cell is the first one at or east of the point's column, or the last one
+// west of it
+bool tileEngine::nearest(int x, int y, int& nearX, int& nearY) const
+{
+    refreshIndex();
+
+    return index.nearest(x, y, [&](int tx, int ty, int px, int py, int& cx, int& cy) {
+        const lifeTile& t = tiles[dir.find(tx, ty)];
+        int column = (int)std::min<int64_t>(std::max<int64_t>((int64_t)px - (int64_t)tx * TILESIZE, 0), TILESIZE - 1);
+        uint64_t east = ~0ull << column, west = ~east;
+
+        uint64_t best = 0;
+        bool found = false;
+        for (int r = 0; r < TILESIZE; r++) {
+            uint64_t bits = t.rows[cur][r];
+            int candidates[2] = { -1, -1 };
+            if (bits & east)
+                candidates[0] = (int)std::bitset<64>(((bits & east) & (0 - (bits & east))) - 1).count();
+            if (bits & west) {
+                uint64_t w = bits & west;
+                w |= w >> 1; w |= w >> 2; w |= w >> 4; w |= w >> 8; w |= w >> 16; w |= w >> 32;
+                candidates[1] = (int)std::bitset<64>(w).count() - 1;
+            }
+            for (int k = 0; k < 2; k++) {
+                if (candidates[k] < 0)
+                    continue;
+                int ax = tx * TILESIZE + candidates[k], ay = ty * TILESIZE + r;
+                uint64_t d = regionIndex::cellDistance(ax, ay, px, py);
+                if (!found || d < best) {
+                    best = d;
+                    cx = ax;
+                    cy = ay;
+                    found = true;
+                }
+            }
+        }
+        return found;
+    }, nearX, nearY);
+}
@@ -0,0 +1,115 @@
+#ifndef TILE_ENGINE_H
+#define TILE_ENGINE_H
+
+#include <cstdint>
+#include <vector>
+#include "lifeEngine.h"
+#include "threadPool.h"
+#include "memoryPool.h"
+
+const int TILESIZE = 64;
+
+// One 64x64 block of the universe. Bit i of rows[p][r] is the cell (64 tx + i, 64 ty + r), so a row
+// is a single machine word and neighbouring rows are adjacent in memory. The tile holds two
+// generations, and the engine's parity selects the current one; the other holds the generation
+// before, which is also what the next generation is when the tile is still or has period 2.
+struct lifeTile
+{
+    int tx, ty;
+    uint64_t rows[2][TILESIZE];
+    int nb[9];            // Tiles of the 3x3 neighbourhood, index 3 (dy + 1) + dx + 1, -1 if absent
+    uint8_t flags[2];     // TILE_STILL, TILE_PERIOD2 and TILE_EMPTY for the generation in rows[p]
+    uint8_t edges[2];     // TILE_EDGE_* bits of the edges of rows[p] that hold live cells
+};
+
+// Open-addressing map from packed tile coordinates to an index into the tile pool. The key forms
+// take any 64-bit key, for blocks addressed by more than two coordinates.
+class tileDirectory
+{
+public:
+    tileDirectory();
+
+    void reset(size_t expected);
+    int find(int tx, int ty) const;              // Returns -1 if the tile is not present
+    int insert(int tx, int ty, int index);       // Returns the existing index if already present
+    int findKey(uint64_t key) const;
+    int insertKey(uint64_t key, int index);
+
+private:
+    size_t slotFor(uint64_t key) const;
+    void grow();
+
+    std::vector<uint64_t> keys;
+    std::vector<int> vals;
+    size_t mask;
+    size_t count;
+};
+
+// Dense engine storing the universe as bit-packed 64x64 tiles. The next generation of a tile is
+// computed with bit-parallel full adders over whole rows, four rows at a time with AVX2, two with
+// SSE2, or one 64-bit word at a time otherwise. Tiles only read the current generation, so with more
+// than one thread they are computed in parallel batches balanced by the work-stealing pool.
+// Any two-state rule is supported, with Life, HighLife, Day & Night and Seeds compiled into their
+// own kernels.
+//
+// Tiles whose whole neighbourhood was still, or had period 2, in the last generation are not
+// recomputed at all, so still lifes and blinkers in the ash cost nothing per step.
+//
+// The region queries use a quadtree of tile populations built by the first query. From then on each
+// step marks the tiles it changed, and the next query recounts only those.
+class tileEngine : public lifeEngine
+{
+public:
+    tileEngine();
+
+    void load(const std::vector<int>& X, const std::vector<int>& Y) override;
+    void step() override;
+    void store(std::vector<int>& X, std::vector<int>& Y) const override;
+    size_t population() const override;
+    bool changes(std::vector<int>& bornX, std::vector<int>& bornY, std::vector<int>& diedX, std::vector<int>& diedY) const override;
+    const char* name() const override { return "tile"; }
+    void setThreads(int threads) override { pool.resize(threads); }
+    bool setRule(const lifeRule& rule) override;    // Two-state rules only
+    bool alive(int x, int y) const override;
+    size_t countIn(const cellRect& region) const override;
+    void cellsIn(const cellRect& region, std::vector<int>& X, std::vector<int>& Y) const override;
+    bool nearest(int x, int y, int& nearX, int& nearY) const override;
+
+    // Tiles stored, and how the last step treated them
+    size_t tileCount() const { return tiles.size(); }
+    size_t activeTiles() const { return computed; }      // Recomputed
+    size_t stillTiles() const { return skippedStill; }   // Skipped, neighbourhood still
+    size_t period2Tiles() const { return skippedPeriod2; } // Skipped, neighbourhood period 2
+
+protected:
+    bool localBounds(int64_t& minX, int64_t& minY, int64_t& maxX, int64_t& maxY) const override;
+    void shift(int64_t dx, int64_t dy) override;
+
+private:
+    int addTile(int tx, int ty);
+    void expand(size_t i, uint8_t edges);
+    void sweep();
+    void rebuildDirectory();
+    int computeTile(lifeTile& t);
+    void markStale(size_t i);
+    void refreshIndex() const;
+
+    slabPool<lifeTile, 6> tiles;    // 64 tiles per slab
+    tileDirectory dir;
+    int cur;                  // Which rows of every tile hold the current generation
+    uint64_t steps;
+    size_t computed, skippedStill, skippedPeriod2;
+    threadPool pool;
+
+    mutable regionIndex index;
+    mutable std::vector<uint8_t> stale;      // Per tile, changed since the index counted it
+    mutable std::vector<int> staleTiles;
+    mutable std::vector<regionIndex::tileCount> counted;
+    mutable bool indexed;                    // False until the first query, and after load or shift
+
+    // Row kernel specialized for the current rule
+    void (*kernel)(const uint64_t* L, const uint64_t* C, const uint64_t* R, uint64_t* out, uint32_t mask);
+    uint32_t ruleMask;
+};
+
+#endif
\ No newline at end of file